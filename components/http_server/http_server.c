@@ -6,9 +6,20 @@
  * - GET  /status     - 获取设备状态
  * - POST /control    - 发送控制指令
  * - POST /sync_time  - 同步时间
+ * - GET  /autotune   - 获取PID自整定状态
+ * - POST /autotune   - 启动/取消自整定, 恢复默认参数
+ * - GET  /diag/adc   - NTC采样统计、按占空比分组的测量噪声及快速关断统计
+ * - POST /diag/adc   - 清除噪声统计
+ * - GET  /profile    - 获取已保存的温度程序及执行状态
+ * - POST /profile    - 保存温度程序, 开始/停止执行
+ * - GET  /schedules  - 获取预约列表
+ * - POST /schedules  - 添加、修改或删除预约
+ * - GET  /energy     - 获取耗电计量
+ * - POST /energy     - 清零耗电计量
  */
 
 #include "http_server.h"
+#include "ntc_sampler.h"
 #include "scheduler.h"
 #include "soft_rtc.h"
 #include "temp_control.h"
@@ -25,6 +36,7 @@ static const char *TAG = "HttpServer";
 static httpd_handle_t s_server = NULL;
 
 #define SCRATCH_BUFSIZE 1024
+#define HTTP_TX_BACKOFF_MS 200 // 新连接后加热器避让时长
 static char s_scratch[SCRATCH_BUFSIZE];
 
 /**
@@ -60,21 +72,36 @@ static int read_post_body(httpd_req_t *req, char *buf, int buf_size) {
  * 返回JSON格式的设备状态：
  * {
  *   "current_temp": 45.5,
+ *   "cup_temp": 41.2,
  *   "target_temp": 55,
  *   "is_heating": 1,
  *   "esp_time": "08:00",
  *   "weekday": 5,
  *   "timer_remaining": 59,
- *   "schedule_time": "08:30"
+ *   "schedule_time": "08:30",
+ *   "fault": "none",
+ *   "mode": "boost",
+ *   "boosting": 1,
+ *   "profile_step": -1,
+ *   "eco": {"enabled": 1, "holding": 1, "setpoint": 52.3, "ambient": 24.5,
+ *           "loss_w_k": 0.2, "baseline_w": 6.1, "saved_wh": 1.35},
+ *   "energy": {"power_w": 4.5, "session_wh": 3.2, "day_wh": 12.8,
+ *              "lifetime_wh": 842.5},
+ *   "eta_s": 240,
+ *   "ready_at": "08:04",
+ *   "model": {"valid": 1, "gain": 180.5, "tau_s": 720, "dead_s": 5,
+ *             "ambient": 25.1},
+ *   "ambient": {"sensor": 1, "calibrated": 1, "temp": 24.6, "chip": 32.1,
+ *               "loss_w_k": 0.21, "ff_pct": 42.5},
+ *   "cmd_latency": {"count": 3, "last_us": 420, "max_us": 910, "avg_us": 600}
  * }
  */
 static esp_err_t status_get_handler(httpd_req_t *req) {
   httpd_resp_set_type(req, "application/json");
 
-  // 获取当前状态
-  float current_temp = temp_control_get_current_temp();
-  int target_temp = temp_control_get_target_temp();
-  bool is_heating = temp_control_is_heating();
+  // 获取当前状态 (一次读取一致的温控快照)
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
 
   rtc_time_t rtc_time;
   soft_rtc_get_time(&rtc_time);
@@ -85,9 +112,10 @@ static esp_err_t status_get_handler(httpd_req_t *req) {
 
   // 构建JSON响应
   cJSON *root = cJSON_CreateObject();
-  cJSON_AddNumberToObject(root, "current_temp", current_temp);
-  cJSON_AddNumberToObject(root, "target_temp", target_temp);
-  cJSON_AddNumberToObject(root, "is_heating", is_heating ? 1 : 0);
+  cJSON_AddNumberToObject(root, "current_temp", snap.current_temp);
+  cJSON_AddNumberToObject(root, "cup_temp", snap.cup_temp);
+  cJSON_AddNumberToObject(root, "target_temp", snap.target_temp);
+  cJSON_AddNumberToObject(root, "is_heating", snap.is_heating ? 1 : 0);
 
   char time_str[6];
   snprintf(time_str, sizeof(time_str), "%02d:%02d", rtc_time.hour,
@@ -97,6 +125,75 @@ static esp_err_t status_get_handler(httpd_req_t *req) {
 
   cJSON_AddNumberToObject(root, "timer_remaining", timer_remaining);
   cJSON_AddStringToObject(root, "schedule_time", schedule_time);
+  cJSON_AddStringToObject(root, "fault", thermal_fault_to_string(snap.fault));
+  cJSON_AddStringToObject(root, "mode",
+                          temp_heat_mode_to_string(snap.heat_mode));
+  cJSON_AddNumberToObject(root, "boosting", snap.boosting ? 1 : 0);
+  cJSON_AddNumberToObject(root, "profile_step", snap.profile_step);
+
+  temp_eco_status_t eco;
+  temp_control_get_eco_status(&eco);
+  cJSON *eco_obj = cJSON_AddObjectToObject(root, "eco");
+  cJSON_AddNumberToObject(eco_obj, "enabled", eco.enabled ? 1 : 0);
+  cJSON_AddNumberToObject(eco_obj, "holding", eco.holding ? 1 : 0);
+  cJSON_AddNumberToObject(eco_obj, "setpoint", eco.setpoint);
+  cJSON_AddNumberToObject(eco_obj, "ambient", eco.ambient);
+  cJSON_AddNumberToObject(eco_obj, "loss_w_k", eco.loss_w_per_k);
+  cJSON_AddNumberToObject(eco_obj, "baseline_w", eco.baseline_w);
+  cJSON_AddNumberToObject(eco_obj, "saved_wh", eco.saved_wh);
+
+  temp_energy_stats_t energy;
+  temp_control_get_energy_stats(&energy);
+  cJSON *energy_obj = cJSON_AddObjectToObject(root, "energy");
+  cJSON_AddNumberToObject(energy_obj, "power_w", energy.power_w);
+  cJSON_AddNumberToObject(energy_obj, "session_wh", energy.session_wh);
+  cJSON_AddNumberToObject(energy_obj, "day_wh", energy.day_wh);
+  cJSON_AddNumberToObject(energy_obj, "lifetime_wh", energy.lifetime_wh);
+
+  // 预计到温: eta_s 0=已到温, -1=未知; ready_at 为空表示未知
+  cJSON_AddNumberToObject(root, "eta_s", snap.eta_s);
+  char ready_at[6] = "";
+  if (snap.eta_s >= 0) {
+    int minutes =
+        rtc_time.hour * 60 + rtc_time.minute + (snap.eta_s + 59) / 60;
+    snprintf(ready_at, sizeof(ready_at), "%02d:%02d", (minutes / 60) % 24,
+             minutes % 60);
+  }
+  cJSON_AddStringToObject(root, "ready_at", ready_at);
+
+  fopdt_params_t model;
+  temp_control_get_model(&model);
+  cJSON *model_obj = cJSON_AddObjectToObject(root, "model");
+  cJSON_AddNumberToObject(model_obj, "valid", model.valid ? 1 : 0);
+  if (model.valid) {
+    cJSON_AddNumberToObject(model_obj, "gain", model.gain);
+    cJSON_AddNumberToObject(model_obj, "tau_s", model.tau);
+    cJSON_AddNumberToObject(model_obj, "dead_s", model.dead_time);
+    cJSON_AddNumberToObject(model_obj, "ambient", model.ambient);
+  }
+
+  // 芯片温度推算的环境温度及PID前馈
+  temp_ambient_status_t ambient;
+  temp_control_get_ambient_status(&ambient);
+  cJSON *ambient_obj = cJSON_AddObjectToObject(root, "ambient");
+  cJSON_AddNumberToObject(ambient_obj, "sensor", ambient.sensor ? 1 : 0);
+  cJSON_AddNumberToObject(ambient_obj, "calibrated",
+                          ambient.calibrated ? 1 : 0);
+  cJSON_AddNumberToObject(ambient_obj, "temp", ambient.ambient);
+  if (ambient.sensor) {
+    cJSON_AddNumberToObject(ambient_obj, "chip", ambient.chip);
+    cJSON_AddNumberToObject(ambient_obj, "loss_w_k", ambient.loss_w_per_k);
+    cJSON_AddNumberToObject(ambient_obj, "ff_pct", ambient.ff_pct);
+  }
+
+  // 命令到PWM输出的延迟
+  temp_latency_stats_t latency;
+  temp_control_get_latency_stats(&latency);
+  cJSON *latency_obj = cJSON_AddObjectToObject(root, "cmd_latency");
+  cJSON_AddNumberToObject(latency_obj, "count", latency.count);
+  cJSON_AddNumberToObject(latency_obj, "last_us", latency.last_us);
+  cJSON_AddNumberToObject(latency_obj, "max_us", latency.max_us);
+  cJSON_AddNumberToObject(latency_obj, "avg_us", latency.avg_us);
 
   const char *json_str = cJSON_Print(root);
   httpd_resp_sendstr(req, json_str);
@@ -113,6 +210,9 @@ static esp_err_t status_get_handler(httpd_req_t *req) {
  *
  * 接收JSON格式的控制指令：
  * {
+ *   "clear_fault": 1,
+ *   "mode": "boost",
+ *   "eco": 1,
  *   "power": 1,
  *   "set_temp": 60,
  *   "timer_duration": 60,
@@ -132,6 +232,33 @@ static esp_err_t control_post_handler(httpd_req_t *req) {
     return ESP_FAIL;
   }
 
+  // 解析 clear_fault (先于 power, 以便同一请求清除后重新开启)
+  cJSON *clear_item = cJSON_GetObjectItem(root, "clear_fault");
+  if (clear_item && cJSON_IsNumber(clear_item) && clear_item->valueint != 0) {
+    temp_control_clear_fault();
+  }
+
+  // 解析 mode: "pid"、"boost" 或 "cascade" (先于 power/set_temp,
+  // 本次开机即按新策略)
+  cJSON *mode_item = cJSON_GetObjectItem(root, "mode");
+  if (mode_item && cJSON_IsString(mode_item)) {
+    if (strcmp(mode_item->valuestring, "boost") == 0) {
+      temp_control_set_heat_mode(TEMP_HEAT_MODE_BOOST);
+    } else if (strcmp(mode_item->valuestring, "pid") == 0) {
+      temp_control_set_heat_mode(TEMP_HEAT_MODE_PID);
+    } else if (strcmp(mode_item->valuestring, "cascade") == 0) {
+      temp_control_set_heat_mode(TEMP_HEAT_MODE_CASCADE);
+    } else {
+      ESP_LOGW(TAG, "Unknown heat mode: %s", mode_item->valuestring);
+    }
+  }
+
+  // 解析 eco: 到温后节能保温
+  cJSON *eco_item = cJSON_GetObjectItem(root, "eco");
+  if (eco_item && cJSON_IsNumber(eco_item)) {
+    temp_control_set_eco(eco_item->valueint != 0);
+  }
+
   // 解析 power
   cJSON *power_item = cJSON_GetObjectItem(root, "power");
   if (power_item && cJSON_IsNumber(power_item)) {
@@ -225,7 +352,18 @@ static esp_err_t sync_time_post_handler(httpd_req_t *req) {
                            .second = second,
                            .weekday = weekday};
 
-    soft_rtc_set_time(&rtc_time);
+    esp_err_t err = soft_rtc_set_time(&rtc_time);
+    if (err == ESP_ERR_INVALID_ARG) {
+      httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid time");
+      cJSON_Delete(root);
+      return ESP_FAIL;
+    }
+    if (err != ESP_OK) {
+      httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
+                          esp_err_to_name(err));
+      cJSON_Delete(root);
+      return ESP_FAIL;
+    }
     ESP_LOGI(TAG, "Time synced: %s, weekday=%d", time_str, weekday);
 
     httpd_resp_set_type(req, "application/json");
@@ -241,6 +379,647 @@ static esp_err_t sync_time_post_handler(httpd_req_t *req) {
   return ESP_OK;
 }
 
+/**
+ * @brief 自整定状态字符串
+ */
+static const char *autotune_state_string(autotune_state_t state) {
+  switch (state) {
+  case AUTOTUNE_RUNNING:
+    return "running";
+  case AUTOTUNE_DONE:
+    return "done";
+  case AUTOTUNE_FAILED:
+    return "failed";
+  default:
+    return "idle";
+  }
+}
+
+/**
+ * @brief GET /autotune 处理函数
+ *
+ * 返回JSON格式的自整定状态和当前PID参数 (每控制周期)：
+ * {
+ *   "state": "running",
+ *   "cycles": 2,
+ *   "ku": 12.5,
+ *   "pu": 96.0,
+ *   "kp": 2.5,
+ *   "ki": 0.026,
+ *   "kd": 160.0,
+ *   "tuned": 1
+ * }
+ */
+static esp_err_t autotune_get_handler(httpd_req_t *req) {
+  httpd_resp_set_type(req, "application/json");
+
+  temp_autotune_status_t status;
+  temp_control_get_autotune_status(&status);
+
+  cJSON *root = cJSON_CreateObject();
+  cJSON_AddStringToObject(root, "state", autotune_state_string(status.state));
+  cJSON_AddNumberToObject(root, "cycles", status.cycles);
+  cJSON_AddNumberToObject(root, "ku", status.ku);
+  cJSON_AddNumberToObject(root, "pu", status.pu);
+  cJSON_AddNumberToObject(root, "kp", status.kp);
+  cJSON_AddNumberToObject(root, "ki", status.ki);
+  cJSON_AddNumberToObject(root, "kd", status.kd);
+  cJSON_AddNumberToObject(root, "tuned", status.tuned ? 1 : 0);
+
+  const char *json_str = cJSON_Print(root);
+  httpd_resp_sendstr(req, json_str);
+
+  free((void *)json_str);
+  cJSON_Delete(root);
+
+  ESP_LOGI(TAG, "GET /autotune - responded");
+  return ESP_OK;
+}
+
+/**
+ * @brief POST /autotune 处理函数
+ *
+ * 接收JSON格式的自整定指令：
+ * {
+ *   "action": "start",   // "start" | "cancel" | "reset"
+ *   "set_temp": 60       // 仅 start, 缺省为当前目标温度
+ * }
+ */
+static esp_err_t autotune_post_handler(httpd_req_t *req) {
+  if (read_post_body(req, s_scratch, SCRATCH_BUFSIZE) < 0) {
+    return ESP_FAIL;
+  }
+
+  ESP_LOGI(TAG, "POST /autotune: %s", s_scratch);
+
+  cJSON *root = cJSON_Parse(s_scratch);
+  if (root == NULL) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+    return ESP_FAIL;
+  }
+
+  cJSON *action_item = cJSON_GetObjectItem(root, "action");
+  if (!action_item || !cJSON_IsString(action_item)) {
+    cJSON_Delete(root);
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing 'action' field");
+    return ESP_FAIL;
+  }
+
+  esp_err_t err = ESP_OK;
+  const char *action = action_item->valuestring;
+  if (strcmp(action, "start") == 0) {
+    int set_temp = temp_control_get_target_temp();
+    cJSON *temp_item = cJSON_GetObjectItem(root, "set_temp");
+    if (temp_item && cJSON_IsNumber(temp_item)) {
+      set_temp = temp_item->valueint;
+    }
+    err = temp_control_start_autotune(set_temp);
+  } else if (strcmp(action, "cancel") == 0) {
+    temp_control_cancel_autotune();
+  } else if (strcmp(action, "reset") == 0) {
+    err = temp_control_reset_pid_gains();
+  } else {
+    cJSON_Delete(root);
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown action");
+    return ESP_FAIL;
+  }
+
+  cJSON_Delete(root);
+
+  if (err != ESP_OK) {
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
+                        esp_err_to_name(err));
+    return ESP_FAIL;
+  }
+
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_sendstr(req, "{\"result\":\"ok\"}");
+  return ESP_OK;
+}
+
+/**
+ * @brief GET /diag/adc 处理函数
+ *
+ * 返回NTC采样统计和按占空比分组的测量噪声 (LSB^2)：
+ * {
+ *   "sample_freq_hz": 20000,
+ *   "frame_samples": 200,
+ *   "samples_per_cycle": 20,
+ *   "frames": 12345,
+ *   "overflows": 0,
+ *   "noise": [
+ *     {"duty_min": 0, "frames": 800, "sample_var": 4.1, "jitter": 0.03},
+ *     ...
+ *   ],
+ *   "fast_trip": {"supported": 1, "armed": 1, "limit_raw": 305, "trips": 0,
+ *                 "events": 0, "detect_us": 0, "isr_us": 0, "age_ms": 0}
+ * }
+ */
+static esp_err_t diag_adc_get_handler(httpd_req_t *req) {
+  httpd_resp_set_type(req, "application/json");
+
+  ntc_sampler_stats_t stats;
+  ntc_sampler_get_stats(&stats);
+  ntc_noise_bucket_t buckets[NTC_NOISE_BUCKETS];
+  ntc_sampler_get_noise(buckets);
+
+  cJSON *root = cJSON_CreateObject();
+  cJSON_AddNumberToObject(root, "sample_freq_hz", stats.sample_freq_hz);
+  cJSON_AddNumberToObject(root, "frame_samples", stats.frame_samples);
+  cJSON_AddNumberToObject(root, "samples_per_cycle", stats.samples_per_cycle);
+  cJSON_AddNumberToObject(root, "frames", stats.frames);
+  cJSON_AddNumberToObject(root, "overflows", stats.overflows);
+
+  cJSON *noise = cJSON_AddArrayToObject(root, "noise");
+  for (int i = 0; i < NTC_NOISE_BUCKETS; i++) {
+    cJSON *item = cJSON_CreateObject();
+    cJSON_AddNumberToObject(item, "duty_min", i * 100 / NTC_NOISE_BUCKETS);
+    cJSON_AddNumberToObject(item, "frames", buckets[i].frames);
+    cJSON_AddNumberToObject(item, "sample_var", buckets[i].sample_var);
+    cJSON_AddNumberToObject(item, "jitter", buckets[i].reading_jitter);
+    cJSON_AddItemToArray(noise, item);
+  }
+
+  ntc_trip_stats_t trip;
+  ntc_sampler_get_trip_stats(&trip);
+  cJSON *trip_obj = cJSON_AddObjectToObject(root, "fast_trip");
+  cJSON_AddNumberToObject(trip_obj, "supported", trip.supported ? 1 : 0);
+  cJSON_AddNumberToObject(trip_obj, "armed", trip.armed ? 1 : 0);
+  cJSON_AddNumberToObject(trip_obj, "limit_raw", trip.limit_raw);
+  cJSON_AddNumberToObject(trip_obj, "trips", trip.trips);
+  cJSON_AddNumberToObject(trip_obj, "events", trip.events);
+  cJSON_AddNumberToObject(trip_obj, "detect_us", trip.detect_us);
+  cJSON_AddNumberToObject(trip_obj, "isr_us", trip.isr_us);
+  cJSON_AddNumberToObject(trip_obj, "age_ms", trip.age_ms);
+
+  const char *json_str = cJSON_Print(root);
+  httpd_resp_sendstr(req, json_str);
+
+  free((void *)json_str);
+  cJSON_Delete(root);
+
+  ESP_LOGI(TAG, "GET /diag/adc - responded");
+  return ESP_OK;
+}
+
+/**
+ * @brief POST /diag/adc 处理函数 (清除噪声统计)
+ */
+static esp_err_t diag_adc_post_handler(httpd_req_t *req) {
+  ntc_sampler_reset_noise();
+
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_sendstr(req, "{\"result\":\"ok\"}");
+  return ESP_OK;
+}
+
+/**
+ * @brief GET /profile 处理函数
+ *
+ * 返回已保存的温度程序 (未保存时 "steps" 为空) 和执行状态，
+ * ramp 为升降温速率 (°C/min, 0=直接跳变)：
+ * {
+ *   "power_off": 0,
+ *   "steps": [{"target": 65, "ramp": 0, "hold_min": 10},
+ *             {"target": 50, "ramp": 1.0, "hold_min": 0}],
+ *   "phase": "soak",
+ *   "step": 0,
+ *   "setpoint": 65.0,
+ *   "hold_remaining_s": 0
+ * }
+ */
+static esp_err_t profile_get_handler(httpd_req_t *req) {
+  httpd_resp_set_type(req, "application/json");
+
+  profile_t prog;
+  if (temp_control_load_profile(&prog) != ESP_OK) {
+    memset(&prog, 0, sizeof(prog));
+  }
+  temp_profile_status_t status;
+  temp_control_get_profile_status(&status);
+
+  cJSON *root = cJSON_CreateObject();
+  cJSON_AddNumberToObject(root, "power_off", prog.power_off ? 1 : 0);
+  cJSON *steps = cJSON_AddArrayToObject(root, "steps");
+  for (int i = 0; i < prog.n_steps; i++) {
+    cJSON *item = cJSON_CreateObject();
+    cJSON_AddNumberToObject(item, "target", prog.steps[i].target);
+    cJSON_AddNumberToObject(item, "ramp", prog.steps[i].ramp_c10_min / 10.0);
+    cJSON_AddNumberToObject(item, "hold_min", prog.steps[i].hold_min);
+    cJSON_AddItemToArray(steps, item);
+  }
+  cJSON_AddStringToObject(root, "phase", profile_phase_to_string(status.phase));
+  cJSON_AddNumberToObject(root, "step", status.step);
+  cJSON_AddNumberToObject(root, "setpoint", status.setpoint);
+  cJSON_AddNumberToObject(root, "hold_remaining_s", status.hold_remaining_s);
+
+  const char *json_str = cJSON_Print(root);
+  httpd_resp_sendstr(req, json_str);
+
+  free((void *)json_str);
+  cJSON_Delete(root);
+
+  ESP_LOGI(TAG, "GET /profile - responded");
+  return ESP_OK;
+}
+
+/**
+ * @brief 解析温度程序JSON
+ *
+ * @return true 格式正确 (温度范围由 temp_control 校验)
+ */
+static bool parse_profile(const cJSON *root, profile_t *prog) {
+  memset(prog, 0, sizeof(*prog));
+
+  const cJSON *steps = cJSON_GetObjectItem(root, "steps");
+  int n = cJSON_GetArraySize(steps);
+  if (!cJSON_IsArray(steps) || n < 1 || n > PROFILE_MAX_STEPS) {
+    return false;
+  }
+
+  for (int i = 0; i < n; i++) {
+    const cJSON *step = cJSON_GetArrayItem(steps, i);
+    const cJSON *target = cJSON_GetObjectItem(step, "target");
+    const cJSON *ramp = cJSON_GetObjectItem(step, "ramp");
+    const cJSON *hold = cJSON_GetObjectItem(step, "hold_min");
+    if (!cJSON_IsNumber(target)) {
+      return false;
+    }
+    prog->steps[i].target = (int16_t)target->valueint;
+    if (cJSON_IsNumber(ramp)) {
+      if (ramp->valuedouble < 0 || ramp->valuedouble > 6000) {
+        return false;
+      }
+      prog->steps[i].ramp_c10_min = (uint16_t)(ramp->valuedouble * 10 + 0.5);
+    }
+    if (cJSON_IsNumber(hold)) {
+      if (hold->valueint < 0 || hold->valueint > UINT16_MAX) {
+        return false;
+      }
+      prog->steps[i].hold_min = (uint16_t)hold->valueint;
+    }
+  }
+  prog->n_steps = (uint8_t)n;
+
+  const cJSON *power_off = cJSON_GetObjectItem(root, "power_off");
+  prog->power_off = cJSON_IsNumber(power_off) && power_off->valueint != 0;
+  return true;
+}
+
+/**
+ * @brief POST /profile 处理函数
+ *
+ * 接收JSON格式的温度程序和/或执行指令：
+ * {
+ *   "steps": [{"target": 65, "ramp": 0, "hold_min": 10},   // 可选, 保存
+ *             {"target": 50, "ramp": 1.0, "hold_min": 0}],
+ *   "power_off": 0,      // 程序完成后关闭电源
+ *   "action": "start"    // 可选, "start" | "stop"
+ * }
+ */
+static esp_err_t profile_post_handler(httpd_req_t *req) {
+  if (read_post_body(req, s_scratch, SCRATCH_BUFSIZE) < 0) {
+    return ESP_FAIL;
+  }
+
+  ESP_LOGI(TAG, "POST /profile: %s", s_scratch);
+
+  cJSON *root = cJSON_Parse(s_scratch);
+  if (root == NULL) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+    return ESP_FAIL;
+  }
+
+  cJSON *steps_item = cJSON_GetObjectItem(root, "steps");
+  cJSON *action_item = cJSON_GetObjectItem(root, "action");
+  const char *action =
+      cJSON_IsString(action_item) ? action_item->valuestring : NULL;
+  if (steps_item == NULL && action == NULL) {
+    cJSON_Delete(root);
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST,
+                        "Missing 'steps' or 'action' field");
+    return ESP_FAIL;
+  }
+
+  profile_t prog;
+  esp_err_t err = ESP_OK;
+  if (steps_item != NULL) {
+    if (!parse_profile(root, &prog)) {
+      cJSON_Delete(root);
+      httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid 'steps'");
+      return ESP_FAIL;
+    }
+    err = temp_control_save_profile(&prog);
+  } else if (action != NULL && strcmp(action, "start") == 0) {
+    err = temp_control_load_profile(&prog);
+  }
+
+  if (err == ESP_OK && action != NULL) {
+    if (strcmp(action, "start") == 0) {
+      err = temp_control_start_profile(&prog);
+    } else if (strcmp(action, "stop") == 0) {
+      temp_control_stop_profile();
+    } else {
+      cJSON_Delete(root);
+      httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown action");
+      return ESP_FAIL;
+    }
+  }
+
+  cJSON_Delete(root);
+
+  if (err == ESP_ERR_INVALID_ARG || err == ESP_ERR_NOT_FOUND) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST,
+                        err == ESP_ERR_INVALID_ARG ? "Invalid profile"
+                                                   : "No stored profile");
+    return ESP_FAIL;
+  }
+  if (err != ESP_OK) {
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
+                        esp_err_to_name(err));
+    return ESP_FAIL;
+  }
+
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_sendstr(req, "{\"result\":\"ok\"}");
+  return ESP_OK;
+}
+
+/**
+ * @brief GET /schedules 处理函数
+ *
+ * 返回全部预约，days 为星期 (1=周一 ... 7=周日, 空=单次)，
+ * target/duration_min 为0表示沿用当前设定，start_in_s 为距下次启动
+ * 加热的秒数 (RTC未校时为 -1)：
+ * {
+ *   "max": 8,
+ *   "schedules": [{"id": 0, "time": "07:30", "days": [1, 2, 3, 4, 5],
+ *                  "target": 55, "duration_min": 60, "start_in_s": 3600}]
+ * }
+ */
+static esp_err_t schedules_get_handler(httpd_req_t *req) {
+  httpd_resp_set_type(req, "application/json");
+
+  cJSON *root = cJSON_CreateObject();
+  cJSON_AddNumberToObject(root, "max", SCHEDULER_MAX_ENTRIES);
+  cJSON *list = cJSON_AddArrayToObject(root, "schedules");
+  for (int id = 0; id < SCHEDULER_MAX_ENTRIES; id++) {
+    schedule_entry_t entry;
+    int32_t start_in_s;
+    if (scheduler_get_entry(id, &entry, &start_in_s) != ESP_OK) {
+      continue;
+    }
+
+    cJSON *item = cJSON_CreateObject();
+    cJSON_AddNumberToObject(item, "id", id);
+    char time_str[6];
+    snprintf(time_str, sizeof(time_str), "%02d:%02d", entry.minute / 60,
+             entry.minute % 60);
+    cJSON_AddStringToObject(item, "time", time_str);
+    cJSON *days = cJSON_AddArrayToObject(item, "days");
+    for (int d = 0; d < 7; d++) {
+      if (entry.weekdays & (1u << d)) {
+        cJSON_AddItemToArray(days, cJSON_CreateNumber(d + 1));
+      }
+    }
+    cJSON_AddNumberToObject(item, "target", entry.target);
+    cJSON_AddNumberToObject(item, "duration_min", entry.duration_min);
+    cJSON_AddNumberToObject(item, "start_in_s", start_in_s);
+    cJSON_AddItemToArray(list, item);
+  }
+
+  const char *json_str = cJSON_Print(root);
+  httpd_resp_sendstr(req, json_str);
+
+  free((void *)json_str);
+  cJSON_Delete(root);
+
+  ESP_LOGI(TAG, "GET /schedules - responded");
+  return ESP_OK;
+}
+
+/**
+ * @brief 解析预约JSON
+ *
+ * @return true 格式正确 (范围由 scheduler 校验)
+ */
+static bool parse_schedule(const cJSON *root, schedule_entry_t *entry) {
+  memset(entry, 0, sizeof(*entry));
+
+  const cJSON *time_item = cJSON_GetObjectItem(root, "time");
+  int minute = scheduler_parse_time(
+      cJSON_IsString(time_item) ? time_item->valuestring : NULL);
+  if (minute < 0) {
+    return false;
+  }
+  entry->minute = (uint16_t)minute;
+
+  const cJSON *days = cJSON_GetObjectItem(root, "days");
+  if (days != NULL) {
+    if (!cJSON_IsArray(days)) {
+      return false;
+    }
+    const cJSON *day;
+    cJSON_ArrayForEach(day, days) {
+      if (!cJSON_IsNumber(day) || day->valueint < 1 || day->valueint > 7) {
+        return false;
+      }
+      entry->weekdays |= (uint8_t)(1u << (day->valueint - 1));
+    }
+  }
+
+  const cJSON *target = cJSON_GetObjectItem(root, "target");
+  if (cJSON_IsNumber(target)) {
+    if (target->valueint < 0 || target->valueint > INT16_MAX) {
+      return false;
+    }
+    entry->target = (int16_t)target->valueint;
+  }
+  const cJSON *duration = cJSON_GetObjectItem(root, "duration_min");
+  if (cJSON_IsNumber(duration)) {
+    if (duration->valueint < 0 || duration->valueint > UINT16_MAX) {
+      return false;
+    }
+    entry->duration_min = (uint16_t)duration->valueint;
+  }
+  return true;
+}
+
+/**
+ * @brief POST /schedules 处理函数
+ *
+ * 添加 (不带 id) 或修改 (带 id) 预约：
+ * {
+ *   "id": 0,                 // 可选, 修改已有预约
+ *   "time": "07:30",         // 到温时刻
+ *   "days": [1, 2, 3, 4, 5], // 可选, 省略或为空表示单次
+ *   "target": 55,            // 可选, 目标温度
+ *   "duration_min": 60       // 可选, 加热时长
+ * }
+ * 删除预约：{"action": "delete", "id": 0}
+ *
+ * 返回 {"result": "ok", "id": 0}
+ */
+static esp_err_t schedules_post_handler(httpd_req_t *req) {
+  if (read_post_body(req, s_scratch, SCRATCH_BUFSIZE) < 0) {
+    return ESP_FAIL;
+  }
+
+  ESP_LOGI(TAG, "POST /schedules: %s", s_scratch);
+
+  cJSON *root = cJSON_Parse(s_scratch);
+  if (root == NULL) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+    return ESP_FAIL;
+  }
+
+  cJSON *id_item = cJSON_GetObjectItem(root, "id");
+  cJSON *action_item = cJSON_GetObjectItem(root, "action");
+  int id = cJSON_IsNumber(id_item) ? id_item->valueint : -1;
+
+  esp_err_t err;
+  if (cJSON_IsString(action_item)) {
+    if (strcmp(action_item->valuestring, "delete") != 0 || id < 0) {
+      cJSON_Delete(root);
+      httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown action");
+      return ESP_FAIL;
+    }
+    err = scheduler_remove_entry(id);
+  } else {
+    schedule_entry_t entry;
+    if (!parse_schedule(root, &entry)) {
+      cJSON_Delete(root);
+      httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid schedule");
+      return ESP_FAIL;
+    }
+    if (id_item != NULL) {
+      err = scheduler_set_entry(id, &entry);
+    } else {
+      err = scheduler_add_entry(&entry, &id);
+    }
+  }
+
+  cJSON_Delete(root);
+
+  if (err == ESP_ERR_INVALID_ARG || err == ESP_ERR_NOT_FOUND ||
+      err == ESP_ERR_NO_MEM) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST,
+                        err == ESP_ERR_INVALID_ARG ? "Invalid schedule"
+                        : err == ESP_ERR_NOT_FOUND ? "No such schedule"
+                                                   : "Schedule list full");
+    return ESP_FAIL;
+  }
+  if (err != ESP_OK) {
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
+                        esp_err_to_name(err));
+    return ESP_FAIL;
+  }
+
+  char resp[40];
+  snprintf(resp, sizeof(resp), "{\"result\":\"ok\",\"id\":%d}", id);
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_sendstr(req, resp);
+  return ESP_OK;
+}
+
+/**
+ * @brief GET /energy 处理函数
+ *
+ * 返回JSON格式的耗电计量 (day 为空表示时间未同步)：
+ * {
+ *   "heater_w": 15,
+ *   "power_w": 4.5,
+ *   "session_wh": 3.2,
+ *   "session_s": 2700,
+ *   "session_avg_w": 4.27,
+ *   "day": "2025-12-26",
+ *   "day_wh": 12.8,
+ *   "lifetime_wh": 842.5
+ * }
+ */
+static esp_err_t energy_get_handler(httpd_req_t *req) {
+  httpd_resp_set_type(req, "application/json");
+
+  temp_energy_stats_t stats;
+  temp_control_get_energy_stats(&stats);
+
+  cJSON *root = cJSON_CreateObject();
+  cJSON_AddNumberToObject(root, "heater_w", stats.heater_w);
+  cJSON_AddNumberToObject(root, "power_w", stats.power_w);
+  cJSON_AddNumberToObject(root, "session_wh", stats.session_wh);
+  cJSON_AddNumberToObject(root, "session_s", stats.session_s);
+  cJSON_AddNumberToObject(root, "session_avg_w",
+                          stats.session_s > 0 ? stats.session_wh * 3600.0f /
+                                                    (float)stats.session_s
+                                              : 0.0f);
+  char day[12] = "";
+  if (stats.day != 0) {
+    snprintf(day, sizeof(day), "%04lu-%02lu-%02lu",
+             (unsigned long)(stats.day / 10000),
+             (unsigned long)(stats.day / 100 % 100),
+             (unsigned long)(stats.day % 100));
+  }
+  cJSON_AddStringToObject(root, "day", day);
+  cJSON_AddNumberToObject(root, "day_wh", stats.day_wh);
+  cJSON_AddNumberToObject(root, "lifetime_wh", stats.lifetime_wh);
+
+  const char *json_str = cJSON_Print(root);
+  httpd_resp_sendstr(req, json_str);
+
+  free((void *)json_str);
+  cJSON_Delete(root);
+
+  ESP_LOGI(TAG, "GET /energy - responded");
+  return ESP_OK;
+}
+
+/**
+ * @brief POST /energy 处理函数
+ *
+ * 接收JSON格式的指令：
+ * {
+ *   "action": "reset"    // 清零本次/当天/累计计数
+ * }
+ */
+static esp_err_t energy_post_handler(httpd_req_t *req) {
+  if (read_post_body(req, s_scratch, SCRATCH_BUFSIZE) < 0) {
+    return ESP_FAIL;
+  }
+
+  ESP_LOGI(TAG, "POST /energy: %s", s_scratch);
+
+  cJSON *root = cJSON_Parse(s_scratch);
+  if (root == NULL) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+    return ESP_FAIL;
+  }
+
+  cJSON *action_item = cJSON_GetObjectItem(root, "action");
+  bool reset = action_item && cJSON_IsString(action_item) &&
+               strcmp(action_item->valuestring, "reset") == 0;
+  cJSON_Delete(root);
+  if (!reset) {
+    httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown action");
+    return ESP_FAIL;
+  }
+
+  temp_control_reset_energy();
+
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_sendstr(req, "{\"result\":\"ok\"}");
+  return ESP_OK;
+}
+
+/**
+ * @brief 新连接回调
+ *
+ * 随后的请求/响应是一串射频发射，通知加热器避让
+ */
+static esp_err_t session_open(httpd_handle_t hd, int sockfd) {
+  temp_control_tx_backoff(HTTP_TX_BACKOFF_MS);
+  return ESP_OK;
+}
+
 esp_err_t http_server_start(void) {
   if (s_server != NULL) {
     ESP_LOGW(TAG, "Server already running");
@@ -250,6 +1029,8 @@ esp_err_t http_server_start(void) {
   httpd_config_t config = HTTPD_DEFAULT_CONFIG();
   config.uri_match_fn = httpd_uri_match_wildcard;
   config.lru_purge_enable = true;
+  config.max_uri_handlers = 16; // 默认8个不够
+  config.open_fn = session_open;
 
   ESP_LOGI(TAG, "Starting HTTP server on port %d", config.server_port);
 
@@ -281,6 +1062,76 @@ esp_err_t http_server_start(void) {
                                .user_ctx = NULL};
   httpd_register_uri_handler(s_server, &sync_time_uri);
 
+  // GET /autotune
+  httpd_uri_t autotune_get_uri = {.uri = "/autotune",
+                                  .method = HTTP_GET,
+                                  .handler = autotune_get_handler,
+                                  .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &autotune_get_uri);
+
+  // POST /autotune
+  httpd_uri_t autotune_post_uri = {.uri = "/autotune",
+                                   .method = HTTP_POST,
+                                   .handler = autotune_post_handler,
+                                   .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &autotune_post_uri);
+
+  // GET /diag/adc
+  httpd_uri_t diag_adc_get_uri = {.uri = "/diag/adc",
+                                  .method = HTTP_GET,
+                                  .handler = diag_adc_get_handler,
+                                  .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &diag_adc_get_uri);
+
+  // POST /diag/adc
+  httpd_uri_t diag_adc_post_uri = {.uri = "/diag/adc",
+                                   .method = HTTP_POST,
+                                   .handler = diag_adc_post_handler,
+                                   .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &diag_adc_post_uri);
+
+  // GET /profile
+  httpd_uri_t profile_get_uri = {.uri = "/profile",
+                                 .method = HTTP_GET,
+                                 .handler = profile_get_handler,
+                                 .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &profile_get_uri);
+
+  // POST /profile
+  httpd_uri_t profile_post_uri = {.uri = "/profile",
+                                  .method = HTTP_POST,
+                                  .handler = profile_post_handler,
+                                  .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &profile_post_uri);
+
+  // GET /schedules
+  httpd_uri_t schedules_get_uri = {.uri = "/schedules",
+                                   .method = HTTP_GET,
+                                   .handler = schedules_get_handler,
+                                   .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &schedules_get_uri);
+
+  // POST /schedules
+  httpd_uri_t schedules_post_uri = {.uri = "/schedules",
+                                    .method = HTTP_POST,
+                                    .handler = schedules_post_handler,
+                                    .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &schedules_post_uri);
+
+  // GET /energy
+  httpd_uri_t energy_get_uri = {.uri = "/energy",
+                                .method = HTTP_GET,
+                                .handler = energy_get_handler,
+                                .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &energy_get_uri);
+
+  // POST /energy
+  httpd_uri_t energy_post_uri = {.uri = "/energy",
+                                 .method = HTTP_POST,
+                                 .handler = energy_post_handler,
+                                 .user_ctx = NULL};
+  httpd_register_uri_handler(s_server, &energy_post_uri);
+
   ESP_LOGI(TAG, "HTTP server started successfully");
   return ESP_OK;
 }
@@ -19,6 +19,10 @@ extern "C" {
  * - GET  /status     - 获取设备状态
  * - POST /control    - 发送控制指令
  * - POST /sync_time  - 同步时间
+ * - GET  /autotune   - 获取PID自整定状态
+ * - POST /autotune   - 启动/取消自整定, 恢复默认参数
+ * - GET  /diag/adc   - NTC采样统计及按占空比分组的测量噪声
+ * - POST /diag/adc   - 清除噪声统计
  *
  * @return esp_err_t ESP_OK 成功
  */
@@ -40,15 +40,16 @@ void lcd_display_set_brightness(uint8_t brightness);
 /**
  * @brief 更新主界面
  *
- * 显示当前温度、目标温度、时间、星期、WiFi状态
+ * 显示当前温度、目标温度、时间、星期、WiFi状态、预计到温时间
  *
  * @param current_temp 当前温度
  * @param target_temp 目标温度
  * @param is_heating 是否加热中
  * @param wifi_connected WiFi是否已连接
+ * @param eta_s 预计到温剩余时间 (s), 0=已到温, -1=未知
  */
 void lcd_display_update_main(float current_temp, int target_temp,
-                             bool is_heating, bool wifi_connected);
+                             bool is_heating, bool wifi_connected, int eta_s);
 
 /**
  * @brief 显示菜单界面
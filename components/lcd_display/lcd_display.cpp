@@ -10,6 +10,9 @@
 #include "soft_rtc.h"
 #include "temp_control.h"
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
 // Compatibility fixes for LovyanGFX on ESP-IDF 5.x (ESP32-C3)
 #if !defined(GPIO_FUNC0_IN_SEL_CFG_REG)
 #include "soc/gpio_reg.h"
@@ -116,6 +119,11 @@ static LGFX lcd;
 static LGFX_Sprite sprite(&lcd);
 static ui_screen_t s_current_screen = UI_SCREEN_MAIN;
 
+// 状态栏时钟: 由软件RTC的秒节拍更新，刷新画面时不再逐帧读取RTC
+static portMUX_TYPE s_clock_lock = portMUX_INITIALIZER_UNLOCKED;
+static rtc_time_t s_clock;
+static bool s_clock_subscribed = false;
+
 // ============================================================================
 // 菜单项定义
 // ============================================================================
@@ -135,6 +143,34 @@ static const int menuCount = sizeof(menuItems) / sizeof(menuItems[0]);
 // 辅助绘图函数
 // ============================================================================
 
+/**
+ * @brief 秒节拍回调 (定时器任务上下文)
+ */
+static void clock_tick(const rtc_time_t *now, void *arg) {
+  taskENTER_CRITICAL(&s_clock_lock);
+  s_clock = *now;
+  taskEXIT_CRITICAL(&s_clock_lock);
+}
+
+/**
+ * @brief 取状态栏时钟
+ *
+ * 首次调用时订阅秒节拍 (软件RTC在LCD之后初始化)，订阅失败时直接读取RTC
+ */
+static void clock_get(rtc_time_t *out) {
+  if (!s_clock_subscribed) {
+    soft_rtc_get_time(&s_clock);
+    s_clock_subscribed = soft_rtc_subscribe_tick(clock_tick, nullptr) == ESP_OK;
+    if (!s_clock_subscribed) {
+      *out = s_clock;
+      return;
+    }
+  }
+  taskENTER_CRITICAL(&s_clock_lock);
+  *out = s_clock;
+  taskEXIT_CRITICAL(&s_clock_lock);
+}
+
 /**
  * @brief 绘制圆角进度条
  */
@@ -224,12 +260,12 @@ void lcd_display_set_brightness(uint8_t brightness) {
 }
 
 void lcd_display_update_main(float current_temp, int target_temp,
-                             bool is_heating, bool wifi_connected) {
+                             bool is_heating, bool wifi_connected, int eta_s) {
   s_current_screen = UI_SCREEN_MAIN;
 
   // 获取时间
   rtc_time_t rtc_time;
-  soft_rtc_get_time(&rtc_time);
+  clock_get(&rtc_time);
 
   // 清屏
   sprite.fillScreen(0x0000);
@@ -295,7 +331,16 @@ void lcd_display_update_main(float current_temp, int target_temp,
   sprite.setTextColor(0xFFFF);
   sprite.setCursor(5, 135);
 
-  if (is_heating) {
+  if (is_heating && eta_s > 0) {
+    // 预计就绪时刻 (按分钟向上取整)
+    int minutes = rtc_time.hour * 60 + rtc_time.minute + (eta_s + 59) / 60;
+    char ready_str[16];
+    snprintf(ready_str, sizeof(ready_str), " %02d:%02d", (minutes / 60) % 24,
+             minutes % 60);
+    sprite.print("加热中");
+    sprite.print(ready_str);
+    sprite.print("就绪");
+  } else if (is_heating) {
     sprite.print("加热中...");
   } else if (current_temp >= target_temp - 2) {
     sprite.print("保温中");
@@ -0,0 +1,87 @@
+/**
+ * @file sched_heap.h
+ * @brief 按触发时刻排序的最小堆
+ *
+ * 元素以小整数 id (0 .. SCHED_HEAP_MAX-1) 标识，另存 id 到堆下标的索引，
+ * 插入、修改触发时刻和删除任意元素均为 O(log n)，取最早元素为 O(1)
+ */
+
+#ifndef SCHED_HEAP_H
+#define SCHED_HEAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCHED_HEAP_MAX 16 // 最大元素数
+
+/**
+ * @brief 最小堆结构体
+ */
+typedef struct {
+  int n;                        // 元素个数
+  uint8_t ids[SCHED_HEAP_MAX];  // 堆数组 (存 id)
+  int8_t pos[SCHED_HEAP_MAX];   // id 对应的堆下标, -1 不在堆中
+  int64_t keys[SCHED_HEAP_MAX]; // id 对应的触发时刻
+} sched_heap_t;
+
+/**
+ * @brief 初始化为空堆
+ *
+ * @param h 堆指针
+ */
+void sched_heap_init(sched_heap_t *h);
+
+/**
+ * @brief 插入元素或修改已有元素的触发时刻
+ *
+ * @param h 堆指针
+ * @param id 元素 id
+ * @param key 触发时刻
+ */
+void sched_heap_update(sched_heap_t *h, int id, int64_t key);
+
+/**
+ * @brief 删除元素 (不在堆中时无操作)
+ *
+ * @param h 堆指针
+ * @param id 元素 id
+ */
+void sched_heap_remove(sched_heap_t *h, int id);
+
+/**
+ * @brief 元素是否在堆中
+ *
+ * @param h 堆指针
+ * @param id 元素 id
+ * @return true 在堆中
+ */
+bool sched_heap_contains(const sched_heap_t *h, int id);
+
+/**
+ * @brief 取元素的触发时刻
+ *
+ * @param h 堆指针
+ * @param id 元素 id
+ * @param key 输出触发时刻
+ * @return true 在堆中
+ */
+bool sched_heap_get(const sched_heap_t *h, int id, int64_t *key);
+
+/**
+ * @brief 取最早的元素
+ *
+ * @param h 堆指针
+ * @param key 输出触发时刻 (可为 NULL)
+ * @return int 元素 id, 空堆返回 -1
+ */
+int sched_heap_peek(const sched_heap_t *h, int64_t *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCHED_HEAP_H
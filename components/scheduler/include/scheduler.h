@@ -8,6 +8,7 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 
 #ifdef __cplusplus
@@ -24,6 +25,21 @@ typedef enum {
   SCHED_STATE_TIMEOUT        // 已超时
 } scheduler_state_t;
 
+#define SCHEDULER_MAX_ENTRIES 8 // 最大预约条数 (含单次预约)
+
+/**
+ * @brief 预约条目
+ *
+ * 每周重复的预约保存在NVS中，单次预约 (weekdays=0) 不保存，
+ * 触发后自动删除; 启动时加热器已开启则顺延到次日
+ */
+typedef struct {
+  uint8_t weekdays;      // 星期掩码, bit0=周一 ... bit6=周日, 0=单次
+  uint16_t minute;       // 到温时刻 (当天分钟数)
+  int16_t target;        // 目标温度 (°C), 0=沿用当前设定
+  uint16_t duration_min; // 加热时长 (min), 0=沿用定时时长
+} schedule_entry_t;
+
 /**
  * @brief 初始化调度器
  *
@@ -39,7 +55,8 @@ void scheduler_start_task(void);
 /**
  * @brief 设置定时加热时长
  *
- * 加热开启后开始倒计时，到时自动关闭加热
+ * 加热开启后开始倒计时，到时自动关闭加热。倒计时按累计加热时长计，
+ * 期间关机则暂停
  *
  * @param minutes 加热时长 (分钟)
  */
@@ -48,7 +65,7 @@ void scheduler_set_timer_duration(int minutes);
 /**
  * @brief 获取定时器剩余时间
  *
- * @return int 剩余分钟数
+ * @return int 剩余分钟数 (向上取整), 未运行返回 0
  */
 int scheduler_get_timer_remaining(void);
 
@@ -56,25 +73,72 @@ int scheduler_get_timer_remaining(void);
  * @brief 设置预约加热时间
  *
  * 格式 "HH:MM"，到达指定时间时自动开始加热
- * 会提前启动以确保到时温度达标
+ * 会提前启动以确保到时温度达标。设为单次预约，替换之前的单次预约
  *
  * @param time_str 预约时间 "HH:MM"
  */
 void scheduler_set_schedule_time(const char *time_str);
 
 /**
- * @brief 获取预约时间
+ * @brief 获取最近一个预约的到温时间
  *
- * @param buf 输出缓冲区
+ * @param buf 输出缓冲区, 无预约时为空串
  * @param buf_size 缓冲区大小
  */
 void scheduler_get_schedule_time(char *buf, int buf_size);
 
 /**
- * @brief 取消预约
+ * @brief 取消单次预约 (每周重复的预约不受影响)
  */
 void scheduler_cancel_schedule(void);
 
+/**
+ * @brief 解析 "HH:MM" (可带 ":SS", 忽略秒)
+ *
+ * @param time_str 时间字符串
+ * @return int 当天分钟数, 格式错误返回 -1
+ */
+int scheduler_parse_time(const char *time_str);
+
+/**
+ * @brief 添加预约
+ *
+ * @param entry 预约条目
+ * @param id 输出槽位号 (可为 NULL)
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_ARG 参数错误,
+ *         ESP_ERR_NO_MEM 已满, 其他为NVS错误 (预约已生效)
+ */
+esp_err_t scheduler_add_entry(const schedule_entry_t *entry, int *id);
+
+/**
+ * @brief 修改预约
+ *
+ * @param id 槽位号
+ * @param entry 新的预约条目
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_NOT_FOUND 槽位未使用
+ */
+esp_err_t scheduler_set_entry(int id, const schedule_entry_t *entry);
+
+/**
+ * @brief 删除预约
+ *
+ * @param id 槽位号
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_NOT_FOUND 槽位未使用
+ */
+esp_err_t scheduler_remove_entry(int id);
+
+/**
+ * @brief 读取预约
+ *
+ * @param id 槽位号 (0 .. SCHEDULER_MAX_ENTRIES-1)
+ * @param entry 输出预约条目
+ * @param start_in_s 输出距下次启动加热的秒数 (可为 NULL),
+ *        RTC未校时为 -1
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_NOT_FOUND 槽位未使用
+ */
+esp_err_t scheduler_get_entry(int id, schedule_entry_t *entry,
+                              int32_t *start_in_s);
+
 /**
  * @brief 启动倒计时
  *
@@ -0,0 +1,60 @@
+/**
+ * @file weekly.h
+ * @brief 每周重复预约的触发时刻计算
+ *
+ * 时刻统一用 2000-01-01 00:00 起的秒数表示 (本地时间, 不含闰秒)，
+ * 星期由日期推算，与RTC中单独保存的星期字段无关
+ */
+
+#ifndef WEEKLY_H
+#define WEEKLY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WEEKLY_SEC_PER_DAY (24 * 60 * 60)
+
+/**
+ * @brief 日期时间转换为 2000-01-01 起的秒数
+ *
+ * @param year 年 (>= 2000)
+ * @param month 月 (1-12)
+ * @param day 日 (1-31)
+ * @param hour 时
+ * @param minute 分
+ * @param second 秒
+ * @return int64_t 秒数
+ */
+int64_t weekly_time(int year, int month, int day, int hour, int minute,
+                    int second);
+
+/**
+ * @brief 时刻所在的星期
+ *
+ * @param t 2000-01-01 起的秒数
+ * @return int 星期 (1-7, 1=周一, 7=周日)
+ */
+int weekly_weekday(int64_t t);
+
+/**
+ * @brief 计算不早于 after 的下一个启动时刻
+ *
+ * 到温时刻为星期掩码中某天的 minute 分，启动时刻比到温时刻提前 lead_s
+ *
+ * @param weekdays 星期掩码, bit0=周一 ... bit6=周日, 0=每天
+ * @param minute 到温时刻 (当天分钟数)
+ * @param lead_s 提前量 (s)
+ * @param after 最早的启动时刻
+ * @return int64_t 启动时刻
+ */
+int64_t weekly_next_start(uint8_t weekdays, int minute, int32_t lead_s,
+                          int64_t after);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEEKLY_H
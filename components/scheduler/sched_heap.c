@@ -0,0 +1,121 @@
+/**
+ * @file sched_heap.c
+ * @brief 按触发时刻排序的最小堆实现
+ */
+
+#include "sched_heap.h"
+#include <stddef.h>
+
+static bool less(const sched_heap_t *h, int i, int j) {
+  return h->keys[h->ids[i]] < h->keys[h->ids[j]];
+}
+
+static void swap(sched_heap_t *h, int i, int j) {
+  uint8_t t = h->ids[i];
+  h->ids[i] = h->ids[j];
+  h->ids[j] = t;
+  h->pos[h->ids[i]] = (int8_t)i;
+  h->pos[h->ids[j]] = (int8_t)j;
+}
+
+static void sift_up(sched_heap_t *h, int i) {
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (!less(h, i, parent)) {
+      break;
+    }
+    swap(h, i, parent);
+    i = parent;
+  }
+}
+
+static void sift_down(sched_heap_t *h, int i) {
+  for (;;) {
+    int min = i;
+    int l = 2 * i + 1;
+    int r = l + 1;
+    if (l < h->n && less(h, l, min)) {
+      min = l;
+    }
+    if (r < h->n && less(h, r, min)) {
+      min = r;
+    }
+    if (min == i) {
+      break;
+    }
+    swap(h, i, min);
+    i = min;
+  }
+}
+
+void sched_heap_init(sched_heap_t *h) {
+  h->n = 0;
+  for (int i = 0; i < SCHED_HEAP_MAX; i++) {
+    h->pos[i] = -1;
+    h->keys[i] = 0;
+  }
+}
+
+void sched_heap_update(sched_heap_t *h, int id, int64_t key) {
+  if (id < 0 || id >= SCHED_HEAP_MAX) {
+    return;
+  }
+  int i = h->pos[id];
+  if (i < 0) {
+    i = h->n++;
+    h->ids[i] = (uint8_t)id;
+    h->pos[id] = (int8_t)i;
+    h->keys[id] = key;
+    sift_up(h, i);
+    return;
+  }
+
+  int64_t old = h->keys[id];
+  h->keys[id] = key;
+  if (key < old) {
+    sift_up(h, i);
+  } else {
+    sift_down(h, i);
+  }
+}
+
+void sched_heap_remove(sched_heap_t *h, int id) {
+  if (!sched_heap_contains(h, id)) {
+    return;
+  }
+  int i = h->pos[id];
+  int last = --h->n;
+  h->pos[id] = -1;
+  if (i == last) {
+    return;
+  }
+
+  // 末尾元素移入空位，可能需要上浮或下沉
+  uint8_t moved = h->ids[last];
+  h->ids[i] = moved;
+  h->pos[moved] = (int8_t)i;
+  sift_up(h, i);
+  sift_down(h, h->pos[moved]);
+}
+
+bool sched_heap_contains(const sched_heap_t *h, int id) {
+  return id >= 0 && id < SCHED_HEAP_MAX && h->pos[id] >= 0;
+}
+
+bool sched_heap_get(const sched_heap_t *h, int id, int64_t *key) {
+  if (!sched_heap_contains(h, id)) {
+    return false;
+  }
+  *key = h->keys[id];
+  return true;
+}
+
+int sched_heap_peek(const sched_heap_t *h, int64_t *key) {
+  if (h->n == 0) {
+    return -1;
+  }
+  if (key != NULL) {
+    *key = h->keys[h->ids[0]];
+  }
+  return h->ids[0];
+}
@@ -1,19 +1,22 @@
 /**
  * @file scheduler.c
  * @brief 定时与预约模块实现
+ *
+ * 定时器和互斥锁经由 os_port.h，可在主机上以虚拟时钟运行 (tools/sched_sim)
  */
 
 #include "scheduler.h"
+#include "sched_heap.h"
 #include "sdkconfig.h"
 #include "soft_rtc.h"
 #include "temp_control.h"
+#include "weekly.h"
 
 
 #include "esp_log.h"
-#include "esp_timer.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
-#include "freertos/task.h"
+#include "nvs.h"
+#include "os_port.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -25,143 +28,434 @@ static const char *TAG = "Scheduler";
 #define CONFIG_MAX_HEATING_TIME_MINUTES 240 // 4小时
 #endif
 
-// 预热时间估算 (从Kconfig读取)
+// 升温曲线未学习时的预热时间 (从Kconfig读取)
 #ifndef CONFIG_PREHEAT_TIME_MINUTES
 #define CONFIG_PREHEAT_TIME_MINUTES 5
 #endif
 
+#define SCHEDULE_LATE_S 60 // 启动时刻后此时间内仍触发 (s)
+#define RETRY_US 10000     // 回调取锁失败时的重试间隔 (us)
+
+#if SCHEDULER_MAX_ENTRIES > SCHED_HEAP_MAX
+#error "SCHEDULER_MAX_ENTRIES exceeds SCHED_HEAP_MAX"
+#endif
+
+// NVS 存储的 key
+#define NVS_NAMESPACE "scheduler"
+#define NVS_KEY_ENTRIES "entries"
+
+/**
+ * @brief NVS中保存的重复预约 (单次预约不保存)
+ */
+typedef struct {
+  uint16_t used; // 槽位掩码
+  schedule_entry_t entries[SCHEDULER_MAX_ENTRIES];
+} stored_schedules_t;
+
 // ============================================================================
 // 静态变量
 // ============================================================================
-static int s_timer_duration = 60; // 设定的加热时长 (分钟)
-static int s_timer_remaining = 0; // 剩余时间 (分钟)
-static int s_timer_seconds = 0;   // 剩余秒数 (内部计时用)
+static int s_timer_duration = 60;  // 设定的加热时长 (分钟)
+static int64_t s_timer_end_us = 0; // 倒计时截止的累计开机时长 (us)
 static bool s_timer_running = false;
 
-static char s_schedule_time[8] = ""; // 预约时间 "HH:MM"
-static bool s_schedule_active = false;
+static schedule_entry_t s_entries[SCHEDULER_MAX_ENTRIES];
+static uint16_t s_used = 0;   // 已用槽位掩码
+static uint16_t s_dirty = 0;  // 需按当前时间重新计算启动时刻的槽位
+static int s_oneshot_id = -1; // scheduler_set_schedule_time 的单次预约槽位
+static sched_heap_t s_heap;   // 各预约的下一启动时刻 (2000-01-01 起的秒数)
+// 各预约下一次的到温时刻 (2000-01-01 起的秒数)
+static int64_t s_ready_at[SCHEDULER_MAX_ENTRIES];
 
 static scheduler_state_t s_state = SCHED_STATE_IDLE;
-static SemaphoreHandle_t s_mutex = NULL;
+static os_lock_t s_mutex = NULL;
 
 static void (*s_timeout_callback)(void) = NULL;
 
-// 1秒定时器
-static esp_timer_handle_t s_timer = NULL;
+// 单次定时器: 只在截止时刻唤醒。预约无论多少条只装载最早的一个
+static os_timer_t s_countdown_timer = NULL;
+static os_timer_t s_schedule_timer = NULL;
 
 // ============================================================================
 // 解析预约时间
 // ============================================================================
-static bool parse_schedule_time(const char *time_str, int *hour, int *minute) {
-  if (time_str == NULL || strlen(time_str) < 5) {
-    return false;
+static int parse_2digits(const char *p) {
+  if (p[0] < '0' || p[0] > '9' || p[1] < '0' || p[1] > '9') {
+    return -1;
   }
+  return (p[0] - '0') * 10 + (p[1] - '0');
+}
 
-  if (sscanf(time_str, "%d:%d", hour, minute) == 2) {
-    if (*hour >= 0 && *hour <= 23 && *minute >= 0 && *minute <= 59) {
-      return true;
-    }
+int scheduler_parse_time(const char *time_str) {
+  if (time_str == NULL || strlen(time_str) < 5 || time_str[2] != ':') {
+    return -1;
+  }
+  int hour = parse_2digits(time_str);
+  int minute = parse_2digits(time_str + 3);
+  if (hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+    return -1;
   }
-  return false;
+  return hour * 60 + minute;
+}
+
+/**
+ * @brief 重新装载单次定时器
+ */
+static void timer_arm(os_timer_t timer, int64_t delay_us) {
+  os_timer_stop(timer); // 未运行时返回错误，忽略
+  if (delay_us < 0) {
+    delay_us = 0;
+  }
+  os_timer_start_once(timer, (uint64_t)delay_us);
 }
 
 // ============================================================================
-// 1秒定时器回调
+// 倒计时 (调用者持有 s_mutex)
 // ============================================================================
-static void scheduler_timer_callback(void *arg) {
-  if (xSemaphoreTake(s_mutex, 0) != pdTRUE) {
+
+/**
+ * @brief 开始倒计时
+ *
+ * 倒计时以累计开机时长计，关机期间暂停
+ *
+ * @param minutes 加热时长 (分钟)
+ */
+static void countdown_start(int minutes) {
+  int64_t duration_us = (int64_t)minutes * 60 * 1000000;
+  s_timer_end_us = temp_control_get_on_time_us() + duration_us;
+  s_timer_running = true;
+  s_state = SCHED_STATE_TIMER_RUNNING;
+  timer_arm(s_countdown_timer, duration_us);
+}
+
+static void countdown_timer_callback(void *arg) {
+  if (!os_lock_take(s_mutex, 0)) {
+    timer_arm(s_countdown_timer, RETRY_US); // 不丢弃到期事件
+    return;
+  }
+  if (!s_timer_running) {
+    os_lock_give(s_mutex);
+    return;
+  }
+
+  // 期间有关机时开机时长未到截止值，按剩余时长重新装载
+  int64_t left_us = s_timer_end_us - temp_control_get_on_time_us();
+  if (left_us > 0) {
+    timer_arm(s_countdown_timer, left_us);
+    os_lock_give(s_mutex);
+    return;
+  }
+
+  s_timer_running = false;
+  s_state = SCHED_STATE_TIMEOUT;
+  ESP_LOGI(TAG, "Timer expired, turning off heater");
+  temp_control_set_power(false);
+  if (s_timeout_callback) {
+    s_timeout_callback();
+  }
+  os_lock_give(s_mutex);
+}
+
+// ============================================================================
+// 预约 (调用者持有 s_mutex)
+// ============================================================================
+
+/**
+ * @brief 当前RTC时间, 2000-01-01 起的秒数
+ */
+static bool now_time(int64_t *now) {
+  rtc_time_t t;
+  if (soft_rtc_get_time(&t) != ESP_OK) {
+    return false;
+  }
+  *now = weekly_time(t.year, t.month, t.day, t.hour, t.minute, t.second);
+  return true;
+}
+
+static bool entry_valid(const schedule_entry_t *entry) {
+  return entry->weekdays <= 0x7F && entry->minute < 24 * 60 &&
+         entry->target >= 0 &&
+         entry->duration_min <= CONFIG_MAX_HEATING_TIME_MINUTES;
+}
+
+/**
+ * @brief 预约的提前量: 按学得的升温曲线估计, 未学习时用固定值
+ *
+ * @param cold true 从环境温度起算 (偏早), false 从当前读数起算
+ */
+static int32_t entry_lead_s(const schedule_entry_t *entry, bool cold) {
+  int target =
+      entry->target > 0 ? entry->target : temp_control_get_target_temp();
+  int32_t lead = temp_control_get_preheat_s(target, cold);
+  if (lead < 0) {
+    return CONFIG_PREHEAT_TIME_MINUTES * 60;
+  }
+  const int32_t lead_max = CONFIG_MAX_HEATING_TIME_MINUTES * 60;
+  return lead < lead_max ? lead : lead_max;
+}
+
+/**
+ * @brief 计算不早于 after 的下一次启动时刻并更新堆
+ *
+ * 装载时按从环境温度升温估计，宁早勿晚；到时再按当前读数修正
+ */
+static void entry_schedule(int id, int64_t after) {
+  const schedule_entry_t *e = &s_entries[id];
+  int32_t lead = entry_lead_s(e, true);
+  int64_t start = weekly_next_start(e->weekdays, e->minute, lead, after);
+  s_ready_at[id] = start + lead;
+  sched_heap_update(&s_heap, id, start);
+}
+
+/**
+ * @brief 重新计算需要更新的预约的启动时刻
+ *
+ * 刚过启动时刻不久的仍算作本次，设置预约或校时后可立即触发
+ */
+static void schedule_refresh(int64_t now) {
+  for (int id = 0; id < SCHEDULER_MAX_ENTRIES; id++) {
+    if (!(s_dirty & (1u << id))) {
+      continue;
+    }
+    entry_schedule(id, now - SCHEDULE_LATE_S + 1);
+  }
+  s_dirty = 0;
+}
+
+/**
+ * @brief 把预约定时器装载到最早的启动时刻
+ */
+static void schedule_arm_from(int64_t now) {
+  int64_t start;
+  if (sched_heap_peek(&s_heap, &start) < 0) {
+    os_timer_stop(s_schedule_timer);
     return;
   }
+  timer_arm(s_schedule_timer, (start - now) * 1000000);
+}
 
-  // 倒计时逻辑
-  if (s_timer_running && temp_control_get_power()) {
-    s_timer_seconds--;
-    if (s_timer_seconds <= 0) {
-      s_timer_running = false;
-      s_timer_remaining = 0;
-      s_state = SCHED_STATE_TIMEOUT;
+static void schedule_arm(void) {
+  int64_t now;
+  if (!soft_rtc_is_synced()) {
+    // 未校时的RTC时间没有意义, 校时后由 schedule_recompute 装载
+    os_timer_stop(s_schedule_timer);
+  } else if (!now_time(&now)) {
+    timer_arm(s_schedule_timer, RETRY_US);
+  } else {
+    schedule_refresh(now);
+    schedule_arm_from(now);
+  }
+}
 
-      ESP_LOGI(TAG, "Timer expired, turning off heater");
-      temp_control_set_power(false);
+static void entry_free(int id) {
+  s_used &= ~(1u << id);
+  s_dirty &= ~(1u << id);
+  sched_heap_remove(&s_heap, id);
+  if (id == s_oneshot_id) {
+    s_oneshot_id = -1;
+  }
+  if (s_used == 0 && s_state == SCHED_STATE_SCHEDULED) {
+    s_state = SCHED_STATE_IDLE;
+  }
+}
 
-      if (s_timeout_callback) {
-        s_timeout_callback();
+static void entry_store(int id, const schedule_entry_t *entry) {
+  s_entries[id] = *entry;
+  s_used |= 1u << id;
+  s_dirty |= 1u << id;
+  if (s_state == SCHED_STATE_IDLE) {
+    s_state = SCHED_STATE_SCHEDULED;
+  }
+  schedule_arm();
+}
+
+static int entry_alloc(void) {
+  for (int id = 0; id < SCHEDULER_MAX_ENTRIES; id++) {
+    if (!(s_used & (1u << id))) {
+      return id;
+    }
+  }
+  return -1;
+}
+
+static void schedule_fire(int id, int64_t now) {
+  const schedule_entry_t *e = &s_entries[id];
+  int minutes = e->duration_min > 0 ? e->duration_min : s_timer_duration;
+  ESP_LOGI(TAG,
+           "Schedule %d triggered, starting heater (preheat %ld s before "
+           "%02d:%02d, %d min)",
+           id, (long)(s_ready_at[id] - now), e->minute / 60, e->minute % 60,
+           minutes);
+
+  if (e->target > 0) {
+    temp_control_set_target_temp(e->target);
+  }
+  temp_control_set_power(true);
+  countdown_start(minutes);
+}
+
+static void schedule_timer_callback(void *arg) {
+  if (!os_lock_take(s_mutex, 0)) {
+    timer_arm(s_schedule_timer, RETRY_US);
+    return;
+  }
+
+  int64_t now;
+  if (!soft_rtc_is_synced() || !now_time(&now)) {
+    schedule_arm();
+    os_lock_give(s_mutex);
+    return;
+  }
+  schedule_refresh(now);
+
+  // 软件RTC与单调时钟可能有少量偏差: 未到时刻时只补足剩余时间
+  int64_t start;
+  int id;
+  bool fired = false;
+  while ((id = sched_heap_peek(&s_heap, &start)) >= 0 && start <= now) {
+    bool late = now - start >= SCHEDULE_LATE_S;
+    if (!fired && !late && !temp_control_get_power()) {
+      // 按当前读数修正提前量: 杯子尚未冷到环境温度时推迟启动
+      int64_t warm_start = s_ready_at[id] - entry_lead_s(&s_entries[id], false);
+      if (warm_start > now) {
+        sched_heap_update(&s_heap, id, warm_start);
+        continue;
+      }
+      schedule_fire(id, now);
+      fired = true;
+      if (s_entries[id].weekdays == 0) {
+        entry_free(id); // 单次预约触发后取消
+        continue;
       }
     } else {
-      s_timer_remaining = (s_timer_seconds + 59) / 60; // 向上取整
+      ESP_LOGW(TAG, "Schedule %d skipped (%s)", id,
+               late ? "missed" : "heater already on");
     }
+    // 下一次: 每周重复的按星期掩码, 未触发的单次预约顺延到次日
+    entry_schedule(id, now + 1);
   }
 
-  // 预约检查逻辑
-  if (s_schedule_active && !temp_control_get_power()) {
-    int sched_hour, sched_minute;
-    if (parse_schedule_time(s_schedule_time, &sched_hour, &sched_minute)) {
-      rtc_time_t now;
-      soft_rtc_get_time(&now);
+  schedule_arm_from(now);
+  os_lock_give(s_mutex);
+}
 
-      // 计算当前时间的分钟数 和 预约时间的分钟数
-      int now_minutes = now.hour * 60 + now.minute;
-      int sched_minutes = sched_hour * 60 + sched_minute;
+/**
+ * @brief RTC时间被修改或升温曲线更新: 重新计算全部启动时刻
+ */
+static void schedule_recompute(void) {
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  s_dirty = s_used;
+  schedule_arm();
+  os_lock_give(s_mutex);
+}
 
-      // 考虑预热时间
-      int start_minutes = sched_minutes - CONFIG_PREHEAT_TIME_MINUTES;
-      if (start_minutes < 0) {
-        start_minutes += 24 * 60; // 跨天处理
-      }
+// ============================================================================
+// NVS 存储
+// ============================================================================
+static void load_entries(void) {
+  nvs_handle_t nvs_handle;
+  if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+    return;
+  }
 
-      // 检查是否应该启动
-      if (now_minutes == start_minutes) {
-        ESP_LOGI(
-            TAG,
-            "Schedule triggered, starting heater (preheat %d min before %s)",
-            CONFIG_PREHEAT_TIME_MINUTES, s_schedule_time);
-
-        temp_control_set_power(true);
-        s_schedule_active = false; // 触发后取消预约
-
-        // 启动倒计时
-        s_timer_running = true;
-        s_timer_seconds = s_timer_duration * 60;
-        s_timer_remaining = s_timer_duration;
-        s_state = SCHED_STATE_TIMER_RUNNING;
-      }
+  stored_schedules_t stored;
+  size_t len = sizeof(stored);
+  esp_err_t err = nvs_get_blob(nvs_handle, NVS_KEY_ENTRIES, &stored, &len);
+  nvs_close(nvs_handle);
+  if (err != ESP_OK || len != sizeof(stored)) {
+    return;
+  }
+
+  for (int id = 0; id < SCHEDULER_MAX_ENTRIES; id++) {
+    const schedule_entry_t *e = &stored.entries[id];
+    if ((stored.used & (1u << id)) && e->weekdays != 0 && entry_valid(e)) {
+      s_entries[id] = *e;
+      s_used |= 1u << id;
+    }
+  }
+  s_dirty = s_used;
+  if (s_used != 0) {
+    s_state = SCHED_STATE_SCHEDULED;
+  }
+  ESP_LOGI(TAG, "Loaded schedules (mask 0x%02x)", s_used);
+}
+
+/**
+ * @brief 保存每周重复的预约 (调用者不持有 s_mutex)
+ */
+static esp_err_t save_entries(void) {
+  stored_schedules_t stored;
+  memset(&stored, 0, sizeof(stored));
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  for (int id = 0; id < SCHEDULER_MAX_ENTRIES; id++) {
+    if ((s_used & (1u << id)) && s_entries[id].weekdays != 0) {
+      stored.used |= 1u << id;
+      stored.entries[id] = s_entries[id];
     }
   }
+  os_lock_give(s_mutex);
 
-  xSemaphoreGive(s_mutex);
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+    return err;
+  }
+  err = nvs_set_blob(nvs_handle, NVS_KEY_ENTRIES, &stored, sizeof(stored));
+  if (err == ESP_OK) {
+    err = nvs_commit(nvs_handle);
+  }
+  nvs_close(nvs_handle);
+
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to save schedules: %s", esp_err_to_name(err));
+  }
+  return err;
 }
 
 // ============================================================================
 // 公开接口实现
 // ============================================================================
 
+static esp_err_t create_timer(void (*callback)(void *), const char *name,
+                              os_timer_t *handle) {
+  esp_err_t err = os_timer_create(callback, NULL, name, handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(err));
+  }
+  return err;
+}
+
 esp_err_t scheduler_init(void) {
-  s_mutex = xSemaphoreCreateMutex();
+  s_mutex = os_lock_create();
   if (s_mutex == NULL) {
     return ESP_FAIL;
   }
 
-  // 创建1秒周期定时器
-  esp_timer_create_args_t timer_args = {.callback = scheduler_timer_callback,
-                                        .arg = NULL,
-                                        .dispatch_method = ESP_TIMER_TASK,
-                                        .name = "scheduler"};
-
-  esp_err_t err = esp_timer_create(&timer_args, &s_timer);
+  // 不再周期轮询: 两个单次定时器分别在倒计时截止和预约时刻触发
+  esp_err_t err =
+      create_timer(countdown_timer_callback, "countdown", &s_countdown_timer);
   if (err != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(err));
     return err;
   }
-
-  // 启动定时器
-  err = esp_timer_start_periodic(s_timer, 1000000); // 1秒
+  err = create_timer(schedule_timer_callback, "schedule", &s_schedule_timer);
   if (err != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to start timer: %s", esp_err_to_name(err));
     return err;
   }
+  sched_heap_init(&s_heap);
+  load_entries();
+  soft_rtc_set_time_callback(schedule_recompute);
+  temp_control_set_preheat_callback(schedule_recompute);
+  // 温度程序完成后关机即结束本次加热，不再保留暂停中的倒计时
+  temp_control_set_power_off_callback(scheduler_stop_timer);
+
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  schedule_arm();
+  os_lock_give(s_mutex);
 
   ESP_LOGI(TAG,
-           "Scheduler initialized. Max heating time: %d min, Preheat: %d min",
+           "Scheduler initialized. Max heating time: %d min, Preheat: %d min "
+           "until learned",
            CONFIG_MAX_HEATING_TIME_MINUTES, CONFIG_PREHEAT_TIME_MINUTES);
 
   return ESP_OK;
@@ -180,42 +474,55 @@ void scheduler_set_timer_duration(int minutes) {
     minutes = CONFIG_MAX_HEATING_TIME_MINUTES;
   }
 
-  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
   s_timer_duration = minutes;
 
   // 如果正在加热，重置倒计时
   if (temp_control_get_power()) {
-    s_timer_seconds = minutes * 60;
-    s_timer_remaining = minutes;
-    s_timer_running = true;
-    s_state = SCHED_STATE_TIMER_RUNNING;
+    countdown_start(minutes);
   }
 
-  xSemaphoreGive(s_mutex);
+  os_lock_give(s_mutex);
   ESP_LOGI(TAG, "Timer duration set to %d minutes", minutes);
 }
 
-int scheduler_get_timer_remaining(void) { return s_timer_remaining; }
+int scheduler_get_timer_remaining(void) {
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  int64_t left_us = 0;
+  if (s_timer_running) {
+    left_us = s_timer_end_us - temp_control_get_on_time_us();
+  }
+  os_lock_give(s_mutex);
 
-void scheduler_set_schedule_time(const char *time_str) {
-  if (time_str == NULL) {
-    return;
+  if (left_us <= 0) {
+    return 0;
   }
+  return (int)((left_us + 60 * 1000000LL - 1) / (60 * 1000000LL)); // 向上取整
+}
 
-  int hour, minute;
-  if (!parse_schedule_time(time_str, &hour, &minute)) {
-    ESP_LOGW(TAG, "Invalid schedule time format: %s", time_str);
+void scheduler_set_schedule_time(const char *time_str) {
+  int minute = scheduler_parse_time(time_str);
+  if (minute < 0) {
+    ESP_LOGW(TAG, "Invalid schedule time format: %s",
+             time_str ? time_str : "(null)");
     return;
   }
 
-  xSemaphoreTake(s_mutex, portMAX_DELAY);
-  snprintf(s_schedule_time, sizeof(s_schedule_time), "%02d:%02d", hour, minute);
-  s_schedule_active = true;
-  s_state = SCHED_STATE_SCHEDULED;
-  xSemaphoreGive(s_mutex);
+  // 单次预约: 沿用当前目标温度和定时时长，只保留一条
+  schedule_entry_t entry = {.minute = (uint16_t)minute};
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  int id = s_oneshot_id >= 0 ? s_oneshot_id : entry_alloc();
+  if (id >= 0) {
+    s_oneshot_id = id;
+    entry_store(id, &entry);
+  }
+  os_lock_give(s_mutex);
 
-  ESP_LOGI(TAG, "Schedule set: %s (will preheat %d min before)",
-           s_schedule_time, CONFIG_PREHEAT_TIME_MINUTES);
+  if (id < 0) {
+    ESP_LOGW(TAG, "No free schedule slot for %s", time_str);
+    return;
+  }
+  ESP_LOGI(TAG, "Schedule set: %02d:%02d", minute / 60, minute % 60);
 }
 
 void scheduler_get_schedule_time(char *buf, int buf_size) {
@@ -223,42 +530,149 @@ void scheduler_get_schedule_time(char *buf, int buf_size) {
     return;
   }
 
-  xSemaphoreTake(s_mutex, portMAX_DELAY);
-  strncpy(buf, s_schedule_time, buf_size - 1);
-  buf[buf_size - 1] = '\0';
-  xSemaphoreGive(s_mutex);
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  int id = sched_heap_peek(&s_heap, NULL);
+  if (id < 0) {
+    id = s_oneshot_id; // 未校时, 堆中还没有启动时刻
+  }
+  int minute = id >= 0 ? s_entries[id].minute : -1;
+  os_lock_give(s_mutex);
+
+  if (minute < 0) {
+    buf[0] = '\0';
+  } else {
+    snprintf(buf, buf_size, "%02d:%02d", minute / 60, minute % 60);
+  }
 }
 
 void scheduler_cancel_schedule(void) {
-  xSemaphoreTake(s_mutex, portMAX_DELAY);
-  s_schedule_active = false;
-  s_schedule_time[0] = '\0';
-  if (s_state == SCHED_STATE_SCHEDULED) {
-    s_state = SCHED_STATE_IDLE;
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  if (s_oneshot_id >= 0) {
+    entry_free(s_oneshot_id);
+    schedule_arm();
   }
-  xSemaphoreGive(s_mutex);
+  os_lock_give(s_mutex);
   ESP_LOGI(TAG, "Schedule cancelled");
 }
 
+esp_err_t scheduler_add_entry(const schedule_entry_t *entry, int *id) {
+  if (entry == NULL || !entry_valid(entry)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  int slot = entry_alloc();
+  if (slot >= 0) {
+    entry_store(slot, entry);
+  }
+  os_lock_give(s_mutex);
+
+  if (slot < 0) {
+    return ESP_ERR_NO_MEM;
+  }
+  if (id != NULL) {
+    *id = slot;
+  }
+  ESP_LOGI(TAG, "Schedule %d added: %02d:%02d days 0x%02x", slot,
+           entry->minute / 60, entry->minute % 60, entry->weekdays);
+  return entry->weekdays != 0 ? save_entries() : ESP_OK;
+}
+
+esp_err_t scheduler_set_entry(int id, const schedule_entry_t *entry) {
+  if (entry == NULL || !entry_valid(entry)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (id < 0 || id >= SCHEDULER_MAX_ENTRIES) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  bool found = s_used & (1u << id);
+  bool persisted = found && s_entries[id].weekdays != 0;
+  if (found) {
+    entry_store(id, entry);
+    // 单次预约槽位改为每周重复后成为普通预约，不再被
+    // scheduler_set_schedule_time() 覆盖或随取消删除
+    if (id == s_oneshot_id && entry->weekdays != 0) {
+      s_oneshot_id = -1;
+    }
+  }
+  os_lock_give(s_mutex);
+
+  if (!found) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  ESP_LOGI(TAG, "Schedule %d updated: %02d:%02d days 0x%02x", id,
+           entry->minute / 60, entry->minute % 60, entry->weekdays);
+  return persisted || entry->weekdays != 0 ? save_entries() : ESP_OK;
+}
+
+esp_err_t scheduler_remove_entry(int id) {
+  if (id < 0 || id >= SCHEDULER_MAX_ENTRIES) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  bool found = s_used & (1u << id);
+  bool persisted = found && s_entries[id].weekdays != 0;
+  if (found) {
+    entry_free(id);
+    schedule_arm();
+  }
+  os_lock_give(s_mutex);
+
+  if (!found) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  ESP_LOGI(TAG, "Schedule %d removed", id);
+  return persisted ? save_entries() : ESP_OK;
+}
+
+esp_err_t scheduler_get_entry(int id, schedule_entry_t *entry,
+                              int32_t *start_in_s) {
+  if (entry == NULL || id < 0 || id >= SCHEDULER_MAX_ENTRIES) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  int64_t now;
+  bool now_ok = now_time(&now);
+
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  bool found = s_used & (1u << id);
+  *entry = s_entries[id];
+  int64_t start = 0;
+  bool scheduled = found && !(s_dirty & (1u << id)) &&
+                   sched_heap_get(&s_heap, id, &start);
+  os_lock_give(s_mutex);
+
+  if (!found) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (start_in_s != NULL) {
+    *start_in_s = -1;
+    if (scheduled && now_ok) {
+      *start_in_s = start > now ? (int32_t)(start - now) : 0;
+    }
+  }
+  return ESP_OK;
+}
+
 void scheduler_start_timer(void) {
-  xSemaphoreTake(s_mutex, portMAX_DELAY);
-  s_timer_running = true;
-  s_timer_seconds = s_timer_duration * 60;
-  s_timer_remaining = s_timer_duration;
-  s_state = SCHED_STATE_TIMER_RUNNING;
-  xSemaphoreGive(s_mutex);
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
+  countdown_start(s_timer_duration);
+  os_lock_give(s_mutex);
   ESP_LOGI(TAG, "Timer started: %d minutes", s_timer_duration);
 }
 
 void scheduler_stop_timer(void) {
-  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  os_lock_take(s_mutex, OS_WAIT_FOREVER);
   s_timer_running = false;
-  s_timer_seconds = 0;
-  s_timer_remaining = 0;
+  s_timer_end_us = 0;
+  os_timer_stop(s_countdown_timer);
   if (s_state == SCHED_STATE_TIMER_RUNNING || s_state == SCHED_STATE_TIMEOUT) {
     s_state = SCHED_STATE_IDLE;
   }
-  xSemaphoreGive(s_mutex);
+  os_lock_give(s_mutex);
   ESP_LOGI(TAG, "Timer stopped");
 }
 
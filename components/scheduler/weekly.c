@@ -0,0 +1,63 @@
+/**
+ * @file weekly.c
+ * @brief 每周重复预约的触发时刻计算实现
+ */
+
+#include "weekly.h"
+
+#define DAYS_2000 730425 // 0000-03-01 起算到 2000-01-01 的天数
+#define WEEKDAY_2000 6   // 2000-01-01 是周六
+
+static int64_t floor_div(int64_t a, int64_t b) {
+  int64_t q = a / b;
+  return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/**
+ * @brief 公历日期到天数 (以3月为年首, 闰日落在年末)
+ */
+static int64_t days_from_civil(int year, int month, int day) {
+  int y = month <= 2 ? year - 1 : year;
+  int m = month <= 2 ? month + 9 : month - 3;
+  int64_t era = floor_div(y, 400);
+  int yoe = (int)(y - era * 400);
+  int doy = (153 * m + 2) / 5 + day - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe;
+}
+
+int64_t weekly_time(int year, int month, int day, int hour, int minute,
+                    int second) {
+  int64_t days = days_from_civil(year, month, day) - DAYS_2000;
+  return days * WEEKLY_SEC_PER_DAY + (int64_t)hour * 3600 + minute * 60 +
+         second;
+}
+
+int weekly_weekday(int64_t t) {
+  int64_t days = floor_div(t, WEEKLY_SEC_PER_DAY);
+  int w = (int)((days + WEEKDAY_2000 - 1) % 7);
+  return (w < 0 ? w + 7 : w) + 1;
+}
+
+int64_t weekly_next_start(uint8_t weekdays, int minute, int32_t lead_s,
+                          int64_t after) {
+  weekdays &= 0x7F;
+  if (weekdays == 0) {
+    weekdays = 0x7F;
+  }
+
+  // 到温时刻不早于 after + lead_s，最多向后找8天
+  int64_t ready_min = after + lead_s;
+  int64_t day = floor_div(ready_min, WEEKLY_SEC_PER_DAY);
+  for (int d = 0; d < 8; d++, day++) {
+    int64_t ready = day * WEEKLY_SEC_PER_DAY + (int64_t)minute * 60;
+    if (ready < ready_min) {
+      continue;
+    }
+    int w = weekly_weekday(ready);
+    if (weekdays & (1u << (w - 1))) {
+      return ready - lead_s;
+    }
+  }
+  return after; // 掩码非空时不会到达
+}
@@ -0,0 +1,98 @@
+/**
+ * @file os_port.h
+ * @brief 时钟、定时器与互斥锁的可替换接口
+ *
+ * soft_rtc.c 和 scheduler.c 只通过本接口使用单调时钟、esp_timer 和
+ * FreeRTOS 互斥锁。设备上由 os_port.c 实现；主机仿真
+ * (tools/sched_sim) 以虚拟时钟实现，可在毫秒级模拟数周的运行并注入锁竞争
+ */
+
+#ifndef OS_PORT_H
+#define OS_PORT_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_WAIT_FOREVER (-1) // os_lock_take 无限等待
+
+typedef struct os_timer *os_timer_t; // 定时器句柄
+typedef struct os_lock *os_lock_t;   // 互斥锁句柄
+
+/**
+ * @brief 单调时钟
+ *
+ * @return int64_t 启动以来的时间 (us)
+ */
+int64_t os_now_us(void);
+
+/**
+ * @brief 创建定时器 (回调在定时器任务中执行)
+ *
+ * @param callback 到期回调
+ * @param arg 回调参数
+ * @param name 名称 (调试用)
+ * @param timer 输出句柄
+ * @return esp_err_t ESP_OK 成功
+ */
+esp_err_t os_timer_create(void (*callback)(void *), void *arg,
+                          const char *name, os_timer_t *timer);
+
+/**
+ * @brief 启动单次定时
+ *
+ * @param timer 定时器句柄 (须未运行)
+ * @param timeout_us 定时时长 (us)
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_STATE 已在运行
+ */
+esp_err_t os_timer_start_once(os_timer_t timer, uint64_t timeout_us);
+
+/**
+ * @brief 启动周期定时
+ *
+ * @param timer 定时器句柄 (须未运行)
+ * @param period_us 周期 (us)
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_STATE 已在运行
+ */
+esp_err_t os_timer_start_periodic(os_timer_t timer, uint64_t period_us);
+
+/**
+ * @brief 停止定时器
+ *
+ * @param timer 定时器句柄
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_STATE 未在运行
+ */
+esp_err_t os_timer_stop(os_timer_t timer);
+
+/**
+ * @brief 创建互斥锁
+ *
+ * @return os_lock_t 句柄, 失败返回 NULL
+ */
+os_lock_t os_lock_create(void);
+
+/**
+ * @brief 获取互斥锁
+ *
+ * @param lock 互斥锁句柄
+ * @param timeout_ms 最长等待时间 (ms), 0 不等待, OS_WAIT_FOREVER 无限等待
+ * @return true 已获取
+ */
+bool os_lock_take(os_lock_t lock, int timeout_ms);
+
+/**
+ * @brief 释放互斥锁
+ *
+ * @param lock 互斥锁句柄
+ */
+void os_lock_give(os_lock_t lock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OS_PORT_H
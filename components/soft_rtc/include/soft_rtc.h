@@ -1,6 +1,6 @@
 /**
  * @file soft_rtc.h
- * @brief 软件RTC模块 - 使用ESP32内部定时器维护系统时间
+ * @brief 软件RTC模块 - 由单调时钟 (esp_timer) 推算系统时间
  */
 
 #ifndef SOFT_RTC_H
@@ -27,10 +27,20 @@ typedef struct {
   int weekday; // 星期 (1-7, 1=周一, 7=周日)
 } rtc_time_t;
 
+#define SOFT_RTC_MAX_TICK_SUBSCRIBERS 4 // 秒节拍最大订阅者数
+
+/**
+ * @brief 秒节拍回调
+ *
+ * @param now 本秒的RTC时间
+ * @param arg 订阅时传入的参数
+ */
+typedef void (*soft_rtc_tick_cb_t)(const rtc_time_t *now, void *arg);
+
 /**
  * @brief 初始化软件RTC
  *
- * 启动1秒周期定时器维护时间
+ * 时间由单调时钟推算，不启动周期定时器
  *
  * @return esp_err_t ESP_OK 成功
  */
@@ -39,11 +49,53 @@ esp_err_t soft_rtc_init(void);
 /**
  * @brief 设置RTC时间
  *
- * @param time 要设置的时间
- * @return esp_err_t ESP_OK 成功
+ * @param time 要设置的时间 (星期超出1-7时按周一)
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_ARG 日期或时间无效,
+ *         ESP_ERR_TIMEOUT 取锁超时
  */
 esp_err_t soft_rtc_set_time(const rtc_time_t *time);
 
+/**
+ * @brief 设置时间修改回调
+ *
+ * soft_rtc_set_time 成功后在调用者上下文中调用 (不持有RTC锁)，
+ * 供按墙上时间装载定时器的模块重新计算触发时刻
+ *
+ * @param callback 回调函数, NULL 取消
+ */
+void soft_rtc_set_time_callback(void (*callback)(void));
+
+/**
+ * @brief 订阅秒节拍
+ *
+ * 全部订阅者由同一个对齐到RTC整秒的定时器在一次回调中依次通知
+ * (定时器任务上下文, 不持有RTC锁)，无订阅者时不唤醒。
+ * 回调因系统繁忙延迟超过1秒时只通知一次当前时间
+ *
+ * @param callback 回调函数
+ * @param arg 回调参数
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_NO_MEM 订阅者已满
+ */
+esp_err_t soft_rtc_subscribe_tick(soft_rtc_tick_cb_t callback, void *arg);
+
+/**
+ * @brief 取消订阅秒节拍
+ *
+ * 正在进行的通知可能在返回后仍调用一次回调
+ *
+ * @param callback 订阅时的回调函数
+ * @param arg 订阅时的回调参数
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_NOT_FOUND 未订阅
+ */
+esp_err_t soft_rtc_unsubscribe_tick(soft_rtc_tick_cb_t callback, void *arg);
+
+/**
+ * @brief 是否已设置过时间
+ * 上电后未同步时日期为默认的 2025-01-01
+ * @return true 已同步
+ */
+bool soft_rtc_is_synced(void);
+
 /**
  * @brief 获取当前RTC时间
  *
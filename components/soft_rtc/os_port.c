@@ -0,0 +1,42 @@
+/**
+ * @file os_port.c
+ * @brief 时钟、定时器与互斥锁接口的 ESP-IDF 实现
+ */
+
+#include "os_port.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+int64_t os_now_us(void) { return esp_timer_get_time(); }
+
+esp_err_t os_timer_create(void (*callback)(void *), void *arg,
+                          const char *name, os_timer_t *timer) {
+  esp_timer_create_args_t timer_args = {.callback = callback,
+                                        .arg = arg,
+                                        .dispatch_method = ESP_TIMER_TASK,
+                                        .name = name};
+  return esp_timer_create(&timer_args, (esp_timer_handle_t *)timer);
+}
+
+esp_err_t os_timer_start_once(os_timer_t timer, uint64_t timeout_us) {
+  return esp_timer_start_once((esp_timer_handle_t)timer, timeout_us);
+}
+
+esp_err_t os_timer_start_periodic(os_timer_t timer, uint64_t period_us) {
+  return esp_timer_start_periodic((esp_timer_handle_t)timer, period_us);
+}
+
+esp_err_t os_timer_stop(os_timer_t timer) {
+  return esp_timer_stop((esp_timer_handle_t)timer);
+}
+
+os_lock_t os_lock_create(void) { return (os_lock_t)xSemaphoreCreateMutex(); }
+
+bool os_lock_take(os_lock_t lock, int timeout_ms) {
+  TickType_t ticks =
+      timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS((uint32_t)timeout_ms);
+  return xSemaphoreTake((SemaphoreHandle_t)lock, ticks) == pdTRUE;
+}
+
+void os_lock_give(os_lock_t lock) { xSemaphoreGive((SemaphoreHandle_t)lock); }
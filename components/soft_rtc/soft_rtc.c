@@ -1,21 +1,35 @@
 /**
  * @file soft_rtc.c
- * @brief 软件RTC模块实现 - 使用esp_timer维护系统时间
+ * @brief 软件RTC模块实现 - 由单调时钟推算系统时间
+ *
+ * 只保存校时时刻的时间和单调时钟读数，读取时按经过的时间推算，
+ * 不需要每秒唤醒，也不会因取锁失败丢秒。有订阅者时由一个对齐到整秒的
+ * 单次定时器在同一次回调中依次通知全部订阅者。
+ * 定时器和互斥锁经由 os_port.h，可在主机上以虚拟时钟运行 (tools/sched_sim)
  */
 
 #include "soft_rtc.h"
 #include "esp_log.h"
-#include "esp_timer.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include "os_port.h"
 #include <stdio.h>
 #include <string.h>
 
 
 static const char *TAG = "SoftRTC";
 
-// 当前时间
-static rtc_time_t s_current_time = {
+#define US_PER_S 1000000LL
+#define SEC_PER_DAY 86400
+
+/**
+ * @brief 秒节拍订阅者
+ */
+typedef struct {
+  soft_rtc_tick_cb_t callback;
+  void *arg;
+} tick_sub_t;
+
+// 时间基准: s_base_us 时刻的时间为 s_base
+static rtc_time_t s_base = {
     .year = 2025,
     .month = 1,
     .day = 1,
@@ -24,12 +38,25 @@ static rtc_time_t s_current_time = {
     .second = 0,
     .weekday = 3 // 2025-01-01 是周三
 };
+static int64_t s_base_days = 0; // s_base 日期距 1970-01-01 的天数
+static int32_t s_base_sod = 0;  // s_base 的当天秒数
+static int64_t s_base_us = 0;   // 校时 (或初始化) 时的单调时钟 (us)
+
+// 是否已通过 soft_rtc_set_time 设置过时间
+static volatile bool s_synced = false;
+
+// 时间修改回调
+static void (*s_time_callback)(void) = NULL;
+
+// 秒节拍订阅者
+static tick_sub_t s_subs[SOFT_RTC_MAX_TICK_SUBSCRIBERS];
+static int s_sub_count = 0;
 
-// 互斥锁保护时间访问
-static SemaphoreHandle_t s_time_mutex = NULL;
+// 互斥锁保护时间基准和订阅者
+static os_lock_t s_time_mutex = NULL;
 
-// 定时器句柄
-static esp_timer_handle_t s_rtc_timer = NULL;
+// 秒节拍定时器 (单次, 每次装载到下一个整秒)
+static os_timer_t s_tick_timer = NULL;
 
 // 星期字符串表
 static const char *s_weekday_en[] = {"",    "Mon", "Tue", "Wed",
@@ -56,122 +83,198 @@ static int days_in_month(int year, int month) {
 }
 
 /**
- * @brief 定时器回调 - 每秒更新时间
+ * @brief 公历日期到 1970-01-01 起的天数
  */
-static void rtc_timer_callback(void *arg) {
-  if (xSemaphoreTake(s_time_mutex, 0) != pdTRUE) {
-    return; // 无法获取锁，跳过本次
-  }
-
-  // 秒进位
-  s_current_time.second++;
-  if (s_current_time.second >= 60) {
-    s_current_time.second = 0;
-    s_current_time.minute++;
-
-    // 分进位
-    if (s_current_time.minute >= 60) {
-      s_current_time.minute = 0;
-      s_current_time.hour++;
-
-      // 时进位
-      if (s_current_time.hour >= 24) {
-        s_current_time.hour = 0;
-        s_current_time.day++;
-
-        // 星期递增
-        s_current_time.weekday++;
-        if (s_current_time.weekday > 7) {
-          s_current_time.weekday = 1;
-        }
-
-        // 日进位
-        if (s_current_time.day >
-            days_in_month(s_current_time.year, s_current_time.month)) {
-          s_current_time.day = 1;
-          s_current_time.month++;
-
-          // 月进位
-          if (s_current_time.month > 12) {
-            s_current_time.month = 1;
-            s_current_time.year++;
-          }
-        }
-      }
-    }
+static int64_t days_from_civil(int year, int month, int day) {
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  int64_t yoe = year - era * 400;
+  int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief 1970-01-01 起的天数到公历日期
+ */
+static void civil_from_days(int64_t days, rtc_time_t *t) {
+  days += 719468;
+  int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  int64_t doe = days - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153; // 从三月起的月份 [0, 11]
+  t->day = (int)(doy - (153 * mp + 2) / 5 + 1);
+  t->month = (int)(mp < 10 ? mp + 3 : mp - 9);
+  t->year = (int)(yoe + era * 400 + (t->month <= 2));
+}
+
+/**
+ * @brief 推算指定单调时钟时刻的时间 (调用者持有 s_time_mutex)
+ *
+ * 星期按校时时给定的星期逐日递增
+ */
+static void time_at(int64_t now_us, rtc_time_t *t) {
+  int64_t total = s_base_sod + (now_us - s_base_us) / US_PER_S;
+  int64_t day_delta = total / SEC_PER_DAY;
+  int32_t sod = (int32_t)(total % SEC_PER_DAY);
+
+  civil_from_days(s_base_days + day_delta, t);
+  t->hour = sod / 3600;
+  t->minute = sod / 60 % 60;
+  t->second = sod % 60;
+  t->weekday = (int)((s_base.weekday - 1 + day_delta) % 7) + 1;
+}
+
+/**
+ * @brief 把秒节拍定时器装载到下一个整秒 (调用者持有 s_time_mutex)
+ */
+static void tick_arm(int64_t now_us) {
+  os_timer_stop(s_tick_timer); // 未运行时返回错误，忽略
+  if (s_sub_count == 0) {
+    return;
   }
+  int64_t delay = US_PER_S - (now_us - s_base_us) % US_PER_S;
+  os_timer_start_once(s_tick_timer, (uint64_t)delay);
+}
 
-  xSemaphoreGive(s_time_mutex);
+/**
+ * @brief 秒节拍: 推算一次时间，在同一次回调中通知全部订阅者
+ *
+ * 订阅者在锁外调用，可直接使用传入的时间而不必再读取RTC
+ */
+static void rtc_tick_callback(void *arg) {
+  tick_sub_t subs[SOFT_RTC_MAX_TICK_SUBSCRIBERS];
+  rtc_time_t now;
+
+  os_lock_take(s_time_mutex, OS_WAIT_FOREVER);
+  int64_t now_us = os_now_us();
+  time_at(now_us, &now);
+  int count = s_sub_count;
+  memcpy(subs, s_subs, sizeof(subs[0]) * (size_t)count);
+  tick_arm(now_us);
+  os_lock_give(s_time_mutex);
+
+  for (int i = 0; i < count; i++) {
+    subs[i].callback(&now, subs[i].arg);
+  }
 }
 
 esp_err_t soft_rtc_init(void) {
   // 创建互斥锁
-  s_time_mutex = xSemaphoreCreateMutex();
+  s_time_mutex = os_lock_create();
   if (s_time_mutex == NULL) {
     ESP_LOGE(TAG, "Failed to create mutex");
     return ESP_FAIL;
   }
 
-  // 创建1秒周期定时器
-  esp_timer_create_args_t timer_args = {.callback = rtc_timer_callback,
-                                        .arg = NULL,
-                                        .dispatch_method = ESP_TIMER_TASK,
-                                        .name = "soft_rtc"};
-
-  esp_err_t err = esp_timer_create(&timer_args, &s_rtc_timer);
+  // 秒节拍定时器只在有订阅者时装载
+  esp_err_t err =
+      os_timer_create(rtc_tick_callback, NULL, "soft_rtc", &s_tick_timer);
   if (err != ESP_OK) {
     ESP_LOGE(TAG, "Failed to create timer: %s", esp_err_to_name(err));
     return err;
   }
 
-  // 启动定时器 (1秒 = 1000000微秒)
-  err = esp_timer_start_periodic(s_rtc_timer, 1000000);
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to start timer: %s", esp_err_to_name(err));
-    return err;
-  }
+  s_base_days = days_from_civil(s_base.year, s_base.month, s_base.day);
+  s_base_sod = 0;
+  s_base_us = os_now_us();
 
   ESP_LOGI(TAG, "Soft RTC initialized");
   return ESP_OK;
 }
 
 esp_err_t soft_rtc_set_time(const rtc_time_t *time) {
-  if (time == NULL) {
+  if (time == NULL || time->month < 1 || time->month > 12 || time->day < 1 ||
+      time->day > days_in_month(time->year, time->month) || time->hour < 0 ||
+      time->hour > 23 || time->minute < 0 || time->minute > 59 ||
+      time->second < 0 || time->second > 59) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (xSemaphoreTake(s_time_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+  if (!os_lock_take(s_time_mutex, 100)) {
     return ESP_ERR_TIMEOUT;
   }
 
-  memcpy(&s_current_time, time, sizeof(rtc_time_t));
+  memcpy(&s_base, time, sizeof(rtc_time_t));
 
   // 验证并修正星期范围
-  if (s_current_time.weekday < 1 || s_current_time.weekday > 7) {
-    s_current_time.weekday = 1;
+  if (s_base.weekday < 1 || s_base.weekday > 7) {
+    s_base.weekday = 1;
   }
+  s_base_days = days_from_civil(s_base.year, s_base.month, s_base.day);
+  s_base_sod = s_base.hour * 3600 + s_base.minute * 60 + s_base.second;
+  s_base_us = os_now_us();
+  tick_arm(s_base_us); // 整秒的相位随校时改变
 
-  xSemaphoreGive(s_time_mutex);
+  s_synced = true;
+  os_lock_give(s_time_mutex);
 
   ESP_LOGI(TAG, "Time set: %04d-%02d-%02d %02d:%02d:%02d (weekday=%d)",
            time->year, time->month, time->day, time->hour, time->minute,
            time->second, time->weekday);
 
+  if (s_time_callback) {
+    s_time_callback();
+  }
   return ESP_OK;
 }
 
+void soft_rtc_set_time_callback(void (*callback)(void)) {
+  s_time_callback = callback;
+}
+
+esp_err_t soft_rtc_subscribe_tick(soft_rtc_tick_cb_t callback, void *arg) {
+  if (callback == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  os_lock_take(s_time_mutex, OS_WAIT_FOREVER);
+  esp_err_t err = ESP_ERR_NO_MEM;
+  if (s_sub_count < SOFT_RTC_MAX_TICK_SUBSCRIBERS) {
+    s_subs[s_sub_count].callback = callback;
+    s_subs[s_sub_count].arg = arg;
+    s_sub_count++;
+    if (s_sub_count == 1) {
+      tick_arm(os_now_us());
+    }
+    err = ESP_OK;
+  }
+  os_lock_give(s_time_mutex);
+  return err;
+}
+
+esp_err_t soft_rtc_unsubscribe_tick(soft_rtc_tick_cb_t callback, void *arg) {
+  os_lock_take(s_time_mutex, OS_WAIT_FOREVER);
+  esp_err_t err = ESP_ERR_NOT_FOUND;
+  for (int i = 0; i < s_sub_count; i++) {
+    if (s_subs[i].callback == callback && s_subs[i].arg == arg) {
+      s_subs[i] = s_subs[--s_sub_count];
+      if (s_sub_count == 0) {
+        os_timer_stop(s_tick_timer); // 无订阅者时不再唤醒
+      }
+      err = ESP_OK;
+      break;
+    }
+  }
+  os_lock_give(s_time_mutex);
+  return err;
+}
+
+bool soft_rtc_is_synced(void) { return s_synced; }
+
 esp_err_t soft_rtc_get_time(rtc_time_t *time) {
   if (time == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (xSemaphoreTake(s_time_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+  if (!os_lock_take(s_time_mutex, 100)) {
     return ESP_ERR_TIMEOUT;
   }
 
-  memcpy(time, &s_current_time, sizeof(rtc_time_t));
+  time_at(os_now_us(), time);
 
-  xSemaphoreGive(s_time_mutex);
+  os_lock_give(s_time_mutex);
   return ESP_OK;
 }
 
@@ -181,7 +284,10 @@ void soft_rtc_get_time_string(char *buf, int buf_size, int format) {
   }
 
   rtc_time_t t;
-  soft_rtc_get_time(&t);
+  if (soft_rtc_get_time(&t) != ESP_OK) {
+    buf[0] = '\0'; // 取锁超时, 不输出未初始化的时间
+    return;
+  }
 
   switch (format) {
   case 0: // HH:MM
@@ -0,0 +1,112 @@
+/**
+ * @file ambient.c
+ * @brief 环境温度估计与散热前馈实现
+ */
+
+#include "ambient.h"
+#include <math.h>
+
+void ambient_default_config(ambient_config_t *cfg) {
+  // ESP32-C3 开启WiFi时芯片温度通常比环境高数°C, 标定后以实测为准
+  cfg->offset = 8.0f;
+  cfg->filter_tau = 60.0f;
+  // 与 eco.c 相同: 2分钟内读数基本稳定即视为热平衡
+  cfg->window = 120.0f;
+  cfg->max_drift = 0.3f;
+  cfg->min_excess = 5.0f;
+  cfg->alpha = 0.3f;
+}
+
+static void window_restart(ambient_t *a, float temp) {
+  a->win_elapsed = 0.0f;
+  a->win_duty_sum = 0.0f;
+  a->win_temp_sum = 0.0f;
+  a->win_start = temp;
+}
+
+void ambient_init(ambient_t *a, const ambient_config_t *cfg) {
+  a->cfg = *cfg;
+  a->offset = cfg->offset;
+  a->calibrated = false;
+  a->chip = 0.0f;
+  a->has_chip = false;
+  a->ambient = 0.0f;
+  a->loss = 0.0f;
+  a->loss_count = 0;
+  window_restart(a, 0.0f);
+}
+
+void ambient_update(ambient_t *a, float chip, float dt) {
+  if (!a->has_chip) {
+    a->chip = chip;
+    a->has_chip = true;
+  } else if (dt > 0.0f) {
+    a->chip += dt / (a->cfg.filter_tau + dt) * (chip - a->chip);
+  }
+  a->ambient = a->chip - a->offset;
+}
+
+void ambient_calibrate(ambient_t *a, float reference) {
+  if (!a->has_chip) {
+    return;
+  }
+  a->offset = a->chip - reference;
+  a->calibrated = true;
+  a->ambient = reference;
+}
+
+void ambient_restore(ambient_t *a, bool calibrated, float offset,
+                     float loss) {
+  if (calibrated) {
+    a->offset = offset;
+    a->calibrated = true;
+  }
+  if (loss > 0.0f) {
+    a->loss = loss;
+    a->loss_count = 1;
+  }
+  if (a->has_chip) {
+    a->ambient = a->chip - a->offset;
+  }
+}
+
+bool ambient_valid(const ambient_t *a) { return a->has_chip; }
+
+void ambient_learn(ambient_t *a, float temp, float duty, float dt) {
+  const ambient_config_t *cfg = &a->cfg;
+  if (dt <= 0.0f || !a->has_chip) {
+    window_restart(a, temp);
+    return;
+  }
+
+  a->win_elapsed += dt;
+  a->win_duty_sum += duty * dt;
+  a->win_temp_sum += temp * dt;
+  if (a->win_elapsed < cfg->window) {
+    return;
+  }
+
+  // 读数稳定时加热功率与散热功率平衡 (与控制误差无关)
+  float avg_temp = a->win_temp_sum / a->win_elapsed;
+  float avg_duty = a->win_duty_sum / a->win_elapsed;
+  float excess = avg_temp - a->ambient;
+  if (fabsf(temp - a->win_start) <= cfg->max_drift &&
+      excess >= cfg->min_excess) {
+    float loss = avg_duty / excess;
+    if (a->loss_count == 0) {
+      a->loss = loss;
+    } else {
+      a->loss += cfg->alpha * (loss - a->loss);
+    }
+    a->loss_count++;
+  }
+  window_restart(a, temp);
+}
+
+float ambient_ff_duty(const ambient_t *a, float setpoint) {
+  if (a->loss <= 0.0f || !a->has_chip) {
+    return -1.0f;
+  }
+  float duty = a->loss * (setpoint - a->ambient);
+  return duty > 0.0f ? duty : 0.0f;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file autotune.c
+ * @brief 继电反馈PID自整定实现
+ */
+
+#include "autotune.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define AUTOTUNE_CYCLES 3          // 有效振荡周期数
+#define AUTOTUNE_TIMEOUT_S 3600.0f // 超时 (含从室温升温)
+
+void autotune_start(autotune_t *at, float setpoint, float output_low,
+                    float output_high, float hysteresis) {
+  at->state = AUTOTUNE_RUNNING;
+
+  at->setpoint = setpoint;
+  at->hysteresis = hysteresis;
+  at->output_high = output_high;
+  at->output_low = output_low;
+  at->cycles_target = AUTOTUNE_CYCLES;
+  at->timeout = AUTOTUNE_TIMEOUT_S;
+
+  at->relay_high = true;
+  at->elapsed = 0.0f;
+  at->cycle_start = -1.0f;
+  at->cycle_max = setpoint;
+  at->cycle_min = setpoint;
+  at->cycles = 0;
+
+  at->period_sum = 0.0f;
+  at->amplitude_sum = 0.0f;
+
+  at->ku = 0.0f;
+  at->pu = 0.0f;
+}
+
+float autotune_update(autotune_t *at, float measurement, float dt) {
+  if (at->state != AUTOTUNE_RUNNING) {
+    return at->output_low;
+  }
+
+  at->elapsed += dt;
+  if (at->elapsed > at->timeout) {
+    at->state = AUTOTUNE_FAILED;
+    return at->output_low;
+  }
+
+  // 记录本周期极值
+  if (measurement > at->cycle_max) {
+    at->cycle_max = measurement;
+  }
+  if (measurement < at->cycle_min) {
+    at->cycle_min = measurement;
+  }
+
+  if (at->relay_high && measurement > at->setpoint + at->hysteresis) {
+    // 上穿: 切换到低输出
+    at->relay_high = false;
+  } else if (!at->relay_high &&
+             measurement < at->setpoint - at->hysteresis) {
+    // 下穿: 切换到高输出，一个完整周期结束
+    at->relay_high = true;
+
+    if (at->cycle_start >= 0.0f) {
+      at->cycles++;
+      // 首周期受升温过程影响，丢弃
+      if (at->cycles > 1) {
+        at->period_sum += at->elapsed - at->cycle_start;
+        at->amplitude_sum += (at->cycle_max - at->cycle_min) / 2.0f;
+      }
+    }
+    at->cycle_start = at->elapsed;
+    at->cycle_max = measurement;
+    at->cycle_min = measurement;
+
+    if (at->cycles > at->cycles_target) {
+      float a = at->amplitude_sum / (float)at->cycles_target;
+      float d = (at->output_high - at->output_low) / 2.0f;
+
+      // 描述函数法 (带回差修正): Ku = 4d / (pi * sqrt(a^2 - h^2))
+      float a_eff = a * a - at->hysteresis * at->hysteresis;
+      if (a_eff <= 0.0f) {
+        at->state = AUTOTUNE_FAILED;
+        return at->output_low;
+      }
+      at->ku = 4.0f * d / ((float)M_PI * sqrtf(a_eff));
+      at->pu = at->period_sum / (float)at->cycles_target;
+      at->state = AUTOTUNE_DONE;
+      return at->output_low;
+    }
+  }
+
+  return at->relay_high ? at->output_high : at->output_low;
+}
+
+void autotune_cancel(autotune_t *at) {
+  if (at->state == AUTOTUNE_RUNNING) {
+    at->state = AUTOTUNE_IDLE;
+  }
+}
+
+bool autotune_get_gains(const autotune_t *at, float period, float *kp,
+                        float *ki, float *kd) {
+  if (at->state != AUTOTUNE_DONE || period <= 0.0f) {
+    return false;
+  }
+
+  // Ziegler–Nichols 无超调整定，适合热惯性大的对象
+  float k = 0.2f * at->ku;
+  float ti = at->pu / 2.0f;
+  float td = at->pu / 3.0f;
+
+  // 换算为每控制步参数 (积分按步累加, 微分按步差分)
+  *kp = k;
+  *ki = k * period / ti;
+  *kd = k * td / period;
+  return true;
+}
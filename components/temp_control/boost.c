@@ -0,0 +1,125 @@
+/**
+ * @file boost.c
+ * @brief 全功率升温 + PID 混合加热策略实现
+ */
+
+#include "boost.h"
+
+#define SLOPE_ALPHA 0.5f   // 升温速率指数平均系数
+#define FIT_SKIP 2         // 传感器滞后期内的速率不参与拟合
+#define FIT_MIN_POINTS 3   // 估算保温占空比所需的最少拟合点数
+#define FIT_MIN_RATE 0.01f // 满功率速率低于此值时不估算 (°C/s)
+
+void boost_default_config(boost_config_t *cfg) {
+  cfg->min_step = 5.0f;
+  cfg->margin = 0.25f;
+  // NTC热响应约3s; 切换时预置的保温占空比已抵消加热板余热，
+  // 提前量再大反而因PID积分在剩余误差上累加而超调 (见 thermal_sim)
+  cfg->lead = 3.0f;
+  cfg->slope_interval = 4.0f;
+}
+
+void boost_init(boost_t *b, const boost_config_t *cfg) {
+  b->cfg = *cfg;
+  b->target = 0.0f;
+  boost_cancel(b);
+}
+
+bool boost_start(boost_t *b, float temp, float target) {
+  boost_cancel(b);
+  b->target = target;
+  b->start_temp = temp;
+  b->slope_ref = temp;
+  b->active = target - temp > b->cfg.min_step;
+  return b->active;
+}
+
+void boost_cancel(boost_t *b) {
+  b->active = false;
+  b->hold_duty = -1.0f;
+  b->start_temp = 0.0f;
+  b->slope = 0.0f;
+  b->slope_count = 0;
+  b->slope_ref = 0.0f;
+  b->slope_elapsed = 0.0f;
+  b->fit_n = 0;
+  b->fit_sx = 0.0f;
+  b->fit_sy = 0.0f;
+  b->fit_sxx = 0.0f;
+  b->fit_sxy = 0.0f;
+}
+
+/**
+ * @brief 由速率-温度拟合估算维持目标温度的占空比
+ *
+ * @return float 占空比 (%), 拟合不可用时返回 -1
+ */
+static float fit_hold_duty(const boost_t *b) {
+  float n = (float)b->fit_n;
+  float det = n * b->fit_sxx - b->fit_sx * b->fit_sx;
+  if (b->fit_n < FIT_MIN_POINTS || det <= 0.0f) {
+    return -1.0f;
+  }
+  // r = r0 - k * x, x 为相对起始温度的温升
+  float slope = (n * b->fit_sxy - b->fit_sx * b->fit_sy) / det;
+  float r0 = (b->fit_sy - slope * b->fit_sx) / n;
+  float k = -slope;
+  if (r0 < FIT_MIN_RATE || k <= 0.0f) {
+    return -1.0f;
+  }
+
+  float hold = k * (b->target - b->start_temp) / r0;
+  if (hold > 1.0f) {
+    hold = 1.0f;
+  }
+  return hold * 100.0f;
+}
+
+bool boost_update(boost_t *b, float temp, float dt) {
+  if (!b->active) {
+    return false;
+  }
+  const boost_config_t *cfg = &b->cfg;
+
+  if (dt > 0.0f) {
+    b->slope_elapsed += dt;
+    if (b->slope_elapsed >= cfg->slope_interval) {
+      float slope = (temp - b->slope_ref) / b->slope_elapsed;
+      if (b->slope_count == 0) {
+        b->slope = slope;
+      } else {
+        b->slope += SLOPE_ALPHA * (slope - b->slope);
+      }
+      if (b->slope_count >= FIT_SKIP) {
+        float x = 0.5f * (temp + b->slope_ref) - b->start_temp;
+        b->fit_n++;
+        b->fit_sx += x;
+        b->fit_sy += slope;
+        b->fit_sxx += x * x;
+        b->fit_sxy += x * slope;
+      }
+      b->slope_count++;
+      b->slope_ref = temp;
+      b->slope_elapsed = 0.0f;
+    }
+  }
+
+  float predicted = temp;
+  if (b->slope > 0.0f) {
+    predicted += b->slope * cfg->lead;
+  }
+  if (predicted < b->target - cfg->margin) {
+    return false;
+  }
+
+  b->active = false;
+  b->hold_duty = fit_hold_duty(b);
+  return true;
+}
+
+float boost_preload_duty(const boost_t *b, float cap_percent) {
+  if (b->hold_duty < 0.0f) {
+    return -1.0f;
+  }
+  return b->hold_duty * cap_percent / 100.0f;
+}
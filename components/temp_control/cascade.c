@@ -0,0 +1,169 @@
+/**
+ * @file cascade.c
+ * @brief 级联控温实现
+ */
+
+#include "cascade.h"
+#include <math.h>
+
+#define P_CUP_INIT 100.0f   // 杯温初始方差 (°C^2), 放上的杯子温度未知
+#define ETA_STEP_S 10       // 到温预测的积分步长 (s)
+#define ETA_HORIZON_S 14400 // 到温预测的最长时间 (s)
+
+void cascade_default_config(cascade_config_t *cfg) {
+  // 与 tools/thermal_sim/plant.c 的默认热模型一致
+  cfg->heater_w = 15.0f;
+  cfg->plate_c = 60.0f;
+  cfg->cup_c = 1200.0f;
+  cfg->g_plate_amb = 0.08f;
+  cfg->g_plate_cup = 0.5f;
+  cfg->g_cup_amb = 0.15f;
+  cfg->q_plate = 0.01f;
+  cfg->q_cup = 0.0005f;
+  cfg->r = 0.01f;
+  cfg->kp = 2.0f;
+  cfg->ki = 0.002f;
+  cfg->i_band = 3.0f;
+  cfg->plate_max = 80.0f;
+}
+
+void cascade_init(cascade_t *c, const cascade_config_t *cfg) {
+  c->cfg = *cfg;
+  c->plate = 0.0f;
+  c->cup = 0.0f;
+  c->p[0][0] = c->p[0][1] = c->p[1][0] = c->p[1][1] = 0.0f;
+  c->plate_sp = 0.0f;
+  cascade_reset(c);
+}
+
+void cascade_reset(cascade_t *c) {
+  c->has_state = false;
+  c->integral = 0.0f;
+}
+
+void cascade_observe(cascade_t *c, float plate, float duty, float ambient,
+                     float dt) {
+  const cascade_config_t *cfg = &c->cfg;
+  if (!c->has_state) {
+    c->plate = plate;
+    c->cup = plate;
+    c->p[0][0] = cfg->r;
+    c->p[0][1] = c->p[1][0] = 0.0f;
+    c->p[1][1] = P_CUP_INIT;
+    c->has_state = true;
+    return;
+  }
+
+  if (dt > 0.0f) {
+    // 预测 (欧拉离散, 步长远小于加热板时间常数)
+    float q_heat = cfg->heater_w * duty / 100.0f;
+    float q_pa = cfg->g_plate_amb * (c->plate - ambient);
+    float q_pc = cfg->g_plate_cup * (c->plate - c->cup);
+    float q_ca = cfg->g_cup_amb * (c->cup - ambient);
+    c->plate += (q_heat - q_pa - q_pc) / cfg->plate_c * dt;
+    c->cup += (q_pc - q_ca) / cfg->cup_c * dt;
+
+    // P = F*P*F' + Q*dt
+    const float g_plate = cfg->g_plate_amb + cfg->g_plate_cup;
+    const float g_cup = cfg->g_plate_cup + cfg->g_cup_amb;
+    float f00 = 1.0f - g_plate / cfg->plate_c * dt;
+    float f01 = cfg->g_plate_cup / cfg->plate_c * dt;
+    float f10 = cfg->g_plate_cup / cfg->cup_c * dt;
+    float f11 = 1.0f - g_cup / cfg->cup_c * dt;
+    float a00 = f00 * c->p[0][0] + f01 * c->p[1][0];
+    float a01 = f00 * c->p[0][1] + f01 * c->p[1][1];
+    float a10 = f10 * c->p[0][0] + f11 * c->p[1][0];
+    float a11 = f10 * c->p[0][1] + f11 * c->p[1][1];
+    c->p[0][0] = a00 * f00 + a01 * f01 + cfg->q_plate * dt;
+    c->p[0][1] = a00 * f10 + a01 * f11;
+    c->p[1][0] = c->p[0][1];
+    c->p[1][1] = a10 * f10 + a11 * f11 + cfg->q_cup * dt;
+  }
+
+  // 校正: 只测量加热板温度, 杯温通过协方差获得修正
+  float s = c->p[0][0] + cfg->r;
+  float k0 = c->p[0][0] / s;
+  float k1 = c->p[1][0] / s;
+  float e = plate - c->plate;
+  c->plate += k0 * e;
+  c->cup += k1 * e;
+  float p00 = c->p[0][0];
+  float p01 = c->p[0][1];
+  c->p[0][0] -= k0 * p00;
+  c->p[0][1] -= k0 * p01;
+  c->p[1][0] = c->p[0][1];
+  c->p[1][1] -= k1 * p01;
+}
+
+/**
+ * @brief 杯温维持在 target 时加热板的稳态温度
+ */
+static float plate_steady(const cascade_config_t *cfg, float target,
+                          float ambient) {
+  return target + cfg->g_cup_amb / cfg->g_plate_cup * (target - ambient);
+}
+
+static float clamp_sp(const cascade_config_t *cfg, float sp, float ambient) {
+  if (sp > cfg->plate_max) {
+    return cfg->plate_max;
+  }
+  return sp < ambient ? ambient : sp;
+}
+
+float cascade_update(cascade_t *c, float target, float ambient, float dt) {
+  const cascade_config_t *cfg = &c->cfg;
+  float err = target - c->cup;
+  float base = plate_steady(cfg, target, ambient) + cfg->kp * err;
+  float sp = base + c->integral;
+
+  // 接近目标才积分 (升温段不积累); 设定值饱和时不再向饱和方向积分
+  if (dt > 0.0f && fabsf(err) < cfg->i_band) {
+    bool high = sp >= cfg->plate_max && err > 0.0f;
+    bool low = sp <= ambient && err < 0.0f;
+    if (!high && !low) {
+      c->integral += cfg->ki * err * dt;
+      sp = base + c->integral;
+    }
+  }
+
+  c->plate_sp = clamp_sp(cfg, sp, ambient);
+  return c->plate_sp;
+}
+
+float cascade_time_to_target(const cascade_t *c, float target, float ambient,
+                             float max_duty) {
+  const cascade_config_t *cfg = &c->cfg;
+  if (!c->has_state) {
+    return -1.0f;
+  }
+  if (c->cup >= target) {
+    return 0.0f;
+  }
+
+  float plate = c->plate;
+  float cup = c->cup;
+  const float q_max = cfg->heater_w * max_duty / 100.0f;
+  const float step = (float)ETA_STEP_S;
+  for (int t = ETA_STEP_S; t <= ETA_HORIZON_S; t += ETA_STEP_S) {
+    float sp = clamp_sp(
+        cfg, plate_steady(cfg, target, ambient) + cfg->kp * (target - cup),
+        ambient);
+    float q_pc = cfg->g_plate_cup * (plate - cup);
+    float q_ca = cfg->g_cup_amb * (cup - ambient);
+    if (plate < sp) {
+      // 满功率升温，不超过设定值
+      float q_pa = cfg->g_plate_amb * (plate - ambient);
+      plate += (q_max - q_pa - q_pc) / cfg->plate_c * step;
+      if (plate > sp) {
+        plate = sp;
+      }
+    } else {
+      plate = sp;
+    }
+    cup += (q_pc - q_ca) / cfg->cup_c * step;
+    if (cup >= target) {
+      return (float)t;
+    }
+  }
+  return -1.0f;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file drive.c
+ * @brief 加热器驱动级实现
+ */
+
+#include "drive.h"
+
+#define US_PER_S 1000000ull
+#define FRAC_ONE (1u << DRIVE_FRAC_BITS)
+#define FRAC_MASK (FRAC_ONE - 1)
+
+static uint32_t min_u32(uint32_t a, uint32_t b) { return a < b ? a : b; }
+
+void drive_config_percent(drive_config_t *cfg, uint32_t full, int cap_percent,
+                          int slew_pct_s, int backoff_percent) {
+  cfg->full = full;
+  cfg->cap = full * (uint32_t)cap_percent / 100;
+  cfg->slew = full * (uint32_t)slew_pct_s / 100;
+  cfg->backoff = full * (uint32_t)backoff_percent / 100;
+}
+
+void drive_init(drive_t *d, const drive_config_t *cfg) {
+  d->cfg = *cfg;
+  d->cfg.cap = min_u32(cfg->cap, cfg->full);
+  d->cfg.backoff = min_u32(cfg->backoff, cfg->full);
+  d->request = 0;
+  d->limit = 0;
+  d->output = 0;
+  d->carry = 0;
+  d->sigma = 0;
+}
+
+uint32_t drive_update(drive_t *d, uint32_t request, bool tx, uint32_t dt_us) {
+  const drive_config_t *cfg = &d->cfg;
+
+  // 上次已到达目标: 没有在爬升, 之前的时间不能攒成一次阶跃
+  if (d->output >= d->limit) {
+    dt_us = 0;
+    d->carry = 0;
+  }
+
+  uint32_t limit = min_u32(request, cfg->cap);
+  if (tx) {
+    limit = min_u32(limit, cfg->backoff);
+  }
+  d->request = request;
+  d->limit = limit;
+
+  if (limit <= d->output || cfg->slew == 0) {
+    d->output = limit;
+    d->carry = 0;
+    return d->output;
+  }
+
+  d->carry += (uint64_t)cfg->slew * dt_us;
+  uint64_t step = d->carry / US_PER_S;
+  d->carry -= step * US_PER_S;
+  if (step >= limit - d->output) {
+    d->output = limit;
+    d->carry = 0;
+  } else {
+    d->output += (uint32_t)step;
+  }
+  return d->output;
+}
+
+uint32_t drive_pwm(drive_t *d, bool dither) {
+  uint32_t count = d->output >> DRIVE_FRAC_BITS;
+  uint32_t frac = d->output & FRAC_MASK;
+  if (!dither) {
+    return count + (frac >= FRAC_ONE / 2 ? 1 : 0);
+  }
+
+  // 一阶sigma-delta: 累计误差满1个计数时本周期多输出1
+  d->sigma += frac;
+  if (d->sigma >= FRAC_ONE) {
+    d->sigma -= FRAC_ONE;
+    count++;
+  }
+  return count;
+}
+
+bool drive_fractional(const drive_t *d) { return (d->output & FRAC_MASK) != 0; }
+
+bool drive_settled(const drive_t *d) { return d->output >= d->limit; }
@@ -0,0 +1,141 @@
+/**
+ * @file eco.c
+ * @brief 节能保温策略实现
+ */
+
+#include "eco.h"
+#include <math.h>
+
+#define LOSS_ALPHA 0.3f      // 散热模型指数平均系数
+#define LOSS_MIN_EXCESS 5.0f // 高于环境温度不足此值时不学习 (°C)
+#define MARGIN_UP 0.1f       // 读数跌出保温带时余量增加 (°C)
+#define MARGIN_DOWN 0.05f    // 最低读数离下沿较远时余量减少 (°C)
+#define MARGIN_SLACK 0.3f    // 最低读数高于下沿超过此值时减少余量 (°C)
+
+void eco_default_config(eco_config_t *cfg) {
+  cfg->band = 3.0f;
+  cfg->reach = 0.5f;
+  cfg->margin = 0.5f;
+  cfg->margin_min = 0.2f;
+  cfg->margin_max = 2.0f;
+  // 杯垫+杯子时间常数约10分钟，2分钟内读数基本稳定即可视为热平衡
+  cfg->window = 120.0f;
+  cfg->max_drift = 0.3f;
+}
+
+void eco_init(eco_t *e, const eco_config_t *cfg) {
+  e->cfg = *cfg;
+  e->margin = cfg->margin;
+  e->loss = 0.0f;
+  e->loss_count = 0;
+  e->banked = 0.0;
+  e->hold_saved = 0.0f;
+  e->target = 0.0f;
+  eco_reset(e);
+}
+
+static void window_restart(eco_t *e, float temp) {
+  e->win_elapsed = 0.0f;
+  e->win_duty_sum = 0.0f;
+  e->win_temp_sum = 0.0f;
+  e->win_start = temp;
+  e->win_min = temp;
+}
+
+void eco_reset(eco_t *e) {
+  e->banked += e->hold_saved;
+  e->hold_saved = 0.0f;
+  e->holding = false;
+  e->setpoint = e->target;
+  window_restart(e, 0.0f);
+}
+
+/**
+ * @brief 窗口结束: 学习散热模型、累计节省量并调整余量
+ *
+ * 杯子升温期间 (时间常数约半小时) 散热系数明显偏大且逐渐下降，
+ * 因此每个窗口按本窗口测得的系数估算普通PID的占空比；
+ * 读数不稳定的窗口 (到温后的降温) 使用此前学得的系数
+ */
+static void window_finish(eco_t *e, float temp, float ambient) {
+  const eco_config_t *cfg = &e->cfg;
+  float avg_temp = e->win_temp_sum / e->win_elapsed;
+  float avg_duty = e->win_duty_sum / e->win_elapsed;
+
+  // 读数稳定时加热功率与散热功率平衡
+  bool steady = fabsf(temp - e->win_start) <= cfg->max_drift;
+  float loss = e->loss;
+  if (steady && avg_temp - ambient >= LOSS_MIN_EXCESS) {
+    loss = avg_duty / (avg_temp - ambient);
+    if (e->loss_count == 0) {
+      e->loss = loss;
+    } else {
+      e->loss += LOSS_ALPHA * (loss - e->loss);
+    }
+    e->loss_count++;
+  }
+  if (loss > 0.0f) {
+    float baseline = loss * (e->target - ambient);
+    e->hold_saved += (baseline - avg_duty) * e->win_elapsed;
+  }
+
+  float lower = e->target - cfg->band;
+  if (e->win_min < lower) {
+    e->margin += MARGIN_UP;
+  } else if (steady && e->win_min > lower + MARGIN_SLACK) {
+    // 到温后的降温过程不算，稳定后的最低读数仍离下沿较远
+    e->margin -= MARGIN_DOWN;
+  }
+  if (e->margin < cfg->margin_min) {
+    e->margin = cfg->margin_min;
+  } else if (e->margin > cfg->margin_max) {
+    e->margin = cfg->margin_max;
+  }
+
+  window_restart(e, temp);
+}
+
+float eco_update(eco_t *e, float temp, float target, float duty,
+                 float ambient, float dt) {
+  const eco_config_t *cfg = &e->cfg;
+
+  if (target != e->target) {
+    e->target = target;
+    eco_reset(e);
+  }
+
+  if (!e->holding) {
+    if (temp < target - cfg->reach) {
+      e->setpoint = target;
+      return e->setpoint;
+    }
+    e->holding = true;
+    window_restart(e, temp);
+  } else if (dt > 0.0f) {
+    e->win_elapsed += dt;
+    e->win_duty_sum += duty * dt;
+    e->win_temp_sum += temp * dt;
+    if (temp < e->win_min) {
+      e->win_min = temp;
+    }
+    if (e->win_elapsed >= cfg->window) {
+      window_finish(e, temp, ambient);
+    }
+  }
+
+  float setpoint = target - cfg->band + e->margin;
+  e->setpoint = setpoint < target ? setpoint : target;
+  return e->setpoint;
+}
+
+float eco_hold_duty(const eco_t *e, float temp, float ambient) {
+  if (e->loss <= 0.0f) {
+    return -1.0f;
+  }
+  float duty = e->loss * (temp - ambient);
+  return duty > 0.0f ? duty : 0.0f;
+}
+
+float eco_saved_duty_s(const eco_t *e) {
+  return (float)(e->banked + e->hold_saved);
+}
@@ -0,0 +1,235 @@
+/**
+ * @file fopdt.c
+ * @brief 一阶加纯滞后热模型在线辨识实现
+ */
+
+#include "fopdt.h"
+#include <math.h>
+#include <string.h>
+
+#define Y_REF 25.0f        // 温度偏置 (°C), 改善回归量数值条件
+#define P_INIT 100.0f      // 协方差初值 (弱先验)
+#define A_INIT 0.98f       // a 的先验 (Ts=5s 时 tau 约 250s)
+#define ERR_ALPHA 0.05f    // 预测误差指数平均系数
+#define BEST_MIN_UPDATES 8 // 参与死区选择所需的最少更新次数
+#define IDLE_DY 0.05f      // 稳态判定: 样本间温度变化 (°C)
+#define IDLE_DU 0.02f      // 稳态判定: 样本间占空比变化 (0-1)
+#define TAU_MAX 7200.0f    // 超过此时间常数视为未辨识 (s)
+#define GAIN_MAX 1000.0f   // 超过此稳态增益视为未辨识 (°C)
+
+static void rls_init(fopdt_rls_t *r) {
+  memset(r, 0, sizeof(*r));
+  r->theta[0] = A_INIT;
+  for (int i = 0; i < 3; i++) {
+    r->p[i][i] = P_INIT;
+  }
+}
+
+/**
+ * @brief RLS单步更新
+ *
+ * 协方差迹超过上限时遗忘因子取1，避免恒定占空比 (无激励) 下协方差发散
+ */
+static void rls_update(fopdt_rls_t *r, const float phi[3], float y,
+                       float lambda, float p_max) {
+  float pphi[3];
+  for (int i = 0; i < 3; i++) {
+    pphi[i] = r->p[i][0] * phi[0] + r->p[i][1] * phi[1] + r->p[i][2] * phi[2];
+  }
+
+  float trace = r->p[0][0] + r->p[1][1] + r->p[2][2];
+  float lam = trace > p_max ? 1.0f : lambda;
+  float denom = lam + phi[0] * pphi[0] + phi[1] * pphi[1] + phi[2] * pphi[2];
+  float e =
+      y - (r->theta[0] * phi[0] + r->theta[1] * phi[1] + r->theta[2] * phi[2]);
+
+  for (int i = 0; i < 3; i++) {
+    float k = pphi[i] / denom;
+    r->theta[i] += k * e;
+    for (int j = 0; j < 3; j++) {
+      r->p[i][j] = (r->p[i][j] - k * pphi[j]) / lam;
+    }
+  }
+
+  // 先验误差: 反映模型对新数据的预测能力
+  if (r->updates == 0) {
+    r->err = e * e;
+  } else {
+    r->err += ERR_ALPHA * (e * e - r->err);
+  }
+  r->updates++;
+}
+
+/**
+ * @brief 回归参考温度: 已知环境温度或固定偏置
+ */
+static float y_ref(const fopdt_t *m) {
+  return m->ambient_known ? m->ambient : Y_REF;
+}
+
+void fopdt_init(fopdt_t *m, float sample_period) {
+  m->sample_period = sample_period;
+  m->ambient_known = false;
+  m->ambient = 0.0f;
+  m->lambda = 0.995f;
+  m->p_max = 1000.0f;
+  m->min_samples = 24;
+  fopdt_reset(m);
+}
+
+void fopdt_reset(fopdt_t *m) {
+  for (int d = 0; d < FOPDT_MAX_DELAY; d++) {
+    rls_init(&m->rls[d]);
+    if (m->ambient_known) {
+      // 常数项确定为0: 协方差置0，否则遗忘因子会使其无界增长
+      m->rls[d].p[2][2] = 0.0f;
+    }
+  }
+  memset(m->u_hist, 0, sizeof(m->u_hist));
+  m->u_count = 0;
+  m->y_prev = 0.0f;
+  m->has_prev = false;
+  m->acc_time = 0.0f;
+  m->acc_duty = 0.0f;
+  m->samples = 0;
+  m->best = 0;
+}
+
+void fopdt_set_ambient(fopdt_t *m, float ambient) {
+  if (!m->ambient_known) {
+    m->ambient_known = true;
+    fopdt_reset(m);
+  }
+  m->ambient = ambient;
+}
+
+bool fopdt_update(fopdt_t *m, float temp, float duty, float dt) {
+  if (dt > 2.0f * m->sample_period) {
+    // 数据中断: 重新开始样本序列, 保留已辨识参数
+    m->has_prev = false;
+    m->u_count = 0;
+  }
+  if (!m->has_prev) {
+    m->y_prev = temp;
+    m->has_prev = true;
+    m->acc_time = 0.0f;
+    m->acc_duty = 0.0f;
+    return false;
+  }
+
+  m->acc_time += dt;
+  m->acc_duty += duty * dt;
+  if (m->acc_time < m->sample_period) {
+    return false;
+  }
+
+  float u = m->acc_duty / m->acc_time / 100.0f;
+  if (u < 0.0f) {
+    u = 0.0f;
+  } else if (u > 1.0f) {
+    u = 1.0f;
+  }
+  memmove(&m->u_hist[1], &m->u_hist[0],
+          sizeof(m->u_hist[0]) * (FOPDT_MAX_DELAY - 1));
+  m->u_hist[0] = u;
+  if (m->u_count < FOPDT_MAX_DELAY) {
+    m->u_count++;
+  }
+
+  // 稳态样本不含新信息，跳过更新以免噪声使参数漂移
+  bool idle = fabsf(temp - m->y_prev) < IDLE_DY &&
+              (m->u_count < 2 || fabsf(u - m->u_hist[1]) < IDLE_DU);
+  // 环境温度已知时常数项回归量为0，c 保持为0
+  const float ref = y_ref(m);
+  const float one = m->ambient_known ? 0.0f : 1.0f;
+  for (int d = 0; d < m->u_count && !idle; d++) {
+    float phi[3] = {m->y_prev - ref, m->u_hist[d], one};
+    rls_update(&m->rls[d], phi, temp - ref, m->lambda, m->p_max);
+  }
+
+  // 选择预测误差最小的死区
+  int best = 0;
+  for (int d = 1; d < FOPDT_MAX_DELAY; d++) {
+    if (m->rls[d].updates >= BEST_MIN_UPDATES &&
+        m->rls[d].err < m->rls[best].err) {
+      best = d;
+    }
+  }
+  m->best = best;
+
+  m->y_prev = temp;
+  m->acc_time = 0.0f;
+  m->acc_duty = 0.0f;
+  m->samples++;
+  return true;
+}
+
+bool fopdt_get_params(const fopdt_t *m, fopdt_params_t *params) {
+  const fopdt_rls_t *r = &m->rls[m->best];
+  float a = r->theta[0];
+  float b = r->theta[1];
+  float c = r->theta[2];
+
+  memset(params, 0, sizeof(*params));
+  params->samples = m->samples;
+  params->rmse = sqrtf(r->err);
+  params->valid =
+      m->samples >= m->min_samples && a > 0.0f && a < 1.0f && b > 0.0f;
+  if (!params->valid) {
+    return false;
+  }
+
+  params->gain = b / (1.0f - a);
+  params->tau = -m->sample_period / logf(a);
+  params->dead_time = (float)m->best * m->sample_period;
+  params->ambient = y_ref(m) + c / (1.0f - a);
+
+  // 恒定占空比升温段只能确定初始斜率，a 趋近1时增益/时间常数不可信
+  if (params->tau > TAU_MAX || params->gain > GAIN_MAX) {
+    memset(params, 0, sizeof(*params));
+    params->samples = m->samples;
+    params->rmse = sqrtf(r->err);
+    return false;
+  }
+  return true;
+}
+
+float fopdt_time_to_target(const fopdt_t *m, float temp, float target,
+                           float duty) {
+  if (temp >= target) {
+    return 0.0f;
+  }
+
+  fopdt_params_t params;
+  if (!fopdt_get_params(m, &params)) {
+    return -1.0f;
+  }
+
+  const fopdt_rls_t *r = &m->rls[m->best];
+  const float a = r->theta[0];
+  const float b = r->theta[1];
+  const float c = r->theta[2];
+  const float u = duty / 100.0f;
+  const float y_target = target - y_ref(m);
+  float y = temp - y_ref(m);
+  float t = 0.0f;
+
+  // 滞后期内仍由历史占空比驱动
+  for (int s = 1; s <= m->best; s++) {
+    int i = m->best - s;
+    float u_past = i < m->u_count ? m->u_hist[i] : u;
+    y = a * y + b * u_past + c;
+    t += m->sample_period;
+    if (y >= y_target) {
+      return t;
+    }
+  }
+
+  // 之后为一阶响应: y(n) = yss + (y - yss) * a^n
+  float y_ss = (b * u + c) / (1.0f - a);
+  if (y_ss <= y_target) {
+    return -1.0f;
+  }
+  float n = logf((y_ss - y_target) / (y_ss - y)) / logf(a);
+  return t + n * m->sample_period;
+}
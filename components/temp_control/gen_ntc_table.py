@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+@file gen_ntc_table.py
+@brief 编译期生成NTC查找表 (分压点电压 mV -> 温度 0.01°C)
+
+由 components/temp_control/CMakeLists.txt 在构建时调用，参数来自 Kconfig
+(NTC_BETA / NTC_R25 / NTC_SERIES_R)。运行时只需查表 + 整数线性插值，
+不再在控制任务中执行软浮点除法和 logf()。
+
+使用 --check 可打印查表插值相对B值公式的最大误差；与 logf() 的耗时
+对比见 tools/ntc_bench。
+"""
+
+import argparse
+import math
+import sys
+
+T25_KELVIN = 25.0 + 273.15
+
+
+def beta_celsius(mv, beta, r25, series_r, vref_mv):
+    """与原 read_ntc_temperature() 相同的B值公式"""
+    r_ntc = series_r * mv / (vref_mv - mv)
+    return 1.0 / (1.0 / T25_KELVIN + math.log(r_ntc / r25) / beta) - 273.15
+
+
+def build_table(args):
+    table = []
+    for mv in range(args.mv_min, args.mv_max + 1, args.step_mv):
+        centi = round(
+            beta_celsius(mv, args.beta, args.r25, args.series_r, args.vref_mv) *
+            100.0)
+        if centi < -32768 or centi > 32767:
+            sys.exit("NTC table entry out of int16 range at %d mV" % mv)
+        table.append(centi)
+    return table
+
+
+def lookup(table, args, mv):
+    """与 ntc.c 中的整数插值逻辑保持一致"""
+    if mv <= args.mv_min:
+        return table[0]
+    if mv >= args.mv_max:
+        return table[-1]
+    offset = mv - args.mv_min
+    idx = offset // args.step_mv
+    frac = offset - idx * args.step_mv
+    lo, hi = table[idx], table[idx + 1]
+    return lo + int((hi - lo) * frac / args.step_mv)
+
+
+def check(table, args):
+    max_err = 0.0
+    max_err_mv = 0
+    for mv in range(args.mv_min, args.mv_max + 1):
+        ref = beta_celsius(mv, args.beta, args.r25, args.series_r, args.vref_mv)
+        err = abs(lookup(table, args, mv) / 100.0 - ref)
+        if err > max_err:
+            max_err, max_err_mv = err, mv
+    print("NTC table: %d entries, max interpolation error %.3f C at %d mV" %
+          (len(table), max_err, max_err_mv))
+
+
+def write_header(table, args):
+    lines = [
+        "/**",
+        " * @file ntc_table.h",
+        " * @brief NTC查找表 (由 gen_ntc_table.py 自动生成，请勿手动修改)",
+        " *",
+        " * B=%d, R25=%d, R_series=%d, Vref=%d mV" %
+        (args.beta, args.r25, args.series_r, args.vref_mv),
+        " */",
+        "",
+        "#ifndef NTC_TABLE_H",
+        "#define NTC_TABLE_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define NTC_TABLE_MV_MIN %d" % args.mv_min,
+        "#define NTC_TABLE_MV_MAX %d" % args.mv_max,
+        "#define NTC_TABLE_MV_STEP %d" % args.step_mv,
+        "#define NTC_TABLE_SIZE %d" % len(table),
+        "",
+        "// 下标 i 对应电压 NTC_TABLE_MV_MIN + i * NTC_TABLE_MV_STEP (mV)",
+        "static const int16_t s_ntc_table[NTC_TABLE_SIZE] = {",
+    ]
+    for i in range(0, len(table), 8):
+        lines.append("    " + ", ".join(str(v) for v in table[i:i + 8]) + ",")
+    lines += ["};", "", "#endif // NTC_TABLE_H", ""]
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--beta", type=int, required=True)
+    parser.add_argument("--r25", type=int, required=True)
+    parser.add_argument("--series-r", type=int, required=True)
+    parser.add_argument("--vref-mv", type=int, default=3300)
+    parser.add_argument("--mv-min", type=int, default=96)
+    parser.add_argument("--mv-max", type=int, default=3216)
+    parser.add_argument("--step-mv", type=int, default=16)
+    parser.add_argument("--output", "-o")
+    parser.add_argument("--check", action="store_true")
+    args = parser.parse_args()
+
+    if args.mv_min <= 0 or args.mv_max >= args.vref_mv:
+        sys.exit("NTC table range must lie strictly inside (0, Vref)")
+    if (args.mv_max - args.mv_min) % args.step_mv != 0:
+        sys.exit("NTC table range must be a multiple of the step")
+
+    table = build_table(args)
+    if args.output:
+        write_header(table, args)
+    if args.check:
+        check(table, args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,133 @@
+/**
+ * @file ambient.h
+ * @brief 环境温度估计与散热前馈
+ *
+ * 以芯片内部温度传感器作为环境温度的代理。芯片自身发热使读数高于
+ * 环境，偏差在冷启动 (加热板已与环境平衡) 时以NTC读数标定，之后
+ * 环境温度 = 滤波后的芯片温度 - 偏差。
+ *
+ * 散热功率与 (温度 - 环境温度) 成正比：读数稳定的窗口内加热功率等于
+ * 散热功率，平均占空比 / (平均温度 - 环境温度) 即散热系数。维持设定值
+ * 所需的占空比 系数*(设定值-环境温度) 作为PID前馈，积分只需补偿残差，
+ * 冷/热环境下使用同一组PID参数的表现一致
+ */
+
+#ifndef AMBIENT_H
+#define AMBIENT_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 估计器参数
+ */
+typedef struct {
+  float offset;     // 标定前使用的芯片温度偏差 (°C)
+  float filter_tau; // 芯片温度低通滤波时间常数 (s)
+  float window;     // 散热系数学习窗口 (s)
+  float max_drift;  // 窗口首尾读数差超过此值时不学习 (°C)
+  float min_excess; // 高于环境温度不足此值时不学习 (°C)
+  float alpha;      // 散热系数指数平均系数
+} ambient_config_t;
+
+/**
+ * @brief 估计器状态
+ */
+typedef struct {
+  ambient_config_t cfg;
+
+  // 环境温度
+  float offset;     // 芯片温度 - 环境温度 (°C)
+  bool calibrated;  // 偏差已在冷启动时标定
+  float chip;       // 滤波后的芯片温度 (°C)
+  bool has_chip;    // 已有芯片温度读数
+  float ambient;    // 环境温度估计 (°C)
+
+  // 学习窗口
+  float win_elapsed;  // 已运行时间 (s)
+  float win_duty_sum; // 占空比*时间
+  float win_temp_sum; // 温度*时间
+  float win_start;    // 起始读数 (°C)
+
+  // 散热模型
+  float loss;     // 维持高于环境1°C所需占空比 (%/K), <=0 未学习
+  int loss_count; // 参与学习的窗口数
+} ambient_t;
+
+/**
+ * @brief 填充默认参数
+ *
+ * @param cfg 输出参数
+ */
+void ambient_default_config(ambient_config_t *cfg);
+
+/**
+ * @brief 初始化估计器
+ *
+ * @param a 估计器指针
+ * @param cfg 参数
+ */
+void ambient_init(ambient_t *a, const ambient_config_t *cfg);
+
+/**
+ * @brief 输入芯片温度
+ *
+ * @param a 估计器指针
+ * @param chip 芯片温度 (°C)
+ * @param dt 距上次输入的时间 (s)
+ */
+void ambient_update(ambient_t *a, float chip, float dt);
+
+/**
+ * @brief 以已知的环境温度 (冷启动时的NTC读数) 标定芯片温度偏差
+ *
+ * @param a 估计器指针
+ * @param reference 环境温度 (°C)
+ */
+void ambient_calibrate(ambient_t *a, float reference);
+
+/**
+ * @brief 恢复保存的标定结果和散热系数 (与硬件有关，与环境温度无关)
+ *
+ * @param a 估计器指针
+ * @param calibrated 偏差已标定, false 时忽略 offset
+ * @param offset 芯片温度偏差 (°C)
+ * @param loss 散热系数 (%/K), <=0 未学习
+ */
+void ambient_restore(ambient_t *a, bool calibrated, float offset, float loss);
+
+/**
+ * @brief 环境温度估计是否可用
+ *
+ * @param a 估计器指针
+ * @return true 已有芯片温度读数
+ */
+bool ambient_valid(const ambient_t *a);
+
+/**
+ * @brief 学习散热系数 (加热期间每个控制周期调用)
+ *
+ * @param a 估计器指针
+ * @param temp 当前读数 (°C)
+ * @param duty 上一周期平均加热占空比 (%)
+ * @param dt 距上次调用的时间 (s), 0 表示数据中断, 重新开始窗口
+ */
+void ambient_learn(ambient_t *a, float temp, float duty, float dt);
+
+/**
+ * @brief 维持设定值所需的前馈占空比
+ *
+ * @param a 估计器指针
+ * @param setpoint 设定值 (°C)
+ * @return float 占空比 (%), 散热模型或环境温度不可用返回 -1
+ */
+float ambient_ff_duty(const ambient_t *a, float setpoint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AMBIENT_H
@@ -0,0 +1,105 @@
+/**
+ * @file autotune.h
+ * @brief 继电反馈PID自整定 (Åström–Hägglund)
+ *
+ * 以继电器方式在目标值附近开关加热器，产生极限环振荡，
+ * 由振幅和周期辨识临界增益 Ku 和临界周期 Pu，再换算PID参数
+ */
+
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 自整定状态枚举
+ */
+typedef enum {
+  AUTOTUNE_IDLE,    // 未运行
+  AUTOTUNE_RUNNING, // 继电振荡中
+  AUTOTUNE_DONE,    // 完成
+  AUTOTUNE_FAILED   // 失败 (超时或振荡无效)
+} autotune_state_t;
+
+/**
+ * @brief 自整定器结构体
+ */
+typedef struct {
+  autotune_state_t state;
+
+  float setpoint;    // 继电切换点
+  float hysteresis;  // 切换回差 (抑制噪声)
+  float output_high; // 继电高输出
+  float output_low;  // 继电低输出
+  int cycles_target; // 需要的有效振荡周期数
+  float timeout;     // 超时时间 (s)
+
+  bool relay_high;   // 当前继电输出
+  float elapsed;     // 已运行时间 (s)
+  float cycle_start; // 本周期起始时间 (s), <0 表示尚未起振
+  float cycle_max;   // 本周期最高测量值
+  float cycle_min;   // 本周期最低测量值
+  int cycles;        // 已完成的周期数 (含被丢弃的首周期)
+
+  float period_sum;    // 有效周期累计 (s)
+  float amplitude_sum; // 有效振幅累计
+
+  float ku; // 临界增益
+  float pu; // 临界周期 (s)
+} autotune_t;
+
+/**
+ * @brief 启动自整定
+ *
+ * @param at 自整定器指针
+ * @param setpoint 继电切换点 (目标温度)
+ * @param output_low 继电低输出 (如 0%)
+ * @param output_high 继电高输出 (如 100%)
+ * @param hysteresis 切换回差
+ */
+void autotune_start(autotune_t *at, float setpoint, float output_low,
+                    float output_high, float hysteresis);
+
+/**
+ * @brief 自整定单步更新
+ *
+ * @param at 自整定器指针
+ * @param measurement 当前测量值
+ * @param dt 距上次更新的时间 (s)
+ * @return float 本周期应施加的输出
+ */
+float autotune_update(autotune_t *at, float measurement, float dt);
+
+/**
+ * @brief 中止自整定
+ *
+ * @param at 自整定器指针
+ */
+void autotune_cancel(autotune_t *at);
+
+/**
+ * @brief 由辨识结果计算PID参数
+ *
+ * 使用 Ziegler–Nichols 无超调整定 (Kp=0.2Ku, Ti=Pu/2, Td=Pu/3)，
+ * 并换算为 pid_compute() 的每步参数
+ *
+ * @param at 自整定器指针 (须为 AUTOTUNE_DONE)
+ * @param period 控制周期 (s)
+ * @param kp 输出比例系数
+ * @param ki 输出积分系数 (每步)
+ * @param kd 输出微分系数 (每步)
+ * @return true 成功
+ * @return false 尚未完成
+ */
+bool autotune_get_gains(const autotune_t *at, float period, float *kp,
+                        float *ki, float *kd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUTOTUNE_H
@@ -0,0 +1,114 @@
+/**
+ * @file boost.h
+ * @brief 全功率升温 + PID 混合加热策略
+ *
+ * 冷启动时先以满占空比加热，预测停止全功率后读数将到达目标时
+ * 切换到PID，并按估算的保温占空比预置积分 (无扰切换)。
+ *
+ * 预测使用全功率阶段自身测得的一阶模型 dT/dt = r0*u - k*(T - Ta)：
+ * 满功率下升温速率随温度线性下降，对 (温度, 速率) 做最小二乘直线拟合
+ * 得到 r0 与 k (以起始温度近似环境温度 Ta)，维持目标温度所需占空比为
+ * k*(目标 - Ta)/r0。读数相对加热板有传感器滞后，停止全功率后读数
+ * 还会继续上升约 速率*lead，据此确定切换点
+ */
+
+#ifndef BOOST_H
+#define BOOST_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 策略参数
+ */
+typedef struct {
+  float min_step;       // 目标高于当前温度超过此值才启动全功率 (°C)
+  float margin;         // 预测读数达到 目标-margin 时切换 (°C)
+  float lead;           // 读数滞后加热板的时间, 含控制周期 (s)
+  float slope_interval; // 升温速率计算间隔 (s)
+} boost_config_t;
+
+/**
+ * @brief 策略状态
+ */
+typedef struct {
+  boost_config_t cfg;
+
+  bool active;         // 正在全功率升温
+  float target;        // 本次目标温度
+  float hold_duty;     // 切换时估算的保温占空比 (%), <0 未知
+  float start_temp;    // 起始温度 (°C)
+  float slope;         // 当前升温速率 (°C/s), 指数平均
+  int slope_count;     // 已计算的速率个数
+  float slope_ref;     // 速率参考温度
+  float slope_elapsed; // 距参考温度的时间 (s)
+
+  // 速率-温度直线拟合累加量 (温度相对 start_temp)
+  int fit_n;
+  float fit_sx;
+  float fit_sy;
+  float fit_sxx;
+  float fit_sxy;
+} boost_t;
+
+/**
+ * @brief 填充默认参数
+ *
+ * @param cfg 输出参数
+ */
+void boost_default_config(boost_config_t *cfg);
+
+/**
+ * @brief 初始化
+ *
+ * @param b 策略指针
+ * @param cfg 参数
+ */
+void boost_init(boost_t *b, const boost_config_t *cfg);
+
+/**
+ * @brief 开始一次升温 (开机或修改目标时调用)
+ *
+ * @param b 策略指针
+ * @param temp 当前温度 (°C)
+ * @param target 目标温度 (°C)
+ * @return true 温差足够，进入全功率阶段
+ */
+bool boost_start(boost_t *b, float temp, float target);
+
+/**
+ * @brief 放弃全功率阶段
+ *
+ * @param b 策略指针
+ */
+void boost_cancel(boost_t *b);
+
+/**
+ * @brief 全功率阶段单步更新 (每个控制周期调用)
+ *
+ * @param b 策略指针
+ * @param temp 当前温度 (°C)
+ * @param dt 距上次调用的时间 (s)
+ * @return true 本次应切换到PID (hold_duty 为预置占空比)
+ */
+bool boost_update(boost_t *b, float temp, float dt);
+
+/**
+ * @brief 切换到PID时的预置占空比
+ *
+ * 全功率阶段的输出受功率上限约束，hold_duty 是相对该上限的比例
+ *
+ * @param b 策略指针
+ * @param cap_percent 功率上限 (%)
+ * @return float 预置占空比 (%), <0 未知
+ */
+float boost_preload_duty(const boost_t *b, float cap_percent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOST_H
@@ -0,0 +1,126 @@
+/**
+ * @file cascade.h
+ * @brief 级联控温: 杯温观测器与外环
+ *
+ * NTC贴在加热板上，需要控制的却是杯中液体的温度。以两节点热模型
+ * (加热板 + 杯子，各自向环境散热，两者之间接触换热) 建立卡尔曼滤波器，
+ * 由加热板读数和加热占空比估计杯温：
+ *
+ *   Cp*dTp/dt = P*u - Gpa*(Tp-Ta) - Gpc*(Tp-Tc)
+ *   Cc*dTc/dt = Gpc*(Tp-Tc) - Gca*(Tc-Ta)
+ *
+ * 外环按杯温误差给出加热板设定值：模型推算的稳态温差 (前馈) + 比例 +
+ * 积分，限制在加热板温度上限以内，内环PID以更短周期调节加热板。
+ * 升温时加热板停在上限，杯子以允许的最大热流升温而不烫坏表面
+ */
+
+#ifndef CASCADE_H
+#define CASCADE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 模型与外环参数
+ */
+typedef struct {
+  float heater_w;    // 满占空比加热功率 (W)
+  float plate_c;     // 加热板热容 (J/K)
+  float cup_c;       // 杯子+液体热容 (J/K)
+  float g_plate_amb; // 加热板-环境热导 (W/K)
+  float g_plate_cup; // 加热板-杯子热导 (W/K)
+  float g_cup_amb;   // 杯子-环境热导 (W/K)
+  float q_plate;     // 加热板温度过程噪声 (°C^2/s)
+  float q_cup;       // 杯温过程噪声 (°C^2/s), 越大越快跟上倒入的热水
+  float r;           // 读数噪声 (°C^2)
+  float kp;          // 外环比例 (加热板°C / 杯温°C)
+  float ki;          // 外环积分 (1/s)
+  float i_band;      // 杯温误差在此范围内才积分 (°C)
+  float plate_max;   // 加热板设定值上限 (°C)
+} cascade_config_t;
+
+/**
+ * @brief 观测器与外环状态
+ */
+typedef struct {
+  cascade_config_t cfg;
+  bool has_state;  // 已用读数初始化
+  float plate;     // 加热板温度估计 (°C)
+  float cup;       // 杯温估计 (°C)
+  float p[2][2];   // 估计误差协方差
+  float integral;  // 外环积分 (°C)
+  float plate_sp;  // 加热板设定值 (°C)
+} cascade_t;
+
+/**
+ * @brief 填充默认参数 (约15W USB杯垫 + 250ml陶瓷杯)
+ *
+ * @param cfg 输出参数
+ */
+void cascade_default_config(cascade_config_t *cfg);
+
+/**
+ * @brief 初始化
+ *
+ * @param c 状态指针
+ * @param cfg 参数
+ */
+void cascade_init(cascade_t *c, const cascade_config_t *cfg);
+
+/**
+ * @brief 丢弃杯温估计和外环积分 (开机时调用, 可能换了杯子)
+ *
+ * 下次观测时按读数重新初始化
+ *
+ * @param c 状态指针
+ */
+void cascade_reset(cascade_t *c);
+
+/**
+ * @brief 观测器单步: 按上一区间的占空比预测，再用读数校正
+ *
+ * 首次调用时以读数初始化，杯温假设与加热板相同 (方差取大值)
+ *
+ * @param c 状态指针
+ * @param plate 加热板读数 (°C)
+ * @param duty 上一区间加热占空比 (%)
+ * @param ambient 环境温度 (°C)
+ * @param dt 距上次调用的时间 (s)
+ */
+void cascade_observe(cascade_t *c, float plate, float duty, float ambient,
+                     float dt);
+
+/**
+ * @brief 外环单步
+ *
+ * @param c 状态指针
+ * @param target 杯温设定值 (°C)
+ * @param ambient 环境温度 (°C)
+ * @param dt 距上次调用的时间 (s), 0 不积分
+ * @return float 加热板设定值 (°C)
+ */
+float cascade_update(cascade_t *c, float target, float ambient, float dt);
+
+/**
+ * @brief 按模型预测杯温到达目标所需时间
+ *
+ * 假设内环理想：加热板以 max_duty 升温到设定值后保持 (设定值按外环
+ * 比例+前馈计算，不含积分)
+ *
+ * @param c 状态指针
+ * @param target 杯温目标 (°C)
+ * @param ambient 环境温度 (°C)
+ * @param max_duty 允许的最大占空比 (%)
+ * @return float 剩余时间 (s), 已到温返回 0, 4小时内不可达返回 -1
+ */
+float cascade_time_to_target(const cascade_t *c, float target, float ambient,
+                             float max_duty);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CASCADE_H
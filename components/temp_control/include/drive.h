@@ -0,0 +1,115 @@
+/**
+ * @file drive.h
+ * @brief 加热器驱动级: 功率上限 + 上升斜率限制 + 射频发射避让
+ *
+ * 控制器给出的占空比在写入PWM前依次经过：功率上限、射频发射期间的
+ * 避让上限、上升斜率限制。USB供电时加热电流从0阶跃到满占空比会使
+ * 供电电压跌落，叠加WiFi发射的电流尖峰容易触发欠压复位；限制上升
+ * 斜率和发射期间的占空比后，同一电源可以使用更大的加热功率。
+ * 下降不限速，关断总是立即生效。
+ *
+ * 占空比为带 DRIVE_FRAC_BITS 位小数的PWM计数，保留控制器输出的小数部分；
+ * 写入PWM时按最近值取整，或以一阶sigma-delta在相邻PWM周期间交替取
+ * 上下两个整数 (时间抖动)，使平均占空比达到小数精度。全部为整数运算
+ */
+
+#ifndef DRIVE_H
+#define DRIVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DRIVE_FRAC_BITS 8 // 占空比小数位数
+
+/**
+ * @brief 驱动级参数
+ */
+typedef struct {
+  uint32_t full;    // 满占空比 (PWM满计数 << DRIVE_FRAC_BITS)
+  uint32_t cap;     // 功率上限
+  uint32_t slew;    // 每秒最大上升量, 0=不限
+  uint32_t backoff; // 射频发射期间的上限
+} drive_config_t;
+
+/**
+ * @brief 驱动级状态
+ */
+typedef struct {
+  drive_config_t cfg;
+
+  uint32_t request; // 控制器请求的占空比
+  uint32_t limit;   // 上次计算的目标 (请求经上限裁剪后)
+  uint32_t output;  // 当前输出
+  uint64_t carry;   // 斜率累计不足1个单位的余量 (单位*us)
+  uint32_t sigma;   // sigma-delta 误差累加 (小数部分)
+} drive_t;
+
+/**
+ * @brief 按百分比填充驱动级参数
+ *
+ * @param cfg 输出参数
+ * @param full 满占空比 (PWM满计数 << DRIVE_FRAC_BITS)
+ * @param cap_percent 功率上限 (%)
+ * @param slew_pct_s 每秒最大上升量 (%/s), 0=不限
+ * @param backoff_percent 射频发射期间的上限 (%)
+ */
+void drive_config_percent(drive_config_t *cfg, uint32_t full, int cap_percent,
+                          int slew_pct_s, int backoff_percent);
+
+/**
+ * @brief 初始化驱动级，输出为0
+ *
+ * @param d 驱动级指针
+ * @param cfg 参数 (cap/backoff 超过 full 时按 full 处理)
+ */
+void drive_init(drive_t *d, const drive_config_t *cfg);
+
+/**
+ * @brief 计算新的输出占空比
+ *
+ * 上次调用时输出已到达目标 (未在爬升) 则 dt 不计，新的爬升从本次开始
+ *
+ * @param d 驱动级指针
+ * @param request 控制器请求的占空比
+ * @param tx 射频正在发射
+ * @param dt_us 距上次调用的时间 (us)
+ * @return uint32_t 应写入PWM的占空比
+ */
+uint32_t drive_update(drive_t *d, uint32_t request, bool tx, uint32_t dt_us);
+
+/**
+ * @brief 当前输出量化为PWM计数
+ *
+ * 抖动时每个PWM周期调用一次，相邻周期的小数误差累加到下一周期
+ *
+ * @param d 驱动级指针
+ * @param dither true=sigma-delta抖动, false=取最近值
+ * @return uint32_t PWM计数 (0 .. full >> DRIVE_FRAC_BITS)
+ */
+uint32_t drive_pwm(drive_t *d, bool dither);
+
+/**
+ * @brief 当前输出是否含小数部分 (抖动时须逐周期调用 drive_pwm)
+ *
+ * @param d 驱动级指针
+ * @return true 含小数
+ */
+bool drive_fractional(const drive_t *d);
+
+/**
+ * @brief 输出是否已到达目标 (无需继续定时推进)
+ *
+ * @param d 驱动级指针
+ * @return true 已到达
+ */
+bool drive_settled(const drive_t *d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DRIVE_H
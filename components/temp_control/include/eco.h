@@ -0,0 +1,126 @@
+/**
+ * @file eco.h
+ * @brief 节能保温策略
+ *
+ * 到温后不再把读数维持在目标温度，而是降低设定值，使读数停留在允许的
+ * 保温带 [目标-band, 目标] 的下沿附近。散热功率与 (温度-环境温度) 成正比，
+ * 保温带内温度越低耗电越少。余量按学习窗口内的最低读数自动调整，
+ * 保证读数不跌出保温带。
+ *
+ * 同时学习散热模型：读数基本稳定的窗口内加热功率等于散热功率，
+ * 平均占空比 / (平均温度 - 环境温度) 即维持高于环境1°C所需的占空比。
+ * 据此按窗口估算直接在目标温度保温 (普通PID) 所需的占空比，与实际
+ * 占空比之差累计为节省的能量
+ */
+
+#ifndef ECO_H
+#define ECO_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 策略参数
+ */
+typedef struct {
+  float band;       // 保温带宽度, 允许低于目标的幅度 (°C)
+  float reach;      // 读数距目标此范围内视为已到温 (°C)
+  float margin;     // 设定值高于保温带下沿的初始余量 (°C)
+  float margin_min; // 余量下限 (°C)
+  float margin_max; // 余量上限 (°C)
+  float window;     // 学习窗口 (s)
+  float max_drift;  // 窗口首尾读数差超过此值时不学习散热模型 (°C)
+} eco_config_t;
+
+/**
+ * @brief 策略状态
+ */
+typedef struct {
+  eco_config_t cfg;
+
+  bool holding;   // 已到温, 处于节能保温
+  float target;   // 本次保温目标 (°C)
+  float margin;   // 当前余量 (°C)
+  float setpoint; // 当前设定值 (°C)
+
+  // 学习窗口
+  float win_elapsed;  // 已运行时间 (s)
+  float win_duty_sum; // 占空比*时间
+  float win_temp_sum; // 温度*时间
+  float win_start;    // 起始读数 (°C)
+  float win_min;      // 最低读数 (°C)
+
+  // 散热模型
+  float loss;     // 维持高于环境1°C所需占空比 (%/K), <=0 未学习
+  int loss_count; // 参与学习的窗口数
+
+  // 节能统计 (占空比*时间, %*s)
+  float hold_saved; // 本次保温节省量
+  double banked;    // 已结束的保温节省量
+} eco_t;
+
+/**
+ * @brief 填充默认参数
+ *
+ * @param cfg 输出参数
+ */
+void eco_default_config(eco_config_t *cfg);
+
+/**
+ * @brief 初始化策略 (清除已学习的散热模型和节能统计)
+ *
+ * @param e 策略指针
+ * @param cfg 策略参数
+ */
+void eco_init(eco_t *e, const eco_config_t *cfg);
+
+/**
+ * @brief 结束本次保温 (关机、改变目标或切回普通PID时调用)
+ *
+ * 本次的节省量计入累计，散热模型保留
+ *
+ * @param e 策略指针
+ */
+void eco_reset(eco_t *e);
+
+/**
+ * @brief 策略单步更新
+ *
+ * @param e 策略指针
+ * @param temp 当前读数 (°C)
+ * @param target 目标温度 (°C), 变化时重新等待到温
+ * @param duty 上一周期加热占空比 (%)
+ * @param ambient 环境温度 (°C)
+ * @param dt 距上次更新的时间 (s)
+ * @return float PID设定值 (°C), 到温前为目标温度
+ */
+float eco_update(eco_t *e, float temp, float target, float duty,
+                 float ambient, float dt);
+
+/**
+ * @brief 按散热模型估算在指定温度保温所需的占空比
+ *
+ * @param e 策略指针
+ * @param temp 保温温度 (°C)
+ * @param ambient 环境温度 (°C)
+ * @return float 占空比 (%), 模型未学习返回 -1
+ */
+float eco_hold_duty(const eco_t *e, float temp, float ambient);
+
+/**
+ * @brief 相对普通PID在目标温度保温累计节省的能量
+ *
+ * @param e 策略指针
+ * @return float 节省量 (%*s, 除以100再乘加热功率得到焦耳),
+ *         散热模型学习前及未结束的学习窗口不计
+ */
+float eco_saved_duty_s(const eco_t *e);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ECO_H
@@ -0,0 +1,141 @@
+/**
+ * @file fopdt.h
+ * @brief 一阶加纯滞后 (FOPDT) 热模型在线辨识
+ *
+ * 按固定采样周期把控制周期的数据聚合为 (平均占空比, 温度) 样本，
+ * 以递推最小二乘 (RLS, 带遗忘因子) 拟合离散模型
+ *
+ *   y[k+1] = a * y[k] + b * u[k-d] + c
+ *
+ * 对每个候选死区 d 各运行一个估计器，取一步预测误差最小者。
+ * 换算得到稳态增益 K = b/(1-a)、时间常数 tau = -Ts/ln(a)、
+ * 死区 d*Ts 和零功率稳态温度 (环境温度)，并据此预测到温时间。
+ *
+ * 环境温度已知 (fopdt_set_ambient) 时以它为参考温度并去掉常数项，
+ * 拟合 y[k+1]-Ta = a*(y[k]-Ta) + b*u[k-d]。恒定占空比升温时占空比与
+ * 常数项共线，三参数模型的 a 趋近1而不可辨识，两参数模型没有此问题
+ */
+
+#ifndef FOPDT_H
+#define FOPDT_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FOPDT_MAX_DELAY 8 // 候选死区数 (0 .. FOPDT_MAX_DELAY-1 个采样)
+
+/**
+ * @brief 单个候选死区的RLS估计器
+ */
+typedef struct {
+  float theta[3]; // a, b, c
+  float p[3][3];  // 协方差矩阵
+  float err;      // 先验预测误差平方的指数平均 (°C^2)
+  int updates;    // 更新次数
+} fopdt_rls_t;
+
+/**
+ * @brief 辨识器结构体
+ */
+typedef struct {
+  float sample_period; // 采样周期 Ts (s)
+  float lambda;        // 遗忘因子
+  float p_max;         // 协方差迹上限, 超过后暂停遗忘 (防止无激励时发散)
+  int min_samples;     // 模型有效所需的最少样本数
+
+  fopdt_rls_t rls[FOPDT_MAX_DELAY];
+  float u_hist[FOPDT_MAX_DELAY]; // 最近的平均占空比 (0-1), [0] 为最新
+  int u_count;                   // u_hist 中的有效个数
+  float y_prev;                  // 上一样本温度
+  bool has_prev;                 // 是否已有上一样本
+  float acc_time;                // 本采样周期已累计时间 (s)
+  float acc_duty;                // 本采样周期 占空比*时间
+  int samples;                   // 已处理样本数
+  int best;                      // 当前最优死区
+  bool ambient_known;            // 环境温度已知, 使用两参数模型
+  float ambient;                 // 已知的环境温度 (°C)
+} fopdt_t;
+
+/**
+ * @brief 模型参数
+ */
+typedef struct {
+  bool valid;      // 样本足够且参数符合物理意义
+  float gain;      // 稳态增益 (满占空比时的温升, °C)
+  float tau;       // 时间常数 (s)
+  float dead_time; // 纯滞后 (s)
+  float ambient;   // 零占空比稳态温度 (°C)
+  float rmse;      // 一步预测均方根误差 (°C)
+  int samples;     // 已处理样本数
+} fopdt_params_t;
+
+/**
+ * @brief 初始化辨识器
+ *
+ * @param m 辨识器指针
+ * @param sample_period 采样周期 (s)
+ */
+void fopdt_init(fopdt_t *m, float sample_period);
+
+/**
+ * @brief 丢弃全部数据，重新辨识
+ *
+ * @param m 辨识器指针
+ */
+void fopdt_reset(fopdt_t *m);
+
+/**
+ * @brief 提供已知的环境温度
+ *
+ * 首次调用时切换为两参数模型并重新辨识，之后只更新环境温度
+ *
+ * @param m 辨识器指针
+ * @param ambient 环境温度 (°C)
+ */
+void fopdt_set_ambient(fopdt_t *m, float ambient);
+
+/**
+ * @brief 输入一个控制周期的数据
+ *
+ * 数据间隔超过两个采样周期 (如传感器异常期间) 时重新开始样本序列，
+ * 已辨识的参数保留
+ *
+ * @param m 辨识器指针
+ * @param temp 当前温度 (°C)
+ * @param duty 本周期加热占空比 (%)
+ * @param dt 距上次调用的时间 (s)
+ * @return true 完成了一个新样本的辨识
+ */
+bool fopdt_update(fopdt_t *m, float temp, float duty, float dt);
+
+/**
+ * @brief 获取当前最优模型参数
+ *
+ * @param m 辨识器指针
+ * @param params 输出参数
+ * @return true 模型有效
+ */
+bool fopdt_get_params(const fopdt_t *m, fopdt_params_t *params);
+
+/**
+ * @brief 预测以固定占空比加热到目标温度所需时间
+ *
+ * 先用占空比历史推演尚未作用的滞后输入，再按一阶响应解析求解
+ *
+ * @param m 辨识器指针
+ * @param temp 当前温度 (°C)
+ * @param target 目标温度 (°C)
+ * @param duty 假设的加热占空比 (%)
+ * @return float 剩余时间 (s), 已到温返回 0, 模型无效或不可达返回 -1
+ */
+float fopdt_time_to_target(const fopdt_t *m, float temp, float target,
+                           float duty);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FOPDT_H
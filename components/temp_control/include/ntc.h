@@ -0,0 +1,40 @@
+/**
+ * @file ntc.h
+ * @brief NTC热敏电阻电压-温度转换 (编译期查找表)
+ */
+
+#ifndef NTC_H
+#define NTC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 将NTC分压点电压转换为温度
+ *
+ * 使用构建时由B值公式生成的查找表，相邻表项间整数线性插值，
+ * 全程无浮点运算。超出表范围时返回端点温度。
+ *
+ * @param voltage_mv 分压点电压 (mV, 已校准)
+ * @return int32_t 温度 (0.01°C)
+ */
+int32_t ntc_mv_to_centi_celsius(int voltage_mv);
+
+/**
+ * @brief 将温度反查为NTC分压点电压
+ *
+ * 用于把温度门限换算成电压/码值门限，表内线性查找，仅在初始化时调用
+ *
+ * @param temp_centi 温度 (0.01°C)
+ * @return int 分压点电压 (mV)，超出表范围时返回端点电压
+ */
+int ntc_centi_celsius_to_mv(int32_t temp_centi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NTC_H
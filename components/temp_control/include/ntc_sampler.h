@@ -0,0 +1,154 @@
+/**
+ * @file ntc_sampler.h
+ * @brief NTC高速采集 - adc_continuous (DMA) 过采样 + 抽取 + 中值滤波
+ *
+ * ADC以DMA方式连续采样NTC通道，每帧原始值取平均得到一个抽取值，
+ * 写入环形缓冲区；控制环读取时对最近若干抽取值取中值，
+ * 单个噪声采样不会再直接驱动PID或触发传感器异常
+ *
+ * 同步模式 (Kconfig) 下帧长取整数个加热PWM周期：
+ * - 整周期平均: 开关纹波在每帧内完整抵消，与采样相位无关
+ * - 关断相位: 按PWM相位折叠帧内采样，识别导通相位并只平均关断期间的采样
+ *
+ * 快速超温关断 (Kconfig NTC_FAST_TRIP): ADC数字监视器在每次转换时
+ * 硬件比较原始码值，低于门限 (NTC在分压下端，温度越高电压越低)
+ * 连续若干次后在中断中直接调用关断回调，不经过采集/温控任务调度
+ */
+
+#ifndef NTC_SAMPLER_H
+#define NTC_SAMPLER_H
+
+#include "esp_adc/adc_continuous.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 采集统计
+ */
+typedef struct {
+  uint32_t sample_freq_hz;    // 实际采样率
+  uint32_t frame_samples;     // 每帧采样数
+  uint32_t samples_per_cycle; // 每个PWM周期的采样数 (0=不同步)
+  uint32_t frames;            // 已处理的帧数 (抽取值个数)
+  uint32_t samples;           // 已处理的原始采样数
+  uint32_t overflows;         // DMA缓冲溢出次数 (采集任务未及时读取)
+  uint32_t last_frame_ms;     // 距最近一帧的时间 (ms)
+} ntc_sampler_stats_t;
+
+#define NTC_NOISE_BUCKETS 10 // 按占空比 0-10%, ..., 90-100% 分组
+
+/**
+ * @brief 某一占空比区间的测量噪声
+ */
+typedef struct {
+  uint32_t frames;      // 统计帧数
+  float sample_var;     // 帧内参与平均的采样方差 (LSB^2)
+  float reading_jitter; // 相邻读数差的均方/2 (LSB^2), 即读数抖动
+} ntc_noise_bucket_t;
+
+/**
+ * @brief 快速关断回调 (中断上下文)
+ *
+ * 与ADC中断一样须在写flash期间可执行：函数本身及其调用的函数都须位于
+ * IRAM (IRAM_ATTR)
+ *
+ * @param arg 注册时的用户参数
+ * @return true 唤醒了更高优先级的任务, 需要在中断退出时切换
+ */
+typedef bool (*ntc_trip_cb_t)(void *arg);
+
+/**
+ * @brief 快速关断统计
+ */
+typedef struct {
+  bool supported;     // 硬件监视器可用且已配置
+  bool armed;         // 监视器当前已使能
+  int limit_raw;      // 触发门限 (原始码值, 低于即超温)
+  uint32_t trips;     // 触发次数
+  uint32_t events;    // 超限采样中断次数
+  uint32_t detect_us; // 最近一次: 首个超限采样中断到关断完成 (us)
+  uint32_t isr_us;    // 最近一次: 关断回调耗时 (us)
+  uint32_t age_ms;    // 距最近一次触发 (ms), 0=未触发
+} ntc_trip_stats_t;
+
+/**
+ * @brief 配置快速超温关断
+ *
+ * 须在 ntc_sampler_init() 之前调用，监视器在启动连续采样前创建。
+ * 触发后采集任务暂停监视器避免中断风暴，
+ * 读数回落到门限以下 (温度) 后自动重新使能
+ *
+ * @param limit_mv 关断门限 (分压点电压, mV)
+ * @param cb 关断回调，在ADC中断中调用，须位于IRAM (见 ntc_trip_cb_t)
+ * @param arg 回调参数
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_NOT_SUPPORTED 未启用或芯片不支持
+ */
+esp_err_t ntc_sampler_set_trip(int limit_mv, ntc_trip_cb_t cb, void *arg);
+
+/**
+ * @brief 获取快速关断统计
+ *
+ * @param stats 输出统计
+ */
+void ntc_sampler_get_trip_stats(ntc_trip_stats_t *stats);
+
+/**
+ * @brief 初始化连续采样并启动采集任务
+ *
+ * @param channel NTC所在的 ADC1 通道
+ * @param pwm_freq_hz 加热器PWM频率 (同步模式下用于对齐帧长)
+ * @return esp_err_t ESP_OK 成功
+ */
+esp_err_t ntc_sampler_init(adc_channel_t channel, uint32_t pwm_freq_hz);
+
+/**
+ * @brief 通知当前加热器占空比
+ *
+ * 关断相位模式据此确定导通相位宽度，噪声诊断据此分组
+ *
+ * @param duty 占空比计数
+ * @param duty_max 满占空比计数
+ */
+void ntc_sampler_set_duty(uint32_t duty, uint32_t duty_max);
+
+/**
+ * @brief 读取滤波后的NTC电压
+ *
+ * 对最近的抽取值取中值后经ADC校准换算，
+ * 抽取值保留4位过采样小数，校准曲线在相邻码值间线性插值
+ *
+ * @param voltage_mv 输出电压 (mV)
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_STATE 尚无数据,
+ *         ESP_ERR_TIMEOUT 采集停滞
+ */
+esp_err_t ntc_sampler_read_mv(int *voltage_mv);
+
+/**
+ * @brief 获取采集统计
+ *
+ * @param stats 输出统计
+ */
+void ntc_sampler_get_stats(ntc_sampler_stats_t *stats);
+
+/**
+ * @brief 获取按占空比分组的测量噪声
+ *
+ * @param buckets 输出 NTC_NOISE_BUCKETS 个分组
+ */
+void ntc_sampler_get_noise(ntc_noise_bucket_t *buckets);
+
+/**
+ * @brief 清除噪声统计
+ */
+void ntc_sampler_reset_noise(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NTC_SAMPLER_H
@@ -6,6 +6,8 @@
 #ifndef PID_H
 #define PID_H
 
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,13 +22,23 @@ typedef struct {
 
   float setpoint; // 目标值
 
-  float integral;   // 积分累计
+  float integral;   // 积分累计 (pid_compute_dt 中为积分项输出值)
   float prev_error; // 上次误差
 
   float output_min; // 输出下限
   float output_max; // 输出上限
 
-  float integral_max; // 积分限幅
+  float integral_max;     // 积分限幅 (预置时可临时放宽)
+  float integral_max_cfg; // 配置的积分限幅
+
+  float feedforward; // 前馈量, 限幅前直接加到输出
+
+  // 以下仅用于 pid_compute_dt
+  float prev_measurement; // 上次测量值
+  float d_filtered;       // 滤波后的测量值变化率
+  float d_filter_tau;     // 微分一阶滤波时间常数 (s)
+  float kt;               // 反算抗饱和跟踪增益 (1/s), <=0 时取 ki/kp
+  bool has_measurement;   // prev_measurement 是否有效
 } pid_controller_t;
 
 /**
@@ -56,6 +68,35 @@ void pid_set_setpoint(pid_controller_t *pid, float setpoint);
  */
 void pid_set_output_limits(pid_controller_t *pid, float min, float max);
 
+/**
+ * @brief 设置积分限幅 (仅 pid_compute, 误差累计值)
+ *
+ * @param pid PID控制器指针
+ * @param max 积分累计上限 (下限为其相反数)
+ */
+void pid_set_integral_limit(pid_controller_t *pid, float max);
+
+/**
+ * @brief 恢复配置的积分限幅，积分超出时截断
+ *
+ * 预置放宽的限幅在积分回落时自动收紧；修改目标或切换温度程序时
+ * 调用，立即结束上次切换的放宽
+ *
+ * @param pid PID控制器指针
+ */
+void pid_restore_integral_limit(pid_controller_t *pid);
+
+/**
+ * @brief 设置前馈量
+ *
+ * 前馈量在限幅前加到 P+I+D 上，积分只需补偿前馈的残差；
+ * 抗饱和与预置积分均已计入前馈
+ *
+ * @param pid PID控制器指针
+ * @param ff 前馈量 (与输出同单位)
+ */
+void pid_set_feedforward(pid_controller_t *pid, float ff);
+
 /**
  * @brief 计算PID输出
  *
@@ -65,6 +106,60 @@ void pid_set_output_limits(pid_controller_t *pid, float min, float max);
  */
 float pid_compute(pid_controller_t *pid, float current);
 
+/**
+ * @brief 计算PID输出 (按实际采样间隔)
+ *
+ * 与 pid_compute() 的区别：
+ * - 积分按 ki * error * dt 累加，ki 单位为 1/s，kd 单位为 s
+ * - 微分取测量值而非误差 (修改目标值不产生微分冲击)，并经一阶低通滤波
+ * - 积分使用反算法抗饱和：输出被 output_min/output_max 限幅时，
+ *   按 kt * (限幅后 - 限幅前) 回退积分
+ *
+ * @param pid PID控制器指针
+ * @param current 当前值
+ * @param dt 距上次计算的时间 (s)
+ * @return float PID输出
+ */
+float pid_compute_dt(pid_controller_t *pid, float current, float dt);
+
+/**
+ * @brief 设置微分滤波时间常数 (仅 pid_compute_dt)
+ *
+ * @param pid PID控制器指针
+ * @param tau 时间常数 (s)，0 表示不滤波
+ */
+void pid_set_derivative_filter(pid_controller_t *pid, float tau);
+
+/**
+ * @brief 设置反算抗饱和跟踪增益 (仅 pid_compute_dt)
+ *
+ * @param pid PID控制器指针
+ * @param kt 跟踪增益 (1/s)，<=0 时自动取 ki/kp
+ */
+void pid_set_tracking_gain(pid_controller_t *pid, float kt);
+
+/**
+ * @brief 预置积分，使下一次 pid_compute() 输出为指定值 (无扰切换)
+ *
+ * 按当前误差反算积分并清除微分历史。integral_max 不足以让积分项
+ * 单独维持 output_max 时临时放宽至该值，否则预置值会在下次计算时被
+ * 截断。之后 pid_compute() 随积分回落收紧限幅，直至恢复配置值
+ *
+ * @param pid PID控制器指针 (须已设置目标值)
+ * @param current 当前值
+ * @param output 期望输出
+ */
+void pid_preload(pid_controller_t *pid, float current, float output);
+
+/**
+ * @brief 预置积分，使下一次 pid_compute_dt() 输出为指定值 (无扰切换)
+ *
+ * @param pid PID控制器指针 (须已设置目标值)
+ * @param current 当前值
+ * @param output 期望输出
+ */
+void pid_preload_dt(pid_controller_t *pid, float current, float output);
+
 /**
  * @brief 重置PID控制器状态
  *
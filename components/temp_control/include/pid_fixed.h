@@ -0,0 +1,149 @@
+/**
+ * @file pid_fixed.h
+ * @brief 定点PID控制算法 (Q16.16)
+ *
+ * 与 pid.h 接口形式一致，全部使用整数运算，适用于无FPU的ESP32-C3
+ */
+
+#ifndef PID_FIXED_H
+#define PID_FIXED_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Q16.16 定点数 (高16位整数, 低16位小数)
+ */
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE ((q16_t)1 << Q16_SHIFT)
+
+// 整数 / 浮点常量 -> Q16.16 (浮点转换仅用于初始化)
+#define Q16_FROM_INT(x) ((q16_t)(x) * Q16_ONE)
+#define Q16_FROM_FLOAT(x) ((q16_t)((x) * (float)Q16_ONE))
+#define Q16_TO_INT(x) ((x) >> Q16_SHIFT)
+
+/**
+ * @brief 0.01°C -> Q16.16
+ */
+static inline q16_t q16_from_centi(int32_t centi) {
+  return (q16_t)(((int64_t)centi << Q16_SHIFT) / 100);
+}
+
+/**
+ * @brief Q16.16 乘法
+ */
+static inline q16_t q16_mul(q16_t a, q16_t b) {
+  return (q16_t)(((int64_t)a * b) >> Q16_SHIFT);
+}
+
+/**
+ * @brief 定点PID控制器结构体
+ */
+typedef struct {
+  q16_t kp; // 比例系数
+  q16_t ki; // 积分系数
+  q16_t kd; // 微分系数
+
+  q16_t setpoint; // 目标值
+
+  q16_t integral;   // 积分累计
+  q16_t prev_error; // 上次误差
+
+  q16_t output_min; // 输出下限
+  q16_t output_max; // 输出上限
+
+  q16_t integral_max;     // 积分限幅 (预置时可临时放宽)
+  q16_t integral_max_cfg; // 配置的积分限幅
+
+  q16_t feedforward; // 前馈量, 限幅前直接加到输出
+} pid_fixed_t;
+
+/**
+ * @brief 初始化定点PID控制器
+ *
+ * @param pid PID控制器指针
+ * @param kp 比例系数
+ * @param ki 积分系数
+ * @param kd 微分系数
+ */
+void pid_fixed_init(pid_fixed_t *pid, q16_t kp, q16_t ki, q16_t kd);
+
+/**
+ * @brief 设置PID目标值
+ *
+ * @param pid PID控制器指针
+ * @param setpoint 目标值
+ */
+void pid_fixed_set_setpoint(pid_fixed_t *pid, q16_t setpoint);
+
+/**
+ * @brief 设置输出范围
+ *
+ * @param pid PID控制器指针
+ * @param min 最小输出
+ * @param max 最大输出
+ */
+void pid_fixed_set_output_limits(pid_fixed_t *pid, q16_t min, q16_t max);
+
+/**
+ * @brief 设置积分限幅 (误差累计值)
+ *
+ * @param pid PID控制器指针
+ * @param max 积分累计上限 (下限为其相反数)
+ */
+void pid_fixed_set_integral_limit(pid_fixed_t *pid, q16_t max);
+
+/**
+ * @brief 恢复配置的积分限幅 (与 pid_restore_integral_limit() 相同)
+ *
+ * @param pid PID控制器指针
+ */
+void pid_fixed_restore_integral_limit(pid_fixed_t *pid);
+
+/**
+ * @brief 设置前馈量 (与 pid_set_feedforward() 相同)
+ *
+ * @param pid PID控制器指针
+ * @param ff 前馈量
+ */
+void pid_fixed_set_feedforward(pid_fixed_t *pid, q16_t ff);
+
+/**
+ * @brief 计算PID输出
+ *
+ * 算法与 pid_compute() 相同 (积分按步累加并限幅, 误差微分)
+ *
+ * @param pid PID控制器指针
+ * @param current 当前值
+ * @return q16_t PID输出
+ */
+q16_t pid_fixed_compute(pid_fixed_t *pid, q16_t current);
+
+/**
+ * @brief 预置积分，使下一次 pid_fixed_compute() 输出为指定值 (无扰切换)
+ *
+ * 与 pid_preload() 相同，必要时临时放宽积分限幅
+ *
+ * @param pid PID控制器指针 (须已设置目标值)
+ * @param current 当前值
+ * @param output 期望输出
+ */
+void pid_fixed_preload(pid_fixed_t *pid, q16_t current, q16_t output);
+
+/**
+ * @brief 重置PID控制器状态
+ *
+ * @param pid PID控制器指针
+ */
+void pid_fixed_reset(pid_fixed_t *pid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PID_FIXED_H
@@ -0,0 +1,126 @@
+/**
+ * @file pid_loop.h
+ * @brief PID控制步骤: 引擎选择、参数换算、预置与占空比输出
+ *
+ * 封装 pid.c / pid_fixed.c 三种计算方式 (按步、按实际间隔、Q16.16定点)，
+ * 统一按控制周期整定的参数换算、功率上限、前馈限幅和输出到驱动级计数的
+ * 量化。固件 (temp_control.c) 与主机仿真 (tools/thermal_sim) 共用此模块，
+ * 保证仿真结果对应固件的实际控制步骤。定点引擎的计算步骤不使用浮点，
+ * 前馈量仅在 pid_loop_set_feedforward() 时转换为 Q16.16
+ */
+
+#ifndef PID_LOOP_H
+#define PID_LOOP_H
+
+#include "pid.h"
+#include "pid_fixed.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PID_LOOP_HEATING_PERCENT 5 // 输出超过该占空比认为在加热 (%)
+
+/**
+ * @brief PID计算方式
+ */
+typedef enum {
+  PID_LOOP_FLOAT,      // pid_compute(), 参数按步
+  PID_LOOP_TIME_AWARE, // pid_compute_dt(), 参数按秒
+  PID_LOOP_FIXED,      // pid_fixed_compute(), Q16.16
+} pid_loop_engine_t;
+
+/**
+ * @brief 控制步骤参数
+ */
+typedef struct {
+  pid_loop_engine_t engine;
+  float period_s;      // 参数整定所用的控制周期 (s)
+  float step_s;        // 计算步长 (s), 级联内环短于 period_s
+  float d_filter_s;    // 微分滤波时间常数 (s), 仅 PID_LOOP_TIME_AWARE
+  int cap_percent;     // 输出上限 (%), 功率上限
+  uint32_t drive_full; // 100% 对应的驱动级计数 (含小数位)
+} pid_loop_config_t;
+
+/**
+ * @brief 控制步骤状态
+ */
+typedef struct {
+  pid_loop_config_t cfg;
+  pid_controller_t pid; // 浮点引擎
+  pid_fixed_t pid_q;    // 定点引擎
+  float ff;             // 当前前馈占空比 (%, 已限幅)
+} pid_loop_t;
+
+/**
+ * @brief 初始化并设置PID参数
+ *
+ * 参数按 period_s 整定：按步的引擎在 step_s 较短时按步长比例换算
+ * ki/kd 和积分限幅，按秒的引擎换算为 ki (1/s) 和 kd (s)
+ *
+ * @param p 控制步骤指针
+ * @param cfg 参数
+ * @param kp 比例系数
+ * @param ki 积分系数 (每控制周期)
+ * @param kd 微分系数 (每控制周期)
+ */
+void pid_loop_init(pid_loop_t *p, const pid_loop_config_t *cfg, float kp,
+                   float ki, float kd);
+
+/**
+ * @brief 清除积分和微分历史
+ *
+ * @param p 控制步骤指针
+ */
+void pid_loop_reset(pid_loop_t *p);
+
+/**
+ * @brief 恢复配置的积分限幅 (修改目标或切换温度程序时调用)
+ *
+ * @param p 控制步骤指针
+ */
+void pid_loop_restore_integral_limit(pid_loop_t *p);
+
+/**
+ * @brief 设置前馈量 (限幅到输出范围，定点引擎在此转换为 Q16.16)
+ *
+ * 之后的 pid_loop_run() / pid_loop_preload() 都使用该值，调用者只需在
+ * 散热系数、环境温度或设定值变化时重新设置；初始化后为0
+ *
+ * @param p 控制步骤指针
+ * @param ff 前馈占空比 (%), <0 表示未知 (按0处理)
+ */
+void pid_loop_set_feedforward(pid_loop_t *p, float ff);
+
+/**
+ * @brief 预置积分，使下一次 pid_loop_run() 输出指定占空比 (无扰切换)
+ *
+ * @param p 控制步骤指针
+ * @param temp_centi 当前温度 (0.01°C)
+ * @param setpoint_centi 设定值 (0.01°C)
+ * @param duty_percent 期望占空比 (%)
+ */
+void pid_loop_preload(pid_loop_t *p, int32_t temp_centi,
+                      int32_t setpoint_centi, float duty_percent);
+
+/**
+ * @brief 执行一次PID计算
+ *
+ * @param p 控制步骤指针
+ * @param temp_centi 当前温度 (0.01°C)
+ * @param setpoint_centi 设定值 (0.01°C)
+ * @param dt 距上次计算的时间 (s), 仅 PID_LOOP_TIME_AWARE
+ * @param is_heating 输出超过 PID_LOOP_HEATING_PERCENT
+ * @return uint32_t 驱动级请求 (0 .. drive_full)
+ */
+uint32_t pid_loop_run(pid_loop_t *p, int32_t temp_centi,
+                      int32_t setpoint_centi, float dt, bool *is_heating);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PID_LOOP_H
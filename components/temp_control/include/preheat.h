@@ -0,0 +1,111 @@
+/**
+ * @file preheat.h
+ * @brief 由实测升温曲线学习预约提前量
+ *
+ * 把温度按 PREHEAT_BIN_C 分段，记录每次升温时读数穿越各分段边界的
+ * 时刻 (相邻采样线性插值)，得到每段每升温1°C所需时间，跨多次升温
+ * 指数平均。PID在接近目标时减小输出，最后 approach 段 (目标-approach
+ * 到就绪) 单独学习所需时间，不计入分段。
+ *
+ * 预测时对起始温度到 目标-approach 的各分段积分，再加 approach 段时间，
+ * 得到从指定温度加热到目标所需的时间
+ */
+
+#ifndef PREHEAT_H
+#define PREHEAT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PREHEAT_BIN_C 5 // 分段宽度 (°C)
+#define PREHEAT_BINS 20 // 分段数, 覆盖 0 .. PREHEAT_BINS*PREHEAT_BIN_C °C
+
+/**
+ * @brief 学得的升温曲线 (保存在NVS中)
+ */
+typedef struct {
+  float sec_per_c[PREHEAT_BINS]; // 各分段每升温1°C所需时间 (s), <=0 未学习
+  float approach_s;              // approach 段所需时间 (s), <=0 未学习
+  uint32_t sessions;             // 升温到就绪的次数
+} preheat_curve_t;
+
+/**
+ * @brief 单次升温的记录状态
+ */
+typedef struct {
+  bool active;      // 正在记录
+  float approach;   // approach 段宽度 (°C)
+  float target;     // 本次目标温度 (°C)
+  float last_temp;  // 上一采样读数 (°C)
+  float last_t;     // 上一采样时刻 (s)
+  int next_edge;    // 下一个待穿越的分段边界 (边界序号)
+  float edge_t;     // 上一边界的穿越时刻 (s), <0 尚未穿越
+  float approach_t; // 穿越 目标-approach 的时刻 (s), <0 尚未穿越
+} preheat_rec_t;
+
+/**
+ * @brief 清空升温曲线
+ *
+ * @param c 曲线指针
+ */
+void preheat_curve_init(preheat_curve_t *c);
+
+/**
+ * @brief 检查曲线数据是否合法 (从NVS读出后调用)
+ *
+ * @param c 曲线指针
+ * @return true 合法
+ */
+bool preheat_curve_valid(const preheat_curve_t *c);
+
+/**
+ * @brief 开始记录一次升温
+ *
+ * @param r 记录指针
+ * @param approach approach 段宽度 (°C)
+ * @param temp 当前读数 (°C)
+ * @param target 目标温度 (°C)
+ * @param t 当前时刻 (s)
+ */
+void preheat_start(preheat_rec_t *r, float approach, float temp, float target,
+                   float t);
+
+/**
+ * @brief 输入一个采样
+ *
+ * 与上一采样间隔超过 max_gap 时从当前读数重新开始记录
+ *
+ * @param r 记录指针
+ * @param c 学习的曲线
+ * @param temp 当前读数 (°C)
+ * @param t 当前时刻 (s)
+ * @param ready 已到温 (结束本次记录)
+ * @param max_gap 允许的最大采样间隔 (s)
+ * @return true 本次升温完成并更新了 approach 段 (需要保存曲线)
+ */
+bool preheat_update(preheat_rec_t *r, preheat_curve_t *c, float temp, float t,
+                    bool ready, float max_gap);
+
+/**
+ * @brief 预测从指定温度加热到目标所需的时间
+ *
+ * 起始温度所在及以下的未学习分段用相邻已学习分段的速率
+ *
+ * @param c 曲线指针
+ * @param approach approach 段宽度 (°C), 与记录时一致
+ * @param start 起始温度 (°C)
+ * @param target 目标温度 (°C)
+ * @return float 所需时间 (s), 曲线未学习返回 -1
+ */
+float preheat_time(const preheat_curve_t *c, float approach, float start,
+                   float target);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PREHEAT_H
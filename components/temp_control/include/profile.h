@@ -0,0 +1,143 @@
+/**
+ * @file profile.h
+ * @brief 多段温度程序 (设定值曲线)
+ *
+ * 程序由若干段 {目标温度, 升降温速率, 保持时间} 组成，逐段执行：
+ * 1. 斜坡: 设定值从上一段终点 (首段为当前温度) 按速率移向目标，
+ *    速率为0时直接跳到目标
+ * 2. 到温: 等待读数进入目标 ±reach_band
+ * 3. 保持: 计满保持时间后进入下一段
+ * 末段保持结束后程序完成，设定值停留在末段目标 (保温)。
+ * 全部使用整数 (0.01°C / ms)，定点PID引擎下控制循环不引入浮点
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILE_MAX_STEPS 8 // 最大段数
+
+/**
+ * @brief 程序段
+ */
+typedef struct {
+  int16_t target;        // 目标温度 (°C)
+  uint16_t ramp_c10_min; // 升降温速率 (0.1°C/min), 0=直接跳变
+  uint16_t hold_min;     // 到温后保持时间 (min)
+} profile_step_t;
+
+/**
+ * @brief 温度程序
+ */
+typedef struct {
+  uint8_t n_steps;    // 段数
+  bool power_off;     // 完成后关闭加热 (否则保持末段目标)
+  profile_step_t steps[PROFILE_MAX_STEPS];
+} profile_t;
+
+/**
+ * @brief 段内阶段
+ */
+typedef enum {
+  PROFILE_PHASE_IDLE, // 未运行
+  PROFILE_PHASE_RAMP, // 设定值斜坡中
+  PROFILE_PHASE_SOAK, // 等待读数到温
+  PROFILE_PHASE_HOLD, // 保持计时
+  PROFILE_PHASE_DONE  // 已完成
+} profile_phase_t;
+
+/**
+ * @brief 单步更新事件
+ */
+typedef enum {
+  PROFILE_EVENT_NONE, // 无
+  PROFILE_EVENT_STEP, // 进入新的一段
+  PROFILE_EVENT_DONE  // 程序完成
+} profile_event_t;
+
+/**
+ * @brief 执行器结构体
+ */
+typedef struct {
+  profile_t prog;           // 正在执行的程序 (副本)
+  int32_t reach_band_centi; // 到温判定带 (0.01°C)
+
+  profile_phase_t phase;
+  int step;                // 当前段
+  int32_t setpoint_centi;  // 当前设定值 (0.01°C)
+  uint32_t ramp_acc;       // 斜坡余量 (ms*0.1°C/min), 每6000为0.01°C
+  uint32_t hold_ms;        // 本段已保持时间 (ms)
+} profile_run_t;
+
+/**
+ * @brief 检查程序是否合法
+ *
+ * @param prog 程序
+ * @param min_temp 允许的最低目标 (°C)
+ * @param max_temp 允许的最高目标 (°C)
+ * @return true 段数 1..PROFILE_MAX_STEPS 且目标均在范围内
+ */
+bool profile_validate(const profile_t *prog, int min_temp, int max_temp);
+
+/**
+ * @brief 开始执行
+ *
+ * @param run 执行器指针
+ * @param prog 程序 (复制保存)
+ * @param temp_centi 当前温度 (0.01°C), 首段斜坡起点
+ */
+void profile_start(profile_run_t *run, const profile_t *prog,
+                   int32_t temp_centi);
+
+/**
+ * @brief 停止执行
+ *
+ * @param run 执行器指针
+ */
+void profile_stop(profile_run_t *run);
+
+/**
+ * @brief 是否正在执行 (未完成且未停止)
+ *
+ * @param run 执行器指针
+ */
+bool profile_running(const profile_run_t *run);
+
+/**
+ * @brief 单步更新 (每个控制周期调用)
+ *
+ * @param run 执行器指针
+ * @param temp_centi 当前温度 (0.01°C)
+ * @param dt_ms 距上次调用的时间 (ms)
+ * @return profile_event_t 本次发生的事件
+ */
+profile_event_t profile_update(profile_run_t *run, int32_t temp_centi,
+                               uint32_t dt_ms);
+
+/**
+ * @brief 本段剩余保持时间
+ *
+ * @param run 执行器指针
+ * @return uint32_t 剩余时间 (s), 未进入保持阶段时为整段保持时间
+ */
+uint32_t profile_hold_remaining_s(const profile_run_t *run);
+
+/**
+ * @brief 阶段字符串
+ *
+ * @param phase 阶段
+ * @return const char* 如 "ramp"
+ */
+const char *profile_phase_to_string(profile_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILE_H
@@ -0,0 +1,135 @@
+/**
+ * @file runaway.h
+ * @brief 热失控与传感器失效检测
+ *
+ * 参考3D打印机固件的热失控保护，在固定温度上限和电压范围检查之外，
+ * 根据加热功率判断温度响应是否合理：
+ * - 升温监视: 升温阶段按平均占空比要求最小温升 (NTC脱落时读数不升)；
+ *   占空比不高时按超出维持当前读数 (相对环境温度) 所需的部分判定
+ * - 热失控: 到温后跌出回差带，满功率或明显超出所需的加热仍不回升
+ * - 变化率: 读数变化速度超过物理可能 (接触不良)
+ * - 读数卡死: 大功率加热时读数长时间不变
+ */
+
+#ifndef RUNAWAY_H
+#define RUNAWAY_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 温控故障原因
+ */
+typedef enum {
+  THERMAL_FAULT_NONE,           // 无故障
+  THERMAL_FAULT_SENSOR,         // NTC电压超范围/采集失败
+  THERMAL_FAULT_OVER_TEMP,      // 超过硬件安全上限
+  THERMAL_FAULT_HEATING_FAILED, // 加热时温度不上升
+  THERMAL_FAULT_RUNAWAY,        // 到温后满功率仍持续偏低
+  THERMAL_FAULT_RATE,           // 温度变化率不合理
+  THERMAL_FAULT_STUCK           // 读数卡死
+} thermal_fault_t;
+
+/**
+ * @brief 检测参数
+ */
+typedef struct {
+  float watch_period;      // 升温监视窗口 (s)
+  float watch_rise;        // 满占空比时窗口内最小温升 (°C), 按占空比折算
+  float watch_min_duty;    // 窗口平均占空比达到此值时按全部占空比判定 (%)
+  float watch_excess_duty; // 超出维持读数所需的占空比达到此值时判定 (%)
+  float full_rise;         // 满占空比时相对环境的最小稳态温升 (°C)
+
+  float hysteresis;      // 到温后允许低于目标的幅度 (°C)
+  float runaway_period;  // 热失控窗口 (s)
+  float runaway_duty;    // 视为满功率的平均占空比 (%)
+  float runaway_recover; // 窗口内需从最低点回升的幅度 (°C)
+
+  float max_rate;      // 最大合理变化率 (°C/s)
+  float rate_interval; // 变化率计算的最小间隔 (s)
+  int max_rate_count;  // 连续超限次数
+
+  float stuck_period;   // 卡死判定窗口 (s)
+  float stuck_span;     // 窗口内读数最大变化低于此值视为卡死 (°C)
+  float stuck_min_duty; // 窗口平均占空比低于此值不判定 (%)
+} runaway_config_t;
+
+/**
+ * @brief 检测器结构体
+ */
+typedef struct {
+  runaway_config_t cfg;
+
+  bool has_prev;      // 是否已有读数
+  float target;       // 当前设定值 (升高到跌出回差带时重新开始升温监视)
+  bool reached;       // 本次目标是否已到温
+  float rate_ref;     // 变化率参考读数
+  float rate_elapsed; // 距参考读数的时间 (s)
+  int rate_count;     // 变化率连续超限次数
+
+  float watch_elapsed;  // 升温窗口已运行时间 (s)
+  float watch_start;    // 升温窗口起始温度
+  float watch_duty_sum; // 升温窗口内 占空比*时间
+
+  float runaway_elapsed;  // 热失控窗口已运行时间 (s)
+  float runaway_min;      // 热失控窗口内最低温度
+  float runaway_duty_sum; // 热失控窗口内 占空比*时间
+
+  float stuck_elapsed;  // 卡死窗口已运行时间 (s)
+  float stuck_min;      // 卡死窗口内最低读数
+  float stuck_max;      // 卡死窗口内最高读数
+  float stuck_duty_sum; // 卡死窗口内 占空比*时间
+} runaway_t;
+
+/**
+ * @brief 填充默认检测参数
+ *
+ * @param cfg 输出参数
+ */
+void runaway_default_config(runaway_config_t *cfg);
+
+/**
+ * @brief 初始化检测器
+ *
+ * @param rw 检测器指针
+ * @param cfg 检测参数
+ */
+void runaway_init(runaway_t *rw, const runaway_config_t *cfg);
+
+/**
+ * @brief 清除检测状态 (关闭加热或清除故障时调用)
+ *
+ * @param rw 检测器指针
+ */
+void runaway_reset(runaway_t *rw);
+
+/**
+ * @brief 检测单步更新
+ *
+ * @param rw 检测器指针
+ * @param temp 当前温度 (°C)
+ * @param target 控制环正在跟踪的设定值 (°C)
+ * @param duty 本周期加热占空比 (%)
+ * @param ambient 环境温度 (°C)
+ * @param dt 距上次更新的时间 (s)
+ * @return thermal_fault_t 检出的故障, 无故障返回 THERMAL_FAULT_NONE
+ */
+thermal_fault_t runaway_update(runaway_t *rw, float temp, float target,
+                               float duty, float ambient, float dt);
+
+/**
+ * @brief 故障原因字符串
+ *
+ * @param fault 故障原因
+ * @return const char* 如 "heating_failed"
+ */
+const char *thermal_fault_to_string(thermal_fault_t fault);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUNAWAY_H
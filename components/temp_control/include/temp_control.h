@@ -6,8 +6,13 @@
 #ifndef TEMP_CONTROL_H
 #define TEMP_CONTROL_H
 
+#include "autotune.h"
 #include "esp_err.h"
+#include "fopdt.h"
+#include "profile.h"
+#include "runaway.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 
 #ifdef __cplusplus
@@ -21,9 +26,115 @@ typedef enum {
   TEMP_STATE_IDLE,    // 待机
   TEMP_STATE_HEATING, // 加热中
   TEMP_STATE_KEEPING, // 保温中
-  TEMP_STATE_ERROR    // 传感器异常
+  TEMP_STATE_ERROR,   // 传感器异常或热保护故障
+  TEMP_STATE_AUTOTUNE // PID自整定中
 } temp_state_t;
 
+/**
+ * @brief 加热策略
+ */
+typedef enum {
+  TEMP_HEAT_MODE_PID,    // 始终由PID控制
+  TEMP_HEAT_MODE_BOOST,  // 冷启动先满功率升温，接近目标后无扰切换到PID
+  TEMP_HEAT_MODE_CASCADE // 目标为估计杯温，外环给出加热板设定值
+} temp_heat_mode_t;
+
+/**
+ * @brief 温控状态快照
+ *
+ * 由温控任务及设置接口整体发布，读取时各字段保证来自同一次发布
+ */
+typedef struct {
+  uint32_t version;   // 发布序号，每次发布递增
+  float current_temp; // 当前温度 (°C)
+  float cup_temp;     // 估计杯温 (°C)
+  int target_temp;    // 目标温度 (°C)
+  bool power_on;      // 电源开关
+  bool is_heating;    // 是否正在加热
+  bool sensor_ok;     // NTC传感器是否正常
+  temp_state_t state; // 温控状态
+  float duty;         // 加热器占空比 (%)
+  thermal_fault_t fault; // 故障原因
+  int32_t eta_s;         // 预计到温剩余时间 (s), 0=已到温, -1=未知/未加热
+  temp_heat_mode_t heat_mode; // 加热策略
+  bool boosting;              // 正处于全功率升温阶段
+  int8_t profile_step;        // 正在执行的程序段 (从0起), -1=无
+} temp_snapshot_t;
+
+/**
+ * @brief 命令 (开关/目标温度/自整定) 到加热器PWM更新的延迟统计
+ */
+typedef struct {
+  uint32_t count;   // 统计的命令数
+  uint32_t last_us; // 最近一次延迟 (us)
+  uint32_t max_us;  // 最大延迟 (us)
+  uint32_t avg_us;  // 平均延迟 (us)
+} temp_latency_stats_t;
+
+/**
+ * @brief PID自整定状态
+ */
+typedef struct {
+  autotune_state_t state; // 自整定状态
+  int cycles;             // 已完成的振荡周期数
+  float ku;               // 临界增益
+  float pu;               // 临界周期 (s)
+  float kp;               // 当前生效的比例系数
+  float ki;               // 当前生效的积分系数 (每控制周期)
+  float kd;               // 当前生效的微分系数 (每控制周期)
+  bool tuned;             // 当前参数是否来自自整定 (NVS)
+} temp_autotune_status_t;
+
+/**
+ * @brief 节能保温状态
+ */
+typedef struct {
+  bool enabled;       // 节能保温开启
+  bool holding;       // 已到温, 正在节能保温
+  float setpoint;     // 当前PID设定值 (°C)
+  float ambient;      // 环境温度估计 (°C)
+  float loss_w_per_k; // 学得的散热系数 (W/K), 0=未学习
+  float baseline_w;   // 普通PID在目标温度保温的估算功率 (W), <0 未知
+  float saved_wh;     // 上电以来相对普通PID节省的能量 (Wh)
+} temp_eco_status_t;
+
+/**
+ * @brief 环境温度补偿状态
+ */
+typedef struct {
+  bool sensor;        // 芯片温度传感器可用
+  bool calibrated;    // 芯片温度偏差已在冷启动时标定
+  float chip;         // 滤波后的芯片温度 (°C)
+  float offset;       // 芯片温度 - 环境温度 (°C)
+  float ambient;      // 环境温度估计 (°C)
+  float loss_w_per_k; // 学得的散热系数 (W/K), 0=未学习
+  float ff_pct;       // 当前设定值的前馈占空比 (%)
+} temp_ambient_status_t;
+
+/**
+ * @brief 能量计量 (指令占空比 * CONFIG_HEATER_POWER_W 积分)
+ */
+typedef struct {
+  float session_wh;   // 本次开机耗电 (Wh), 关机后保留到下次开机
+  uint32_t session_s; // 本次开机时长 (s)
+  float day_wh;       // 当天耗电 (Wh)
+  float lifetime_wh;  // 累计耗电 (Wh)
+  float power_w;      // 当前加热功率 (W)
+  int heater_w;       // 满占空比加热功率 (W)
+  uint32_t day;       // 当天计数的日期 (YYYYMMDD), 0=RTC未同步
+} temp_energy_stats_t;
+
+/**
+ * @brief 温度程序执行状态
+ */
+typedef struct {
+  profile_phase_t phase;     // 执行阶段
+  int step;                  // 当前段 (从0起)
+  int n_steps;               // 程序总段数
+  float setpoint;            // 当前PID设定值 (°C)
+  uint32_t hold_remaining_s; // 当前段剩余保持时间 (s)
+} temp_profile_status_t;
+
 /**
  * @brief 初始化温控模块
  *
@@ -36,7 +147,7 @@ esp_err_t temp_control_init(void);
 /**
  * @brief 启动温控任务
  *
- * 创建FreeRTOS任务进行周期性温控
+ * 创建FreeRTOS任务进行周期性温控，设置类接口会立即唤醒任务执行一次控制
  */
 void temp_control_start_task(void);
 
@@ -99,6 +210,243 @@ temp_state_t temp_control_get_state(void);
  */
 bool temp_control_is_sensor_ok(void);
 
+/**
+ * @brief 获取一致的温控状态快照
+ *
+ * 无锁读取 (seqlock)，不会阻塞温控任务。需要多个状态时
+ * 应使用本接口，而不是连续调用各单项 getter
+ *
+ * @param snap 输出快照
+ */
+void temp_control_get_snapshot(temp_snapshot_t *snap);
+
+/**
+ * @brief 启动PID自整定
+ *
+ * 以继电方式 (0%/100%) 驱动加热器在目标温度附近振荡，
+ * 完成后计算PID参数并保存到NVS，下次启动自动加载
+ *
+ * @param setpoint 自整定目标温度 (30-90°C)
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_STATE 传感器异常
+ */
+esp_err_t temp_control_start_autotune(int setpoint);
+
+/**
+ * @brief 中止PID自整定
+ */
+void temp_control_cancel_autotune(void);
+
+/**
+ * @brief 清除NVS中的自整定参数，恢复Kconfig默认PID参数
+ *
+ * @return esp_err_t ESP_OK 成功
+ */
+esp_err_t temp_control_reset_pid_gains(void);
+
+/**
+ * @brief 获取PID自整定状态
+ *
+ * @param status 输出状态
+ */
+void temp_control_get_autotune_status(temp_autotune_status_t *status);
+
+/**
+ * @brief 获取故障原因
+ *
+ * 升温失败/热失控/变化率异常/读数卡死会锁定故障并关闭加热，
+ * 清除前不能重新开启加热
+ *
+ * @return thermal_fault_t 当前 (或最近一次超温) 故障原因
+ */
+thermal_fault_t temp_control_get_fault(void);
+
+/**
+ * @brief 清除锁定的热保护故障
+ */
+void temp_control_clear_fault(void);
+
+/**
+ * @brief 获取在线辨识的热模型 (一阶加纯滞后)
+ *
+ * @param params 输出参数, params->valid 为 false 时其余字段无意义
+ */
+void temp_control_get_model(fopdt_params_t *params);
+
+/**
+ * @brief 设置加热策略
+ *
+ * 切换后下一控制周期按新策略重新判断是否全功率升温；
+ * 混合模式下每次开机或修改目标温度且低于目标超过
+ * CONFIG_HEAT_BOOST_MIN_STEP 时先以满占空比加热。
+ * 级联模式下目标温度指杯温 (观测器估计)，加热板设定值由外环给出，
+ * 不超过 CONFIG_CASCADE_PLATE_MAX；PID每 CONFIG_CASCADE_INNER_PERIOD_MS
+ * 调节一次加热板，节能保温不生效
+ *
+ * @param mode 加热策略
+ */
+void temp_control_set_heat_mode(temp_heat_mode_t mode);
+
+/**
+ * @brief 获取加热策略
+ *
+ * @return temp_heat_mode_t 当前加热策略
+ */
+temp_heat_mode_t temp_control_get_heat_mode(void);
+
+/**
+ * @brief 加热策略字符串
+ *
+ * @param mode 加热策略
+ * @return const char* "pid", "boost" 或 "cascade"
+ */
+const char *temp_heat_mode_to_string(temp_heat_mode_t mode);
+
+/**
+ * @brief 开关节能保温
+ *
+ * 开启后到温时把设定值降到保温带 [目标-CONFIG_ECO_BAND, 目标] 下沿附近，
+ * 并按学得的散热模型统计相对普通PID节省的能量；温度程序执行时不生效
+ *
+ * @param enable true=节能保温, false=普通PID保持目标温度
+ */
+void temp_control_set_eco(bool enable);
+
+/**
+ * @brief 获取节能保温开关
+ *
+ * @return true 节能保温开启
+ */
+bool temp_control_get_eco(void);
+
+/**
+ * @brief 获取节能保温状态
+ *
+ * @param status 输出状态
+ */
+void temp_control_get_eco_status(temp_eco_status_t *status);
+
+/**
+ * @brief 获取环境温度补偿状态
+ *
+ * 芯片内部温度减去偏差作为环境温度，用于PID前馈和热模型；
+ * 未启用 CONFIG_AMBIENT_COMPENSATION 时 status->sensor 为 false
+ *
+ * @param status 输出状态
+ */
+void temp_control_get_ambient_status(temp_ambient_status_t *status);
+
+/**
+ * @brief 校验并保存温度程序到NVS
+ *
+ * @param prog 温度程序
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_ARG 段数或温度超范围
+ */
+esp_err_t temp_control_save_profile(const profile_t *prog);
+
+/**
+ * @brief 从NVS读取已保存的温度程序
+ *
+ * @param prog 输出温度程序
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_NOT_FOUND 未保存
+ */
+esp_err_t temp_control_load_profile(profile_t *prog);
+
+/**
+ * @brief 开始执行温度程序
+ *
+ * 打开电源并由温控任务逐段推进设定值；手动设置目标温度、关机、
+ * 故障或开始自整定时程序停止
+ *
+ * @param prog 温度程序
+ * @return esp_err_t ESP_OK 成功, ESP_ERR_INVALID_ARG 程序无效,
+ *         ESP_ERR_INVALID_STATE 故障未清除
+ */
+esp_err_t temp_control_start_profile(const profile_t *prog);
+
+/**
+ * @brief 停止温度程序，保持当前目标温度继续控温
+ */
+void temp_control_stop_profile(void);
+
+/**
+ * @brief 获取温度程序执行状态
+ *
+ * @param status 输出状态
+ */
+void temp_control_get_profile_status(temp_profile_status_t *status);
+
+/**
+ * @brief 获取能量计量
+ *
+ * 当天/累计计数保存在NVS，有变化时每 CONFIG_ENERGY_SAVE_INTERVAL_MIN
+ * 写入一次，关机或换日后提前写入
+ *
+ * @param stats 输出计量
+ */
+void temp_control_get_energy_stats(temp_energy_stats_t *stats);
+
+/**
+ * @brief 按学得的升温曲线估计加热到目标温度所需时间 (预约提前量)
+ *
+ * 使用当前加热模式对应的曲线 (级联模式为估计杯温)。未学习时返回 -1，
+ * 由调用者使用固定的提前量
+ *
+ * @param target 目标温度 (°C)
+ * @param cold true 从环境温度起算 (提前较久估计时, 偏保守), false 从当前读数
+ * @return int32_t 所需时间 (s), 未学习返回 -1
+ */
+int32_t temp_control_get_preheat_s(int target, bool cold);
+
+/**
+ * @brief 设置升温曲线更新回调
+ *
+ * 每次升温到温、曲线保存后在温控任务中调用 (不持有温控锁)
+ *
+ * @param callback 回调函数, NULL 取消
+ */
+void temp_control_set_preheat_callback(void (*callback)(void));
+
+/**
+ * @brief 设置自动关机回调
+ *
+ * 温度程序完成并按设置关闭电源后在温控任务中调用 (不持有温控锁)
+ *
+ * @param callback 回调函数, NULL 取消
+ */
+void temp_control_set_power_off_callback(void (*callback)(void));
+
+/**
+ * @brief 上电以来加热开启的累计时长
+ *
+ * 单调递增，关机期间不变。定时关机按此计时，关机期间暂停
+ *
+ * @return int64_t 累计时长 (us)
+ */
+int64_t temp_control_get_on_time_us(void);
+
+/**
+ * @brief 清零全部能量计数 (含NVS)
+ */
+void temp_control_reset_energy(void);
+
+/**
+ * @brief 通知即将有射频发射，期间加热占空比不超过
+ * CONFIG_HEATER_TX_BACKOFF_PCT，结束后按上升斜率恢复
+ *
+ * 可在任意任务中调用 (不可在中断中调用)；未启用
+ * CONFIG_HEATER_TX_BACKOFF 时为空操作
+ *
+ * @param duration_ms 避让时长 (ms)，与尚未结束的避让取较晚者
+ */
+void temp_control_tx_backoff(uint32_t duration_ms);
+
+/**
+ * @brief 获取命令到PWM输出的延迟统计
+ *
+ * @param stats 输出统计
+ */
+void temp_control_get_latency_stats(temp_latency_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
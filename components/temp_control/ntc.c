@@ -0,0 +1,48 @@
+/**
+ * @file ntc.c
+ * @brief NTC热敏电阻电压-温度转换实现
+ */
+
+#include "ntc.h"
+#include "ntc_table.h" // 构建时生成 (gen_ntc_table.py)
+
+int32_t ntc_mv_to_centi_celsius(int voltage_mv) {
+  // 端点饱和
+  if (voltage_mv <= NTC_TABLE_MV_MIN) {
+    return s_ntc_table[0];
+  }
+  if (voltage_mv >= NTC_TABLE_MV_MAX) {
+    return s_ntc_table[NTC_TABLE_SIZE - 1];
+  }
+
+  // 定位区间，步长为常量，除法由编译器优化为移位
+  int32_t offset = voltage_mv - NTC_TABLE_MV_MIN;
+  int32_t idx = offset / NTC_TABLE_MV_STEP;
+  int32_t frac = offset - idx * NTC_TABLE_MV_STEP;
+
+  // 线性插值
+  int32_t lo = s_ntc_table[idx];
+  int32_t hi = s_ntc_table[idx + 1];
+  return lo + (hi - lo) * frac / NTC_TABLE_MV_STEP;
+}
+
+int ntc_centi_celsius_to_mv(int32_t temp_centi) {
+  // 表项随电压单调递减
+  if (temp_centi >= s_ntc_table[0]) {
+    return NTC_TABLE_MV_MIN;
+  }
+  if (temp_centi <= s_ntc_table[NTC_TABLE_SIZE - 1]) {
+    return NTC_TABLE_MV_MAX;
+  }
+
+  int32_t idx = 0;
+  while (s_ntc_table[idx + 1] > temp_centi) {
+    idx++;
+  }
+
+  // s_ntc_table[idx] > temp_centi >= s_ntc_table[idx + 1]
+  int32_t lo = s_ntc_table[idx];
+  int32_t hi = s_ntc_table[idx + 1];
+  return NTC_TABLE_MV_MIN + idx * NTC_TABLE_MV_STEP +
+         (lo - temp_centi) * NTC_TABLE_MV_STEP / (lo - hi);
+}
@@ -0,0 +1,674 @@
+/**
+ * @file ntc_sampler.c
+ * @brief NTC高速采集实现
+ */
+
+#include "ntc_sampler.h"
+#include "sdkconfig.h"
+
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "soc/soc_caps.h"
+#include <string.h>
+
+#ifndef CONFIG_NTC_FAST_TRIP
+#define CONFIG_NTC_FAST_TRIP 0
+#endif
+#ifndef CONFIG_NTC_FAST_TRIP_SAMPLES
+#define CONFIG_NTC_FAST_TRIP_SAMPLES 4
+#endif
+#if CONFIG_NTC_FAST_TRIP && SOC_ADC_MONITOR_SUPPORTED
+#define NTC_FAST_TRIP_ENABLED 1
+#include "esp_adc/adc_monitor.h"
+#else
+#define NTC_FAST_TRIP_ENABLED 0
+#endif
+
+static const char *TAG = "NtcSampler";
+
+#ifndef CONFIG_NTC_SAMPLE_FREQ_HZ
+#define CONFIG_NTC_SAMPLE_FREQ_HZ 20000
+#endif
+#ifndef CONFIG_NTC_SAMPLES_PER_FRAME
+#define CONFIG_NTC_SAMPLES_PER_FRAME 200
+#endif
+#ifndef CONFIG_NTC_MEDIAN_WINDOW
+#define CONFIG_NTC_MEDIAN_WINDOW 9
+#endif
+
+// 采样与加热PWM的同步方式
+#ifndef CONFIG_NTC_SYNC_PERIOD_AVERAGE
+#define CONFIG_NTC_SYNC_PERIOD_AVERAGE 0
+#endif
+#ifndef CONFIG_NTC_SYNC_OFF_PHASE
+#define CONFIG_NTC_SYNC_OFF_PHASE 0
+#endif
+#define NTC_SYNC_ENABLED                                                       \
+  (CONFIG_NTC_SYNC_PERIOD_AVERAGE || CONFIG_NTC_SYNC_OFF_PHASE)
+
+#define NTC_VREF_MV 3300    // 参考电压 (mV, 无校准时使用)
+#define NTC_RAW_MAX 4095    // 12位ADC满量程
+#define OVERSAMPLE_BITS 4   // 抽取值保留的过采样小数位
+#define MAX_FRAME_BYTES                                                        \
+  (CONFIG_NTC_SAMPLES_PER_FRAME * SOC_ADC_DIGI_RESULT_BYTES)
+#define MAX_CYCLE_BINS 128  // 每PWM周期最多的相位分组数
+#define OFF_PHASE_GUARD 1   // 导通相位两侧额外排除的分组 (开关瞬态)
+#define DUTY_SCALE 1000     // 占空比千分比
+#define TRIP_REARM_RAW 16   // 重新使能监视器所需的回差 (原始码值)
+#define TRIP_GAP_SAMPLES 4  // 超限中断间隔超过此采样数视为不连续
+
+// ============================================================================
+// 静态变量
+// ============================================================================
+static adc_continuous_handle_t s_adc_handle = NULL;
+static adc_cali_handle_t s_adc_cali_handle = NULL;
+static bool s_cali_enabled = false;
+static adc_channel_t s_channel;
+static uint32_t s_sample_freq_hz;
+static uint32_t s_frame_samples;
+static uint32_t s_cycle_samples; // 每PWM周期采样数, 0=不同步
+static int64_t s_stale_timeout_us;
+static volatile uint32_t s_duty_permille = 0;
+
+// 抽取值环形缓冲区 (原始码值 << OVERSAMPLE_BITS)
+static uint32_t s_ring[CONFIG_NTC_MEDIAN_WINDOW];
+static uint32_t s_ring_head = 0;
+static uint32_t s_ring_count = 0;
+static int64_t s_last_frame_us = 0;
+static ntc_sampler_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief 噪声累计 (整数, 读取时再换算)
+ */
+typedef struct {
+  uint32_t frames;
+  uint64_t var_q8_sum;  // 帧内方差累计 (LSB^2 << 8)
+  uint32_t jitter_n;
+  uint64_t jitter_sum;  // 相邻抽取值差平方累计 ((LSB/16)^2)
+} noise_accum_t;
+static noise_accum_t s_noise[NTC_NOISE_BUCKETS];
+
+// 仅采集任务使用
+static uint8_t s_frame[MAX_FRAME_BYTES];
+static uint16_t s_samples[CONFIG_NTC_SAMPLES_PER_FRAME];
+#if CONFIG_NTC_SYNC_OFF_PHASE
+static uint32_t s_bin_sum[MAX_CYCLE_BINS];
+static bool s_bin_skip[MAX_CYCLE_BINS];
+#endif
+
+#if NTC_FAST_TRIP_ENABLED
+// 快速关断 (中断与采集任务共享)
+static adc_monitor_handle_t s_monitor = NULL;
+static ntc_trip_cb_t s_trip_cb = NULL;
+static void *s_trip_arg = NULL;
+static int s_trip_limit_mv = 0;
+static int s_trip_limit_raw = -1;
+static int64_t s_trip_gap_us = 0;
+static volatile bool s_trip_armed = false;
+static volatile bool s_trip_fired = false; // 已关断, 等待采集任务暂停监视器
+static uint32_t s_trip_run = 0;            // 连续超限中断计数
+static int64_t s_trip_first_us = 0;
+static int64_t s_trip_prev_us = 0;
+static int64_t s_trip_last_us = 0;
+static ntc_trip_stats_t s_trip_stats;
+#endif
+
+// ============================================================================
+// ADC校准
+// ============================================================================
+static void cali_init(void) {
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+  adc_cali_curve_fitting_config_t cali_cfg = {
+      .unit_id = ADC_UNIT_1,
+      .atten = ADC_ATTEN_DB_12,
+      .bitwidth = ADC_BITWIDTH_12,
+  };
+  if (adc_cali_create_scheme_curve_fitting(&cali_cfg, &s_adc_cali_handle) ==
+      ESP_OK) {
+    s_cali_enabled = true;
+    ESP_LOGI(TAG, "ADC calibration enabled (curve fitting)");
+  }
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+  adc_cali_line_fitting_config_t cali_cfg = {
+      .unit_id = ADC_UNIT_1,
+      .atten = ADC_ATTEN_DB_12,
+      .bitwidth = ADC_BITWIDTH_12,
+  };
+  if (adc_cali_create_scheme_line_fitting(&cali_cfg, &s_adc_cali_handle) ==
+      ESP_OK) {
+    s_cali_enabled = true;
+    ESP_LOGI(TAG, "ADC calibration enabled (line fitting)");
+  }
+#endif
+}
+
+static int raw_to_mv(int raw) {
+  int voltage_mv = 0;
+  if (s_cali_enabled) {
+    adc_cali_raw_to_voltage(s_adc_cali_handle, raw, &voltage_mv);
+  } else {
+    // 简单线性估算
+    voltage_mv = (raw * NTC_VREF_MV) / NTC_RAW_MAX;
+  }
+  return voltage_mv;
+}
+
+/**
+ * @brief 电压转原始码值 (二分查找, 返回电压不低于 mv 的最小码值)
+ */
+static int mv_to_raw(int mv) {
+  int lo = 0;
+  int hi = NTC_RAW_MAX;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (raw_to_mv(mid) < mv) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * @brief 过采样码值转电压，相邻整数码值间线性插值
+ */
+static int code_to_mv(uint32_t code) {
+  int raw = (int)(code >> OVERSAMPLE_BITS);
+  int frac = (int)(code & ((1u << OVERSAMPLE_BITS) - 1));
+  int lo = raw_to_mv(raw);
+  if (frac == 0 || raw >= NTC_RAW_MAX) {
+    return lo;
+  }
+  int hi = raw_to_mv(raw + 1);
+  return lo + ((hi - lo) * frac >> OVERSAMPLE_BITS);
+}
+
+/**
+ * @brief 小窗口中值 (插入排序)
+ *
+ * 个数为偶数时 (窗口未填满或配置为偶数) 取中间两项的平均值
+ */
+static uint32_t median(uint32_t *values, uint32_t count) {
+  for (uint32_t i = 1; i < count; i++) {
+    uint32_t v = values[i];
+    uint32_t j = i;
+    while (j > 0 && values[j - 1] > v) {
+      values[j] = values[j - 1];
+      j--;
+    }
+    values[j] = v;
+  }
+  if (count % 2 == 0) {
+    return (values[count / 2 - 1] + values[count / 2] + 1) / 2;
+  }
+  return values[count / 2];
+}
+
+// ============================================================================
+// 采集任务
+// ============================================================================
+static bool IRAM_ATTR on_pool_ovf(adc_continuous_handle_t handle,
+                                  const adc_continuous_evt_data_t *edata,
+                                  void *user_data) {
+  s_stats.overflows++;
+  return false;
+}
+
+#if NTC_FAST_TRIP_ENABLED
+// ============================================================================
+// 快速超温关断
+// ============================================================================
+/**
+ * @brief 监视器低于门限中断
+ *
+ * 每个低于门限的转换触发一次；连续 CONFIG_NTC_FAST_TRIP_SAMPLES 次
+ * (间隔不超过 TRIP_GAP_SAMPLES 个采样周期) 才关断，单个噪声采样不会误动作
+ */
+static bool IRAM_ATTR on_below_limit(adc_monitor_handle_t handle,
+                                     const adc_monitor_evt_data_t *edata,
+                                     void *user_data) {
+  int64_t now = esp_timer_get_time();
+  s_trip_stats.events++;
+  if (s_trip_fired) {
+    return false;
+  }
+
+  if (now - s_trip_prev_us > s_trip_gap_us) {
+    s_trip_run = 0;
+    s_trip_first_us = now;
+  }
+  s_trip_prev_us = now;
+  if (++s_trip_run < CONFIG_NTC_FAST_TRIP_SAMPLES) {
+    return false;
+  }
+
+  bool yield = s_trip_cb(s_trip_arg);
+  int64_t done = esp_timer_get_time();
+
+  s_trip_fired = true;
+  s_trip_run = 0;
+  s_trip_last_us = done;
+  s_trip_stats.trips++;
+  s_trip_stats.detect_us = (uint32_t)(done - s_trip_first_us);
+  s_trip_stats.isr_us = (uint32_t)(done - now);
+  return yield;
+}
+
+/**
+ * @brief 创建并使能监视器，须在 adc_continuous_start() 之前调用
+ */
+static void trip_init(adc_channel_t channel) {
+  s_trip_limit_raw = mv_to_raw(s_trip_limit_mv);
+  s_trip_gap_us =
+      (int64_t)TRIP_GAP_SAMPLES * 1000000 / (int64_t)s_sample_freq_hz;
+
+  adc_monitor_config_t mon_cfg = {
+      .adc_unit = ADC_UNIT_1,
+      .channel = channel,
+      .h_threshold = -1, // 不使用
+      .l_threshold = s_trip_limit_raw,
+  };
+  adc_monitor_evt_cbs_t mon_cbs = {
+      .on_below_low_thresh = on_below_limit,
+  };
+  esp_err_t err = adc_new_continuous_monitor(s_adc_handle, &mon_cfg,
+                                             &s_monitor);
+  if (err == ESP_OK) {
+    err = adc_continuous_monitor_register_event_callbacks(s_monitor,
+                                                          &mon_cbs, NULL);
+  }
+  if (err == ESP_OK) {
+    err = adc_continuous_monitor_enable(s_monitor);
+  }
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Fast trip monitor unavailable: %s", esp_err_to_name(err));
+    s_monitor = NULL;
+    return;
+  }
+
+  s_trip_armed = true;
+  ESP_LOGI(TAG, "Fast trip below raw %d (%d mV), %d consecutive samples",
+           s_trip_limit_raw, s_trip_limit_mv, CONFIG_NTC_FAST_TRIP_SAMPLES);
+}
+
+/**
+ * @brief 采集任务中维护监视器
+ *
+ * 关断后暂停监视器 (超温期间每个转换都会中断)，
+ * 帧均值回到门限以上 TRIP_REARM_RAW 后重新使能
+ *
+ * @param code 本帧抽取值 (原始码值 << OVERSAMPLE_BITS)
+ */
+static void trip_service(uint32_t code) {
+  if (s_monitor == NULL) {
+    return;
+  }
+  if (s_trip_armed && s_trip_fired) {
+    if (adc_continuous_monitor_disable(s_monitor) == ESP_OK) {
+      s_trip_armed = false;
+      ESP_LOGW(TAG, "Fast trip fired (%lu us), monitor paused",
+               (unsigned long)s_trip_stats.detect_us);
+    }
+  } else if (!s_trip_armed &&
+             (int)(code >> OVERSAMPLE_BITS) >=
+                 s_trip_limit_raw + TRIP_REARM_RAW) {
+    s_trip_run = 0;
+    s_trip_fired = false;
+    if (adc_continuous_monitor_enable(s_monitor) == ESP_OK) {
+      s_trip_armed = true;
+      ESP_LOGI(TAG, "Fast trip re-armed");
+    }
+  }
+}
+#endif
+
+#if CONFIG_NTC_SYNC_OFF_PHASE
+/**
+ * @brief 标记导通相位
+ *
+ * 帧内为整数个PWM周期，按相位折叠后，导通期间的开关噪声使
+ * 连续 on 个相位的均值偏离其余相位；取偏离最大的循环窗口为导通相位，
+ * 连同两侧保护相位一起排除
+ *
+ * @return true 已标记, false 占空比过小/过大, 使用全部采样
+ */
+static bool mark_on_phase(uint32_t n, uint32_t duty_permille) {
+  const uint32_t m = s_cycle_samples;
+  uint32_t on = (duty_permille * m + DUTY_SCALE / 2) / DUTY_SCALE;
+  if (on == 0 || on + 2 * OFF_PHASE_GUARD >= m) {
+    return false;
+  }
+
+  memset(s_bin_sum, 0, sizeof(uint32_t) * m);
+  for (uint32_t i = 0; i < n; i++) {
+    s_bin_sum[i % m] += s_samples[i];
+  }
+
+  int64_t total = 0;
+  int64_t win = 0;
+  for (uint32_t k = 0; k < m; k++) {
+    total += s_bin_sum[k];
+    if (k < on) {
+      win += s_bin_sum[k];
+    }
+  }
+
+  // 比较 均值(窗口) 与 均值(其余)，交叉相乘避免除法
+  int64_t best = -1;
+  uint32_t best_start = 0;
+  for (uint32_t k = 0; k < m; k++) {
+    int64_t diff = win * (int64_t)(m - on) - (total - win) * (int64_t)on;
+    if (diff < 0) {
+      diff = -diff;
+    }
+    if (diff > best) {
+      best = diff;
+      best_start = k;
+    }
+    win += (int64_t)s_bin_sum[(k + on) % m] - (int64_t)s_bin_sum[k];
+  }
+
+  memset(s_bin_skip, 0, sizeof(bool) * m);
+  for (uint32_t k = 0; k < on + 2 * OFF_PHASE_GUARD; k++) {
+    s_bin_skip[(best_start + m - OFF_PHASE_GUARD + k) % m] = true;
+  }
+  return true;
+}
+#endif
+
+static void ntc_sampler_task(void *arg) {
+  const uint32_t frame_bytes = s_frame_samples * SOC_ADC_DIGI_RESULT_BYTES;
+  uint32_t prev_code = 0;
+  bool has_prev = false;
+
+  while (1) {
+    uint32_t len = 0;
+    esp_err_t err = adc_continuous_read(s_adc_handle, s_frame, frame_bytes,
+                                        &len, ADC_MAX_DELAY);
+    if (err != ESP_OK) {
+      continue;
+    }
+
+    // 提取本通道采样
+    uint32_t n = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len &&
+                         n < CONFIG_NTC_SAMPLES_PER_FRAME;
+         i += SOC_ADC_DIGI_RESULT_BYTES) {
+      const adc_digi_output_data_t *p =
+          (const adc_digi_output_data_t *)&s_frame[i];
+      if (p->type2.unit != ADC_UNIT_1 || p->type2.channel != s_channel) {
+        continue;
+      }
+      s_samples[n++] = p->type2.data;
+    }
+    if (n == 0) {
+      continue;
+    }
+
+    uint32_t duty_permille = s_duty_permille;
+#if CONFIG_NTC_SYNC_OFF_PHASE
+    // 有丢失采样时相位无法对齐，退化为整帧平均
+    bool use_mask =
+        n == s_frame_samples && mark_on_phase(n, duty_permille);
+#endif
+
+    // 抽取: 参与平均的采样取均值
+    uint32_t sum = 0;
+    uint64_t sum_sq = 0;
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < n; i++) {
+#if CONFIG_NTC_SYNC_OFF_PHASE
+      if (use_mask && s_bin_skip[i % s_cycle_samples]) {
+        continue;
+      }
+#endif
+      sum += s_samples[i];
+      sum_sq += (uint32_t)s_samples[i] * s_samples[i];
+      used++;
+    }
+    uint32_t code = ((sum << OVERSAMPLE_BITS) + used / 2) / used;
+
+    // 帧内方差 (LSB^2 << 8)
+    uint64_t var_q8 =
+        (((uint64_t)used * sum_sq - (uint64_t)sum * sum) << 8) /
+        ((uint64_t)used * used);
+    uint32_t bucket = duty_permille * NTC_NOISE_BUCKETS / DUTY_SCALE;
+    if (bucket >= NTC_NOISE_BUCKETS) {
+      bucket = NTC_NOISE_BUCKETS - 1;
+    }
+
+    taskENTER_CRITICAL(&s_lock);
+    s_ring[s_ring_head] = code;
+    s_ring_head = (s_ring_head + 1) % CONFIG_NTC_MEDIAN_WINDOW;
+    if (s_ring_count < CONFIG_NTC_MEDIAN_WINDOW) {
+      s_ring_count++;
+    }
+    s_last_frame_us = esp_timer_get_time();
+    s_stats.frames++;
+    s_stats.samples += n;
+
+    noise_accum_t *acc = &s_noise[bucket];
+    acc->frames++;
+    acc->var_q8_sum += var_q8;
+    if (has_prev) {
+      int32_t diff = (int32_t)code - (int32_t)prev_code;
+      acc->jitter_n++;
+      acc->jitter_sum += (uint64_t)((int64_t)diff * diff);
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    prev_code = code;
+    has_prev = true;
+
+#if NTC_FAST_TRIP_ENABLED
+    trip_service(code);
+#endif
+  }
+}
+
+// ============================================================================
+// 公开接口实现
+// ============================================================================
+esp_err_t ntc_sampler_init(adc_channel_t channel, uint32_t pwm_freq_hz) {
+  s_channel = channel;
+  s_sample_freq_hz = CONFIG_NTC_SAMPLE_FREQ_HZ;
+  s_frame_samples = CONFIG_NTC_SAMPLES_PER_FRAME;
+  s_cycle_samples = 0;
+
+#if NTC_SYNC_ENABLED
+  // 采样率取PWM频率整数倍，帧长取整数个PWM周期
+  if (pwm_freq_hz > 0) {
+    uint32_t m = CONFIG_NTC_SAMPLE_FREQ_HZ / pwm_freq_hz;
+    if (m > MAX_CYCLE_BINS) {
+      m = MAX_CYCLE_BINS;
+    }
+    if (m < 2 || m > CONFIG_NTC_SAMPLES_PER_FRAME ||
+        m * pwm_freq_hz < SOC_ADC_SAMPLE_FREQ_THRES_LOW) {
+      ESP_LOGW(TAG, "Cannot sync %d Hz sampling to %lu Hz PWM",
+               CONFIG_NTC_SAMPLE_FREQ_HZ, (unsigned long)pwm_freq_hz);
+    } else {
+      s_cycle_samples = m;
+      s_sample_freq_hz = m * pwm_freq_hz;
+      s_frame_samples = (CONFIG_NTC_SAMPLES_PER_FRAME / m) * m;
+    }
+  }
+#endif
+  s_stale_timeout_us =
+      4 * (int64_t)s_frame_samples * 1000000 / s_sample_freq_hz + 50000;
+
+  const uint32_t frame_bytes = s_frame_samples * SOC_ADC_DIGI_RESULT_BYTES;
+  adc_continuous_handle_cfg_t handle_cfg = {
+      .max_store_buf_size = frame_bytes * 4,
+      .conv_frame_size = frame_bytes,
+      .flags.flush_pool = true, // 来不及读取时丢弃旧数据
+  };
+  ESP_ERROR_CHECK(adc_continuous_new_handle(&handle_cfg, &s_adc_handle));
+
+  adc_digi_pattern_config_t pattern = {
+      .atten = ADC_ATTEN_DB_12, // 0-3.3V范围
+      .channel = channel,
+      .unit = ADC_UNIT_1,
+      .bit_width = ADC_BITWIDTH_12,
+  };
+  adc_continuous_config_t dig_cfg = {
+      .pattern_num = 1,
+      .adc_pattern = &pattern,
+      .sample_freq_hz = s_sample_freq_hz,
+      .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+      .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+  };
+  ESP_ERROR_CHECK(adc_continuous_config(s_adc_handle, &dig_cfg));
+
+  adc_continuous_evt_cbs_t cbs = {
+      .on_pool_ovf = on_pool_ovf,
+  };
+  ESP_ERROR_CHECK(
+      adc_continuous_register_event_callbacks(s_adc_handle, &cbs, NULL));
+
+  cali_init();
+
+#if NTC_FAST_TRIP_ENABLED
+  if (s_trip_cb != NULL) {
+    trip_init(channel);
+  }
+#endif
+
+  ESP_ERROR_CHECK(adc_continuous_start(s_adc_handle));
+
+  // 优先级高于温控任务，读取完成即阻塞，不占用额外CPU
+  xTaskCreate(ntc_sampler_task, "ntc_sampler", 2048, NULL, 7, NULL);
+
+  ESP_LOGI(TAG,
+           "NTC sampling at %lu Hz, %lu samples/frame (%s), median of %d",
+           (unsigned long)s_sample_freq_hz, (unsigned long)s_frame_samples,
+           s_cycle_samples == 0            ? "free-running"
+           : CONFIG_NTC_SYNC_OFF_PHASE     ? "PWM off-phase"
+                                           : "whole PWM periods",
+           CONFIG_NTC_MEDIAN_WINDOW);
+  return ESP_OK;
+}
+
+esp_err_t ntc_sampler_set_trip(int limit_mv, ntc_trip_cb_t cb, void *arg) {
+#if NTC_FAST_TRIP_ENABLED
+  if (cb == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (s_adc_handle != NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  s_trip_limit_mv = limit_mv;
+  s_trip_cb = cb;
+  s_trip_arg = arg;
+  return ESP_OK;
+#else
+  (void)limit_mv;
+  (void)cb;
+  (void)arg;
+  return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void ntc_sampler_get_trip_stats(ntc_trip_stats_t *stats) {
+  if (stats == NULL) {
+    return;
+  }
+  memset(stats, 0, sizeof(*stats));
+
+#if NTC_FAST_TRIP_ENABLED
+  taskENTER_CRITICAL(&s_lock);
+  *stats = s_trip_stats;
+  int64_t last_us = s_trip_last_us;
+  taskEXIT_CRITICAL(&s_lock);
+
+  stats->supported = s_monitor != NULL;
+  stats->armed = s_trip_armed;
+  stats->limit_raw = s_trip_limit_raw;
+  stats->age_ms =
+      last_us > 0 ? (uint32_t)((esp_timer_get_time() - last_us) / 1000) : 0;
+#endif
+}
+
+void ntc_sampler_set_duty(uint32_t duty, uint32_t duty_max) {
+  if (duty_max == 0) {
+    return;
+  }
+  if (duty > duty_max) {
+    duty = duty_max;
+  }
+  s_duty_permille = duty * DUTY_SCALE / duty_max;
+}
+
+esp_err_t ntc_sampler_read_mv(int *voltage_mv) {
+  uint32_t window[CONFIG_NTC_MEDIAN_WINDOW];
+  uint32_t count;
+  int64_t last_us;
+
+  taskENTER_CRITICAL(&s_lock);
+  count = s_ring_count;
+  last_us = s_last_frame_us;
+  memcpy(window, s_ring, sizeof(window));
+  taskEXIT_CRITICAL(&s_lock);
+
+  if (count == 0) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (esp_timer_get_time() - last_us > s_stale_timeout_us) {
+    return ESP_ERR_TIMEOUT;
+  }
+
+  // 未填满时有效数据位于前 count 项
+  *voltage_mv = code_to_mv(median(window, count));
+  return ESP_OK;
+}
+
+void ntc_sampler_get_stats(ntc_sampler_stats_t *stats) {
+  if (stats == NULL) {
+    return;
+  }
+
+  taskENTER_CRITICAL(&s_lock);
+  *stats = s_stats;
+  int64_t last_us = s_last_frame_us;
+  taskEXIT_CRITICAL(&s_lock);
+
+  stats->sample_freq_hz = s_sample_freq_hz;
+  stats->frame_samples = s_frame_samples;
+  stats->samples_per_cycle = s_cycle_samples;
+  stats->last_frame_ms =
+      last_us > 0 ? (uint32_t)((esp_timer_get_time() - last_us) / 1000) : 0;
+}
+
+void ntc_sampler_get_noise(ntc_noise_bucket_t *buckets) {
+  noise_accum_t acc[NTC_NOISE_BUCKETS];
+
+  taskENTER_CRITICAL(&s_lock);
+  memcpy(acc, s_noise, sizeof(acc));
+  taskEXIT_CRITICAL(&s_lock);
+
+  const float code_scale = (float)(1u << OVERSAMPLE_BITS);
+  for (int i = 0; i < NTC_NOISE_BUCKETS; i++) {
+    buckets[i].frames = acc[i].frames;
+    buckets[i].sample_var =
+        acc[i].frames > 0
+            ? (float)acc[i].var_q8_sum / 256.0f / (float)acc[i].frames
+            : 0.0f;
+    buckets[i].reading_jitter =
+        acc[i].jitter_n > 0 ? (float)acc[i].jitter_sum /
+                                  (code_scale * code_scale) / 2.0f /
+                                  (float)acc[i].jitter_n
+                            : 0.0f;
+  }
+}
+
+void ntc_sampler_reset_noise(void) {
+  taskENTER_CRITICAL(&s_lock);
+  memset(s_noise, 0, sizeof(s_noise));
+  taskEXIT_CRITICAL(&s_lock);
+}
@@ -17,6 +17,14 @@ void pid_init(pid_controller_t *pid, float kp, float ki, float kd) {
   pid->output_min = 0.0f;
   pid->output_max = 100.0f;
   pid->integral_max = 50.0f; // 默认积分限幅
+  pid->integral_max_cfg = pid->integral_max;
+  pid->feedforward = 0.0f;
+
+  pid->prev_measurement = 0.0f;
+  pid->d_filtered = 0.0f;
+  pid->d_filter_tau = 0.0f;
+  pid->kt = 0.0f;
+  pid->has_measurement = false;
 }
 
 void pid_set_setpoint(pid_controller_t *pid, float setpoint) {
@@ -28,6 +36,24 @@ void pid_set_output_limits(pid_controller_t *pid, float min, float max) {
   pid->output_max = max;
 }
 
+void pid_set_integral_limit(pid_controller_t *pid, float max) {
+  pid->integral_max = max;
+  pid->integral_max_cfg = max;
+}
+
+void pid_restore_integral_limit(pid_controller_t *pid) {
+  pid->integral_max = pid->integral_max_cfg;
+  if (pid->integral > pid->integral_max) {
+    pid->integral = pid->integral_max;
+  } else if (pid->integral < -pid->integral_max) {
+    pid->integral = -pid->integral_max;
+  }
+}
+
+void pid_set_feedforward(pid_controller_t *pid, float ff) {
+  pid->feedforward = ff;
+}
+
 float pid_compute(pid_controller_t *pid, float current) {
   // 计算误差
   float error = pid->setpoint - current;
@@ -42,6 +68,12 @@ float pid_compute(pid_controller_t *pid, float current) {
   } else if (pid->integral < -pid->integral_max) {
     pid->integral = -pid->integral_max;
   }
+  // 预置放宽的限幅只允许积分回落，随之收紧直至恢复配置值
+  if (pid->integral_max > pid->integral_max_cfg) {
+    float mag = pid->integral < 0.0f ? -pid->integral : pid->integral;
+    pid->integral_max =
+        mag > pid->integral_max_cfg ? mag : pid->integral_max_cfg;
+  }
   float i_term = pid->ki * pid->integral;
 
   // 微分项
@@ -49,7 +81,7 @@ float pid_compute(pid_controller_t *pid, float current) {
   pid->prev_error = error;
 
   // 计算输出
-  float output = p_term + i_term + d_term;
+  float output = p_term + i_term + d_term + pid->feedforward;
 
   // 输出限幅
   if (output > pid->output_max) {
@@ -61,7 +93,100 @@ float pid_compute(pid_controller_t *pid, float current) {
   return output;
 }
 
+float pid_compute_dt(pid_controller_t *pid, float current, float dt) {
+  if (dt <= 0.0f) {
+    dt = 1e-3f;
+  }
+
+  // 计算误差
+  float error = pid->setpoint - current;
+
+  // 比例项
+  float p_term = pid->kp * error;
+
+  // 微分项 (对测量值求导，一阶低通滤波)
+  if (!pid->has_measurement) {
+    pid->prev_measurement = current;
+    pid->d_filtered = 0.0f;
+    pid->has_measurement = true;
+  }
+  float d_raw = -(current - pid->prev_measurement) / dt;
+  pid->prev_measurement = current;
+  float alpha = dt / (pid->d_filter_tau + dt);
+  pid->d_filtered += alpha * (d_raw - pid->d_filtered);
+  float d_term = pid->kd * pid->d_filtered;
+
+  // 计算输出并限幅
+  float unsat = p_term + pid->integral + d_term + pid->feedforward;
+  float output = unsat;
+  if (output > pid->output_max) {
+    output = pid->output_max;
+  } else if (output < pid->output_min) {
+    output = pid->output_min;
+  }
+
+  // 积分项 (反算法抗饱和: 输出饱和时按差值回退积分)
+  float kt = pid->kt;
+  if (kt <= 0.0f) {
+    kt = (pid->kp > 0.0f) ? pid->ki / pid->kp : 0.0f;
+  }
+  pid->integral += (pid->ki * error + kt * (output - unsat)) * dt;
+  if (pid->integral > pid->output_max) {
+    pid->integral = pid->output_max;
+  } else if (pid->integral < -pid->output_max) {
+    pid->integral = -pid->output_max;
+  }
+
+  pid->prev_error = error;
+  return output;
+}
+
+void pid_set_derivative_filter(pid_controller_t *pid, float tau) {
+  pid->d_filter_tau = (tau > 0.0f) ? tau : 0.0f;
+}
+
+void pid_set_tracking_gain(pid_controller_t *pid, float kt) { pid->kt = kt; }
+
+void pid_preload(pid_controller_t *pid, float current, float output) {
+  float error = pid->setpoint - current;
+  float integral = 0.0f;
+  if (pid->ki > 0.0f) {
+    integral = (output - pid->feedforward - pid->kp * error) / pid->ki;
+  }
+  // 积分项须能单独维持任意输出
+  float needed = pid->ki > 0.0f ? pid->output_max / pid->ki : 0.0f;
+  if (needed > pid->integral_max) {
+    pid->integral_max = needed;
+  }
+  if (integral > pid->integral_max) {
+    integral = pid->integral_max;
+  } else if (integral < -pid->integral_max) {
+    integral = -pid->integral_max;
+  }
+  // pid_compute 先累加本次误差再计算积分项
+  pid->integral = integral - error;
+  pid->prev_error = error;
+}
+
+void pid_preload_dt(pid_controller_t *pid, float current, float output) {
+  float error = pid->setpoint - current;
+  float integral = output - pid->feedforward - pid->kp * error;
+  if (integral > pid->output_max) {
+    integral = pid->output_max;
+  } else if (integral < -pid->output_max) {
+    integral = -pid->output_max;
+  }
+  pid->integral = integral;
+  pid->prev_error = error;
+  pid->prev_measurement = current;
+  pid->d_filtered = 0.0f;
+  pid->has_measurement = true;
+}
+
 void pid_reset(pid_controller_t *pid) {
   pid->integral = 0.0f;
+  pid->integral_max = pid->integral_max_cfg;
   pid->prev_error = 0.0f;
+  pid->d_filtered = 0.0f;
+  pid->has_measurement = false;
 }
@@ -0,0 +1,120 @@
+/**
+ * @file pid_fixed.c
+ * @brief 定点PID控制算法实现 (Q16.16)
+ */
+
+#include "pid_fixed.h"
+
+void pid_fixed_init(pid_fixed_t *pid, q16_t kp, q16_t ki, q16_t kd) {
+  pid->kp = kp;
+  pid->ki = ki;
+  pid->kd = kd;
+
+  pid->setpoint = 0;
+  pid->integral = 0;
+  pid->prev_error = 0;
+
+  pid->output_min = 0;
+  pid->output_max = Q16_FROM_INT(100);
+  pid->integral_max = Q16_FROM_INT(50); // 默认积分限幅
+  pid->integral_max_cfg = pid->integral_max;
+  pid->feedforward = 0;
+}
+
+void pid_fixed_set_setpoint(pid_fixed_t *pid, q16_t setpoint) {
+  pid->setpoint = setpoint;
+}
+
+void pid_fixed_set_output_limits(pid_fixed_t *pid, q16_t min, q16_t max) {
+  pid->output_min = min;
+  pid->output_max = max;
+}
+
+void pid_fixed_set_integral_limit(pid_fixed_t *pid, q16_t max) {
+  pid->integral_max = max;
+  pid->integral_max_cfg = max;
+}
+
+void pid_fixed_restore_integral_limit(pid_fixed_t *pid) {
+  pid->integral_max = pid->integral_max_cfg;
+  if (pid->integral > pid->integral_max) {
+    pid->integral = pid->integral_max;
+  } else if (pid->integral < -pid->integral_max) {
+    pid->integral = -pid->integral_max;
+  }
+}
+
+void pid_fixed_set_feedforward(pid_fixed_t *pid, q16_t ff) {
+  pid->feedforward = ff;
+}
+
+q16_t pid_fixed_compute(pid_fixed_t *pid, q16_t current) {
+  // 计算误差
+  q16_t error = pid->setpoint - current;
+
+  // 积分项 (带限幅防止积分饱和, 先限幅再写回避免溢出)
+  int64_t integral = (int64_t)pid->integral + error;
+  if (integral > pid->integral_max) {
+    integral = pid->integral_max;
+  } else if (integral < -pid->integral_max) {
+    integral = -pid->integral_max;
+  }
+  pid->integral = (q16_t)integral;
+  // 预置放宽的限幅只允许积分回落，随之收紧直至恢复配置值
+  if (pid->integral_max > pid->integral_max_cfg) {
+    q16_t mag = pid->integral < 0 ? -pid->integral : pid->integral;
+    pid->integral_max =
+        mag > pid->integral_max_cfg ? mag : pid->integral_max_cfg;
+  }
+
+  // 三项在64位中累加 (Q32.32)，最后统一移位，减少舍入误差
+  int64_t output = (int64_t)pid->kp * error +
+                   (int64_t)pid->ki * pid->integral +
+                   (int64_t)pid->kd * ((int64_t)error - pid->prev_error);
+  pid->prev_error = error;
+  output >>= Q16_SHIFT;
+  output += pid->feedforward;
+
+  // 输出限幅
+  if (output > pid->output_max) {
+    output = pid->output_max;
+  } else if (output < pid->output_min) {
+    output = pid->output_min;
+  }
+
+  return (q16_t)output;
+}
+
+void pid_fixed_preload(pid_fixed_t *pid, q16_t current, q16_t output) {
+  q16_t error = pid->setpoint - current;
+  int64_t integral = 0;
+  if (pid->ki > 0) {
+    integral = (((int64_t)output - pid->feedforward) * Q16_ONE -
+                (int64_t)pid->kp * error) /
+               pid->ki;
+  }
+  // 积分项须能单独维持任意输出
+  if (pid->ki > 0) {
+    int64_t needed = ((int64_t)pid->output_max << Q16_SHIFT) / pid->ki;
+    if (needed > INT32_MAX / 2) {
+      needed = INT32_MAX / 2;
+    }
+    if (needed > pid->integral_max) {
+      pid->integral_max = (q16_t)needed;
+    }
+  }
+  if (integral > pid->integral_max) {
+    integral = pid->integral_max;
+  } else if (integral < -pid->integral_max) {
+    integral = -pid->integral_max;
+  }
+  // pid_fixed_compute 先累加本次误差再计算积分项
+  pid->integral = (q16_t)(integral - error);
+  pid->prev_error = error;
+}
+
+void pid_fixed_reset(pid_fixed_t *pid) {
+  pid->integral = 0;
+  pid->integral_max = pid->integral_max_cfg;
+  pid->prev_error = 0;
+}
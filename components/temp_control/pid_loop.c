@@ -0,0 +1,109 @@
+/**
+ * @file pid_loop.c
+ * @brief PID控制步骤实现
+ */
+
+#include "pid_loop.h"
+
+void pid_loop_init(pid_loop_t *p, const pid_loop_config_t *cfg, float kp,
+                   float ki, float kd) {
+  p->cfg = *cfg;
+  p->ff = 0.0f;
+  // 参数按控制周期整定，计算步长更短时按步长换算每步参数
+  const float ratio = cfg->step_s / cfg->period_s;
+
+  switch (cfg->engine) {
+  case PID_LOOP_FIXED:
+    // 浮点仅用于初始化时的参数转换
+    pid_fixed_init(&p->pid_q, Q16_FROM_FLOAT(kp), Q16_FROM_FLOAT(ki * ratio),
+                   Q16_FROM_FLOAT(kd / ratio));
+    pid_fixed_set_output_limits(&p->pid_q, 0, Q16_FROM_INT(cfg->cap_percent));
+    // 积分累加的是每步误差，保持积分项 (ki*积分) 的上限不变
+    pid_fixed_set_integral_limit(&p->pid_q,
+                                 (q16_t)((float)p->pid_q.integral_max / ratio));
+    break;
+  case PID_LOOP_TIME_AWARE:
+    // 换算为按秒计的 ki (1/s) 和 kd (s)
+    pid_init(&p->pid, kp, ki / cfg->period_s, kd * cfg->period_s);
+    pid_set_output_limits(&p->pid, 0, (float)cfg->cap_percent);
+    pid_set_derivative_filter(&p->pid, cfg->d_filter_s);
+    break;
+  default:
+    pid_init(&p->pid, kp, ki * ratio, kd / ratio);
+    pid_set_output_limits(&p->pid, 0, (float)cfg->cap_percent);
+    pid_set_integral_limit(&p->pid, p->pid.integral_max / ratio);
+    break;
+  }
+}
+
+void pid_loop_reset(pid_loop_t *p) {
+  if (p->cfg.engine == PID_LOOP_FIXED) {
+    pid_fixed_reset(&p->pid_q);
+  } else {
+    pid_reset(&p->pid);
+  }
+}
+
+void pid_loop_restore_integral_limit(pid_loop_t *p) {
+  if (p->cfg.engine == PID_LOOP_FIXED) {
+    pid_fixed_restore_integral_limit(&p->pid_q);
+  } else {
+    pid_restore_integral_limit(&p->pid);
+  }
+}
+
+void pid_loop_set_feedforward(pid_loop_t *p, float ff) {
+  const float cap = (float)p->cfg.cap_percent;
+  p->ff = ff < 0.0f ? 0.0f : (ff < cap ? ff : cap);
+  if (p->cfg.engine == PID_LOOP_FIXED) {
+    pid_fixed_set_feedforward(&p->pid_q, Q16_FROM_FLOAT(p->ff));
+  } else {
+    pid_set_feedforward(&p->pid, p->ff);
+  }
+}
+
+void pid_loop_preload(pid_loop_t *p, int32_t temp_centi,
+                      int32_t setpoint_centi, float duty_percent) {
+  if (p->cfg.engine == PID_LOOP_FIXED) {
+    pid_fixed_set_setpoint(&p->pid_q, q16_from_centi(setpoint_centi));
+    pid_fixed_preload(&p->pid_q, q16_from_centi(temp_centi),
+                      Q16_FROM_FLOAT(duty_percent));
+    return;
+  }
+
+  float temp = (float)temp_centi * 0.01f;
+  pid_set_setpoint(&p->pid, (float)setpoint_centi * 0.01f);
+  if (p->cfg.engine == PID_LOOP_TIME_AWARE) {
+    pid_preload_dt(&p->pid, temp, duty_percent);
+  } else {
+    pid_preload(&p->pid, temp, duty_percent);
+  }
+}
+
+uint32_t pid_loop_run(pid_loop_t *p, int32_t temp_centi,
+                      int32_t setpoint_centi, float dt, bool *is_heating) {
+  if (p->cfg.engine == PID_LOOP_FIXED) {
+    pid_fixed_set_setpoint(&p->pid_q, q16_from_centi(setpoint_centi));
+    q16_t out = pid_fixed_compute(&p->pid_q, q16_from_centi(temp_centi));
+    *is_heating = out > Q16_FROM_INT(PID_LOOP_HEATING_PERCENT);
+    if (out < 0) {
+      out = 0;
+    } else if (out > Q16_FROM_INT(100)) {
+      out = Q16_FROM_INT(100);
+    }
+    return (uint32_t)(((int64_t)out * p->cfg.drive_full / 100) >> Q16_SHIFT);
+  }
+
+  float temp = (float)temp_centi * 0.01f;
+  pid_set_setpoint(&p->pid, (float)setpoint_centi * 0.01f);
+  float out = p->cfg.engine == PID_LOOP_TIME_AWARE
+                  ? pid_compute_dt(&p->pid, temp, dt)
+                  : pid_compute(&p->pid, temp);
+  *is_heating = out > (float)PID_LOOP_HEATING_PERCENT;
+  if (out < 0.0f) {
+    out = 0.0f;
+  } else if (out > 100.0f) {
+    out = 100.0f;
+  }
+  return (uint32_t)(out * (float)p->cfg.drive_full / 100.0f + 0.5f);
+}
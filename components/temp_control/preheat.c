@@ -0,0 +1,153 @@
+/**
+ * @file preheat.c
+ * @brief 由实测升温曲线学习预约提前量实现
+ */
+
+#include "preheat.h"
+#include <math.h>
+#include <string.h>
+
+#define CURVE_ALPHA 0.3f      // 跨次升温的指数平均系数
+#define SEC_PER_C_MAX 3600.0f // 超过此值视为无效数据 (s/°C)
+
+static void learn(float *value, float sample) {
+  if (*value <= 0.0f) {
+    *value = sample;
+  } else {
+    *value += CURVE_ALPHA * (sample - *value);
+  }
+}
+
+void preheat_curve_init(preheat_curve_t *c) { memset(c, 0, sizeof(*c)); }
+
+bool preheat_curve_valid(const preheat_curve_t *c) {
+  for (int b = 0; b < PREHEAT_BINS; b++) {
+    if (!(c->sec_per_c[b] <= SEC_PER_C_MAX)) { // 同时排除 NaN
+      return false;
+    }
+  }
+  return c->approach_s <= SEC_PER_C_MAX * PREHEAT_BIN_C;
+}
+
+void preheat_start(preheat_rec_t *r, float approach, float temp, float target,
+                   float t) {
+  r->active = true;
+  r->approach = approach;
+  r->target = target;
+  r->last_temp = temp;
+  r->last_t = t;
+  // 起始读数所在的分段不完整，从其上沿开始计
+  r->next_edge = (int)floorf(temp / PREHEAT_BIN_C) + 1;
+  r->edge_t = -1.0f;
+  r->approach_t = -1.0f;
+}
+
+/**
+ * @brief 上一采样到本采样之间读数穿越 level 的时刻
+ */
+static float cross_time(const preheat_rec_t *r, float level, float temp,
+                        float t) {
+  float dy = temp - r->last_temp;
+  if (dy <= 0.0f) {
+    return t;
+  }
+  return r->last_t + (level - r->last_temp) / dy * (t - r->last_t);
+}
+
+bool preheat_update(preheat_rec_t *r, preheat_curve_t *c, float temp, float t,
+                    bool ready, float max_gap) {
+  if (!r->active) {
+    return false;
+  }
+  if (t - r->last_t > max_gap) {
+    preheat_start(r, r->approach, temp, r->target, t);
+    return false;
+  }
+
+  // 全功率段: 只计整段都低于 目标-approach 的分段
+  const float from = r->target - r->approach;
+  while (r->next_edge <= PREHEAT_BINS) {
+    float edge = (float)(r->next_edge * PREHEAT_BIN_C);
+    if (temp < edge || edge > from) {
+      break;
+    }
+    float tc = cross_time(r, edge, temp, t);
+    if (r->edge_t >= 0.0f) {
+      float rate = (tc - r->edge_t) / PREHEAT_BIN_C;
+      if (rate > 0.0f && rate <= SEC_PER_C_MAX) {
+        learn(&c->sec_per_c[r->next_edge - 1], rate);
+      }
+    }
+    r->edge_t = tc;
+    r->next_edge++;
+  }
+
+  if (r->approach_t < 0.0f && r->last_temp < from && temp >= from) {
+    r->approach_t = cross_time(r, from, temp, t);
+  }
+  r->last_temp = temp;
+  r->last_t = t;
+
+  if (!ready) {
+    return false;
+  }
+  r->active = false;
+  if (r->approach_t < 0.0f) {
+    return false; // 起始读数已在 approach 段内
+  }
+  learn(&c->approach_s, t - r->approach_t);
+  c->sessions++;
+  return true;
+}
+
+/**
+ * @brief 分段速率, 未学习时取最近的已学习分段 (优先取更高温的, 偏保守)
+ */
+static float bin_rate(const preheat_curve_t *c, int b) {
+  for (int d = 0; d < PREHEAT_BINS; d++) {
+    if (b + d < PREHEAT_BINS && c->sec_per_c[b + d] > 0.0f) {
+      return c->sec_per_c[b + d];
+    }
+    if (b - d >= 0 && c->sec_per_c[b - d] > 0.0f) {
+      return c->sec_per_c[b - d];
+    }
+  }
+  return -1.0f;
+}
+
+float preheat_time(const preheat_curve_t *c, float approach, float start,
+                   float target) {
+  if (c->approach_s <= 0.0f) {
+    return -1.0f;
+  }
+  if (start >= target) {
+    return 0.0f;
+  }
+
+  const float from = target - approach;
+  if (start >= from) {
+    // 已在 approach 段内, 按剩余比例估计
+    return c->approach_s * (target - start) / approach;
+  }
+
+  float t = c->approach_s;
+  for (int b = 0; b < PREHEAT_BINS; b++) {
+    float lo = (float)(b * PREHEAT_BIN_C);
+    float hi = lo + PREHEAT_BIN_C;
+    if (lo < start) {
+      lo = start;
+    }
+    if (hi > from) {
+      hi = from;
+    }
+    if (hi <= lo) {
+      continue;
+    }
+    float rate = bin_rate(c, b);
+    if (rate < 0.0f) {
+      return -1.0f;
+    }
+    t += rate * (hi - lo);
+  }
+  return t;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file profile.c
+ * @brief 多段温度程序实现
+ */
+
+#include "profile.h"
+#include <string.h>
+
+#define REACH_BAND_CENTI 50   // 默认到温判定带 0.5°C
+#define RAMP_UNIT 6000u       // 1ms 以 0.1°C/min 变化 1/6000 个 0.01°C
+#define DT_MAX_MS 60000u      // 单步时间上限 (防止长时间停顿后跳变)
+
+bool profile_validate(const profile_t *prog, int min_temp, int max_temp) {
+  if (prog->n_steps == 0 || prog->n_steps > PROFILE_MAX_STEPS) {
+    return false;
+  }
+  for (int i = 0; i < prog->n_steps; i++) {
+    int target = prog->steps[i].target;
+    if (target < min_temp || target > max_temp) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 进入指定段
+ */
+static void enter_step(profile_run_t *run, int step) {
+  const profile_step_t *s = &run->prog.steps[step];
+  run->step = step;
+  run->ramp_acc = 0;
+  run->hold_ms = 0;
+  if (s->ramp_c10_min == 0) {
+    run->setpoint_centi = (int32_t)s->target * 100;
+    run->phase = PROFILE_PHASE_SOAK;
+  } else {
+    run->phase = PROFILE_PHASE_RAMP;
+  }
+}
+
+void profile_start(profile_run_t *run, const profile_t *prog,
+                   int32_t temp_centi) {
+  memset(run, 0, sizeof(*run));
+  run->prog = *prog;
+  run->reach_band_centi = REACH_BAND_CENTI;
+  run->setpoint_centi = temp_centi;
+  enter_step(run, 0);
+}
+
+void profile_stop(profile_run_t *run) { run->phase = PROFILE_PHASE_IDLE; }
+
+bool profile_running(const profile_run_t *run) {
+  return run->phase == PROFILE_PHASE_RAMP ||
+         run->phase == PROFILE_PHASE_SOAK || run->phase == PROFILE_PHASE_HOLD;
+}
+
+profile_event_t profile_update(profile_run_t *run, int32_t temp_centi,
+                               uint32_t dt_ms) {
+  if (!profile_running(run)) {
+    return PROFILE_EVENT_NONE;
+  }
+  if (dt_ms > DT_MAX_MS) {
+    dt_ms = DT_MAX_MS;
+  }
+
+  const profile_step_t *s = &run->prog.steps[run->step];
+  const int32_t target = (int32_t)s->target * 100;
+
+  if (run->phase == PROFILE_PHASE_RAMP) {
+    run->ramp_acc += dt_ms * s->ramp_c10_min;
+    int32_t delta = (int32_t)(run->ramp_acc / RAMP_UNIT);
+    run->ramp_acc %= RAMP_UNIT;
+    if (run->setpoint_centi < target) {
+      run->setpoint_centi += delta;
+      if (run->setpoint_centi > target) {
+        run->setpoint_centi = target;
+      }
+    } else {
+      run->setpoint_centi -= delta;
+      if (run->setpoint_centi < target) {
+        run->setpoint_centi = target;
+      }
+    }
+    if (run->setpoint_centi != target) {
+      return PROFILE_EVENT_NONE;
+    }
+    run->phase = PROFILE_PHASE_SOAK;
+  }
+
+  if (run->phase == PROFILE_PHASE_SOAK) {
+    int32_t err = temp_centi - target;
+    if (err < -run->reach_band_centi || err > run->reach_band_centi) {
+      return PROFILE_EVENT_NONE;
+    }
+    run->phase = PROFILE_PHASE_HOLD;
+    run->hold_ms = 0;
+    dt_ms = 0; // 保持时间从到温时刻起算
+  }
+
+  // 保持
+  run->hold_ms += dt_ms;
+  if (run->hold_ms < (uint32_t)s->hold_min * 60000u) {
+    return PROFILE_EVENT_NONE;
+  }
+  if (run->step + 1 < run->prog.n_steps) {
+    enter_step(run, run->step + 1);
+    return PROFILE_EVENT_STEP;
+  }
+  run->phase = PROFILE_PHASE_DONE;
+  return PROFILE_EVENT_DONE;
+}
+
+uint32_t profile_hold_remaining_s(const profile_run_t *run) {
+  if (run->phase == PROFILE_PHASE_IDLE || run->phase == PROFILE_PHASE_DONE) {
+    return 0;
+  }
+  uint32_t hold_ms = (uint32_t)run->prog.steps[run->step].hold_min * 60000u;
+  if (run->phase != PROFILE_PHASE_HOLD) {
+    return hold_ms / 1000u;
+  }
+  return run->hold_ms < hold_ms ? (hold_ms - run->hold_ms + 999u) / 1000u : 0;
+}
+
+const char *profile_phase_to_string(profile_phase_t phase) {
+  switch (phase) {
+  case PROFILE_PHASE_RAMP:
+    return "ramp";
+  case PROFILE_PHASE_SOAK:
+    return "soak";
+  case PROFILE_PHASE_HOLD:
+    return "hold";
+  case PROFILE_PHASE_DONE:
+    return "done";
+  default:
+    return "idle";
+  }
+}
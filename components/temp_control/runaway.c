@@ -0,0 +1,213 @@
+/**
+ * @file runaway.c
+ * @brief 热失控与传感器失效检测实现
+ */
+
+#include "runaway.h"
+#include <math.h>
+
+void runaway_default_config(runaway_config_t *cfg) {
+  // 升温: 平均占空比 80% 以上时每分钟至少升 0.1°C
+  // (冷杯放上时加热板满功率约升 0.5°C/min, NTC脱落时读数下降)
+  cfg->watch_period = 60.0f;
+  cfg->watch_rise = 0.1f;
+  cfg->watch_min_duty = 80.0f;
+  // 占空比不高但读数停在环境温度附近 (NTC脱落, PID未饱和) 也判定:
+  // 满占空比稳态温升按偏小取值, 维持读数所需的占空比估计偏大
+  cfg->watch_excess_duty = 25.0f;
+  cfg->full_rise = 40.0f;
+
+  // 到温后: 低于目标 10°C 且满功率 5 分钟仍未从最低点回升
+  cfg->hysteresis = 10.0f;
+  cfg->runaway_period = 300.0f;
+  cfg->runaway_duty = 90.0f;
+  cfg->runaway_recover = 0.2f;
+
+  // 加热板满功率升温约 0.25°C/s，2°C/s 以上不可能由加热引起
+  cfg->max_rate = 2.0f;
+  cfg->rate_interval = 1.0f;
+  cfg->max_rate_count = 2;
+
+  // 读数分辨率为1mV (80°C以上约0.1°C)，大占空比下的正常缓慢升温
+  // 在短窗口内也可能看不到变化，因此只判定长时间完全不变的读数
+  cfg->stuck_period = 300.0f;
+  cfg->stuck_span = 0.01f;
+  cfg->stuck_min_duty = 80.0f;
+}
+
+static void watch_restart(runaway_t *rw, float temp) {
+  rw->watch_elapsed = 0.0f;
+  rw->watch_start = temp;
+  rw->watch_duty_sum = 0.0f;
+}
+
+static void runaway_restart(runaway_t *rw, float temp) {
+  rw->runaway_elapsed = 0.0f;
+  rw->runaway_min = temp;
+  rw->runaway_duty_sum = 0.0f;
+}
+
+static void stuck_restart(runaway_t *rw, float temp) {
+  rw->stuck_elapsed = 0.0f;
+  rw->stuck_min = temp;
+  rw->stuck_max = temp;
+  rw->stuck_duty_sum = 0.0f;
+}
+
+/**
+ * @brief 窗口平均占空比超出维持当前读数所需占空比的部分 (%)
+ */
+static float excess_duty(const runaway_config_t *cfg, float temp,
+                         float ambient, float avg_duty) {
+  return avg_duty - (temp - ambient) * 100.0f / cfg->full_rise;
+}
+
+void runaway_init(runaway_t *rw, const runaway_config_t *cfg) {
+  rw->cfg = *cfg;
+  runaway_reset(rw);
+}
+
+void runaway_reset(runaway_t *rw) {
+  rw->has_prev = false;
+  rw->target = 0.0f;
+  rw->reached = false;
+  rw->rate_ref = 0.0f;
+  rw->rate_elapsed = 0.0f;
+  rw->rate_count = 0;
+  watch_restart(rw, 0.0f);
+  runaway_restart(rw, 0.0f);
+  stuck_restart(rw, 0.0f);
+}
+
+thermal_fault_t runaway_update(runaway_t *rw, float temp, float target,
+                               float duty, float ambient, float dt) {
+  const runaway_config_t *cfg = &rw->cfg;
+
+  if (rw->has_prev && target != rw->target) {
+    // 设定值连续变化 (温度程序爬升、节能保温、级联) 时窗口照常累计，
+    // 只有升高到读数跌出回差带时才重新开始升温监视
+    if (rw->reached && target > rw->target &&
+        temp < target - cfg->hysteresis) {
+      rw->reached = false;
+      watch_restart(rw, temp);
+    }
+    rw->target = target;
+  }
+  if (!rw->has_prev) {
+    // 首次运行: 开始升温监视
+    rw->has_prev = true;
+    rw->target = target;
+    rw->reached = false;
+    rw->rate_ref = temp;
+    rw->rate_elapsed = 0.0f;
+    rw->rate_count = 0;
+    watch_restart(rw, temp);
+    runaway_restart(rw, temp);
+    stuck_restart(rw, temp);
+    return THERMAL_FAULT_NONE;
+  }
+  if (dt <= 0.0f) {
+    return THERMAL_FAULT_NONE;
+  }
+
+  // 变化率 (命令唤醒时步长很短, 按最小间隔计算避免放大量化噪声)
+  rw->rate_elapsed += dt;
+  if (rw->rate_elapsed >= cfg->rate_interval) {
+    float rate = fabsf(temp - rw->rate_ref) / rw->rate_elapsed;
+    rw->rate_ref = temp;
+    rw->rate_elapsed = 0.0f;
+    if (rate > cfg->max_rate) {
+      if (++rw->rate_count >= cfg->max_rate_count) {
+        return THERMAL_FAULT_RATE;
+      }
+    } else {
+      rw->rate_count = 0;
+    }
+  }
+
+  // 读数卡死
+  rw->stuck_elapsed += dt;
+  rw->stuck_duty_sum += duty * dt;
+  if (temp < rw->stuck_min) {
+    rw->stuck_min = temp;
+  }
+  if (temp > rw->stuck_max) {
+    rw->stuck_max = temp;
+  }
+  if (rw->stuck_elapsed >= cfg->stuck_period) {
+    float avg_duty = rw->stuck_duty_sum / rw->stuck_elapsed;
+    if (avg_duty >= cfg->stuck_min_duty &&
+        rw->stuck_max - rw->stuck_min < cfg->stuck_span) {
+      return THERMAL_FAULT_STUCK;
+    }
+    stuck_restart(rw, temp);
+  }
+
+  bool below = temp < target - cfg->hysteresis;
+
+  if (!rw->reached) {
+    // 升温监视: 按窗口平均占空比 (未达 watch_min_duty 时按超出维持
+    // 读数所需的部分) 要求最小温升
+    if (temp >= target - cfg->hysteresis) {
+      rw->reached = true;
+      runaway_restart(rw, temp);
+      return THERMAL_FAULT_NONE;
+    }
+    rw->watch_elapsed += dt;
+    rw->watch_duty_sum += duty * dt;
+    if (rw->watch_elapsed >= cfg->watch_period) {
+      float avg_duty = rw->watch_duty_sum / rw->watch_elapsed;
+      float drive = avg_duty >= cfg->watch_min_duty
+                        ? avg_duty
+                        : excess_duty(cfg, temp, ambient, avg_duty);
+      float required = cfg->watch_rise * drive / 100.0f;
+      if (drive >= cfg->watch_excess_duty &&
+          temp - rw->watch_start < required) {
+        return THERMAL_FAULT_HEATING_FAILED;
+      }
+      watch_restart(rw, temp);
+    }
+    return THERMAL_FAULT_NONE;
+  }
+
+  // 到温后: 跌出回差带且满功率 (或明显超出维持读数所需) 加热仍不回升
+  if (!below) {
+    runaway_restart(rw, temp);
+    return THERMAL_FAULT_NONE;
+  }
+  rw->runaway_elapsed += dt;
+  rw->runaway_duty_sum += duty * dt;
+  if (temp < rw->runaway_min) {
+    rw->runaway_min = temp;
+  }
+  if (rw->runaway_elapsed >= cfg->runaway_period) {
+    float avg_duty = rw->runaway_duty_sum / rw->runaway_elapsed;
+    bool heating = avg_duty >= cfg->runaway_duty ||
+                   excess_duty(cfg, temp, ambient, avg_duty) >=
+                       cfg->watch_excess_duty;
+    if (heating && temp - rw->runaway_min < cfg->runaway_recover) {
+      return THERMAL_FAULT_RUNAWAY;
+    }
+    runaway_restart(rw, temp);
+  }
+  return THERMAL_FAULT_NONE;
+}
+
+const char *thermal_fault_to_string(thermal_fault_t fault) {
+  switch (fault) {
+  case THERMAL_FAULT_SENSOR:
+    return "sensor";
+  case THERMAL_FAULT_OVER_TEMP:
+    return "over_temp";
+  case THERMAL_FAULT_HEATING_FAILED:
+    return "heating_failed";
+  case THERMAL_FAULT_RUNAWAY:
+    return "runaway";
+  case THERMAL_FAULT_RATE:
+    return "rate";
+  case THERMAL_FAULT_STUCK:
+    return "stuck";
+  default:
+    return "none";
+  }
+}
@@ -4,19 +4,34 @@
  */
 
 #include "temp_control.h"
-#include "pid.h"
+#include "ambient.h"
+#include "boost.h"
+#include "cascade.h"
+#include "drive.h"
+#include "eco.h"
+#include "fopdt.h"
+#include "ntc.h"
+#include "ntc_sampler.h"
+#include "pid_loop.h"
+#include "preheat.h"
+#include "runaway.h"
 #include "sdkconfig.h"
+#include "soft_rtc.h"
 
 #include "driver/gpio.h"
 #include "driver/ledc.h"
-#include "esp_adc/adc_cali.h"
-#include "esp_adc/adc_cali_scheme.h"
-#include "esp_adc/adc_oneshot.h"
+#include "driver/temperature_sensor.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "hal/ledc_ll.h"
+#include "nvs.h"
+#include <limits.h>
 #include <math.h>
+#include <stdatomic.h>
 
 
 static const char *TAG = "TempControl";
@@ -40,16 +55,29 @@ static const char *TAG = "TempControl";
 #define HEATER_GPIO CONFIG_HEATER_PWM_PIN
 #define HEATER_LEDC_TIMER LEDC_TIMER_0
 #define HEATER_LEDC_CHANNEL LEDC_CHANNEL_0
-#define HEATER_PWM_FREQ 1000              // 1kHz PWM频率
 #define HEATER_PWM_BITS LEDC_TIMER_10_BIT // 10位分辨率 (0-1023)
+#define HEATER_DUTY_MAX ((1u << HEATER_PWM_BITS) - 1)
+
+// 驱动方式: 1kHz PWM, 或低频PWM + 逐周期sigma-delta抖动
+#ifndef CONFIG_HEATER_DRIVE_DITHER
+#define CONFIG_HEATER_DRIVE_DITHER 0
+#endif
+#ifndef CONFIG_HEATER_DITHER_FREQ_HZ
+#define CONFIG_HEATER_DITHER_FREQ_HZ 50
+#endif
+#if CONFIG_HEATER_DRIVE_DITHER
+#define HEATER_PWM_FREQ CONFIG_HEATER_DITHER_FREQ_HZ
+#else
+#define HEATER_PWM_FREQ 1000 // 1kHz PWM频率
+#endif
+// 驱动级占空比满量程 (含小数位)
+#define HEATER_DRIVE_FULL (HEATER_DUTY_MAX << DRIVE_FRAC_BITS)
 
 // ============================================================================
-// NTC热敏电阻参数 (根据实际NTC调整)
+// NTC热敏电阻参数
+// B值 / R25 / 分压电阻在 menuconfig 中配置，构建时生成查找表 (见 ntc.c)
+// 采样由 ntc_sampler.c 以DMA连续方式完成
 // ============================================================================
-#define NTC_BETA 3950.0f      // B值
-#define NTC_R25 10000.0f      // 25°C时的电阻值 (10k)
-#define NTC_SERIES_R 10000.0f // 分压电阻值 (10k)
-#define NTC_VREF_MV 3300.0f   // 参考电压 (mV)
 
 // 温度限制
 #ifndef CONFIG_TEMP_MIN
@@ -62,6 +90,26 @@ static const char *TAG = "TempControl";
 #define CONFIG_TEMP_HARD_LIMIT 95
 #endif
 
+// 热失控保护
+#ifndef CONFIG_THERMAL_PROTECTION
+#define CONFIG_THERMAL_PROTECTION 0
+#endif
+#ifndef CONFIG_THERMAL_WATCH_PERIOD_S
+#define CONFIG_THERMAL_WATCH_PERIOD_S 60
+#endif
+#ifndef CONFIG_THERMAL_WATCH_RISE_C10
+#define CONFIG_THERMAL_WATCH_RISE_C10 1
+#endif
+#ifndef CONFIG_THERMAL_FULL_DUTY_RISE
+#define CONFIG_THERMAL_FULL_DUTY_RISE 40
+#endif
+#ifndef CONFIG_THERMAL_RUNAWAY_HYSTERESIS
+#define CONFIG_THERMAL_RUNAWAY_HYSTERESIS 10
+#endif
+#ifndef CONFIG_THERMAL_RUNAWAY_PERIOD_S
+#define CONFIG_THERMAL_RUNAWAY_PERIOD_S 300
+#endif
+
 // PID参数 (从Kconfig读取，除以100得到实际值)
 #ifndef CONFIG_PID_KP
 #define CONFIG_PID_KP 200
@@ -73,69 +121,321 @@ static const char *TAG = "TempControl";
 #define CONFIG_PID_KD 50
 #endif
 
+// PID引擎: 0=浮点, 1=Q16.16定点
+#ifndef CONFIG_PID_ENGINE_FIXED
+#define CONFIG_PID_ENGINE_FIXED 0
+#endif
+
+// 控制周期 (PID参数按每周期整定)
+#ifndef CONFIG_TEMP_CONTROL_PERIOD_MS
+#define CONFIG_TEMP_CONTROL_PERIOD_MS 500
+#endif
+
+// 时间感知PID (实测dt + 测量值微分 + 反算抗饱和), 仅浮点引擎
+#ifndef CONFIG_PID_TIME_AWARE
+#define CONFIG_PID_TIME_AWARE 0
+#endif
+#ifndef CONFIG_PID_D_FILTER_MS
+#define CONFIG_PID_D_FILTER_MS 2000
+#endif
+
+// Kconfig 选择的PID计算方式
+#if CONFIG_PID_ENGINE_FIXED
+#define PID_ENGINE PID_LOOP_FIXED
+#elif CONFIG_PID_TIME_AWARE
+#define PID_ENGINE PID_LOOP_TIME_AWARE
+#else
+#define PID_ENGINE PID_LOOP_FLOAT
+#endif
+
+// 全功率升温 + PID 混合模式
+#ifndef CONFIG_HEAT_BOOST_DEFAULT
+#define CONFIG_HEAT_BOOST_DEFAULT 0
+#endif
+#ifndef CONFIG_HEAT_BOOST_MIN_STEP
+#define CONFIG_HEAT_BOOST_MIN_STEP 5
+#endif
+
+// 节能保温
+#ifndef CONFIG_ECO_KEEP_WARM_DEFAULT
+#define CONFIG_ECO_KEEP_WARM_DEFAULT 0
+#endif
+#ifndef CONFIG_ECO_BAND
+#define CONFIG_ECO_BAND 3
+#endif
+#ifndef CONFIG_HEATER_POWER_W
+#define CONFIG_HEATER_POWER_W 15
+#endif
+
+// 加热驱动级: 功率上限 (W, 0=不限) / 上升斜率 (%/s, 0=不限) / 射频发射避让
+#ifndef CONFIG_HEATER_POWER_CAP_W
+#define CONFIG_HEATER_POWER_CAP_W 0
+#endif
+#ifndef CONFIG_HEATER_SLEW_PCT_S
+#define CONFIG_HEATER_SLEW_PCT_S 50
+#endif
+#ifndef CONFIG_HEATER_TX_BACKOFF
+#define CONFIG_HEATER_TX_BACKOFF 0
+#endif
+#ifndef CONFIG_HEATER_TX_BACKOFF_PCT
+#define CONFIG_HEATER_TX_BACKOFF_PCT 30
+#endif
+
+// 功率上限对应的最大占空比 (%), PID输出/自整定/到温预测均以此为满量程
+#if CONFIG_HEATER_POWER_CAP_W > 0 &&                                           \
+    CONFIG_HEATER_POWER_CAP_W < CONFIG_HEATER_POWER_W
+#define HEATER_CAP_PERCENT                                                     \
+  (100 * CONFIG_HEATER_POWER_CAP_W / CONFIG_HEATER_POWER_W)
+#else
+#define HEATER_CAP_PERCENT 100
+#endif
+
+// 驱动级推进周期 (us): 爬升/射频避让期间; 抖动时每个PWM周期一次
+#if CONFIG_HEATER_DRIVE_DITHER
+#define DRIVE_STEP_US (1000000 / HEATER_PWM_FREQ)
+#else
+#define DRIVE_STEP_US 20000
+#endif
+
+// 能量计量: 定期保存间隔 (min)
+#ifndef CONFIG_ENERGY_SAVE_INTERVAL_MIN
+#define CONFIG_ENERGY_SAVE_INTERVAL_MIN 10
+#endif
+
+// 环境温度补偿: 芯片内部温度传感器作环境温度代理
+#ifndef CONFIG_AMBIENT_COMPENSATION
+#define CONFIG_AMBIENT_COMPENSATION 1
+#endif
+#ifndef CONFIG_AMBIENT_CHIP_OFFSET_C
+#define CONFIG_AMBIENT_CHIP_OFFSET_C 8
+#endif
+
+// 级联控温: 内环周期、加热板设定值上限和两节点热模型
+#ifndef CONFIG_CASCADE_INNER_PERIOD_MS
+#define CONFIG_CASCADE_INNER_PERIOD_MS 100
+#endif
+#ifndef CONFIG_CASCADE_PLATE_MAX
+#define CONFIG_CASCADE_PLATE_MAX 80
+#endif
+#ifndef CONFIG_CASCADE_PLATE_CAP_J_K
+#define CONFIG_CASCADE_PLATE_CAP_J_K 60
+#endif
+#ifndef CONFIG_CASCADE_CUP_CAP_J_K
+#define CONFIG_CASCADE_CUP_CAP_J_K 1200
+#endif
+#ifndef CONFIG_CASCADE_G_PLATE_AMB_MW_K
+#define CONFIG_CASCADE_G_PLATE_AMB_MW_K 80
+#endif
+#ifndef CONFIG_CASCADE_G_PLATE_CUP_MW_K
+#define CONFIG_CASCADE_G_PLATE_CUP_MW_K 500
+#endif
+#ifndef CONFIG_CASCADE_G_CUP_AMB_MW_K
+#define CONFIG_CASCADE_G_CUP_AMB_MW_K 150
+#endif
+
+// 输出超过该占空比认为在加热 (%)
+#define HEATING_DUTY_THRESHOLD PID_LOOP_HEATING_PERCENT
+
+// 快照读取冲突时自旋次数，超过后让出CPU
+#define SNAPSHOT_SPIN_LIMIT 4
+
+// 自整定继电回差 (°C)
+#define AUTOTUNE_HYSTERESIS 0.5f
+
+// 热模型辨识与到温预测
+#define MODEL_SAMPLE_PERIOD_S 5.0f // 辨识采样周期 (s)
+#define READY_BAND 0.5f            // 读数达到 目标-READY_BAND 视为到温 (°C)
+#define ETA_LEARN_MIN_S 60.0f      // 预测时间超过此值才用于修正比例 (s)
+#define ETA_SCALE_MIN 0.5f         // 修正比例范围
+#define ETA_SCALE_MAX 4.0f
+
+// 预约提前量学习
+#define PREHEAT_APPROACH_C 5.0f // 接近段: PID在目标下方此范围内减小输出 (°C)
+#define PREHEAT_MAX_GAP_S 5.0f  // 采样间隔超过此值 (传感器异常) 重新记录 (s)
+#define PREHEAT_CURVES 2        // [0] 读数, [1] 估计杯温 (级联模式)
+
+// 环境温度估计: 加热停止足够久后开机时的读数
+#define AMBIENT_DEFAULT 25.0f // 未测得时的假设值 (°C)
+#define AMBIENT_MAX 40.0f     // 高于此读数说明加热板尚未冷却 (°C)
+#define AMBIENT_IDLE_S 1800   // 加热停止超过此时间后开机才测量 (s)
+
+// 散热系数相对已保存值变化超过此比例时写入NVS
+#define AMBIENT_SAVE_CHANGE 0.05f
+
+// 级联模式的到温预测为逐步仿真，按此间隔重新计算 (s)
+#define CASCADE_ETA_INTERVAL_S 5
+
+// 关机、换日或清零后尽快保存能量计数，但两次写入至少间隔此时间 (s)
+#define ENERGY_SAVE_MIN_S 60
+
+// NVS 存储的 key
+#define NVS_NAMESPACE "temp_ctrl"
+#define NVS_KEY_PID_GAINS "pid_gains"
+#define NVS_KEY_PROFILE "profile"
+#define NVS_KEY_ENERGY "energy"
+#define NVS_KEY_AMBIENT "ambient"
+#define NVS_KEY_PREHEAT "preheat"
+
+/**
+ * @brief PID参数 (每控制周期)
+ */
+typedef struct {
+  float kp;
+  float ki;
+  float kd;
+} pid_gains_t;
+
+/**
+ * @brief NVS中保存的PID参数 (记录整定时的控制周期以便换算)
+ */
+typedef struct {
+  uint32_t period_ms;
+  pid_gains_t gains;
+} stored_pid_gains_t;
+
+/**
+ * @brief NVS中保存的能量计数
+ */
+typedef struct {
+  uint32_t day;      // 当天计数对应的日期 (YYYYMMDD)
+  double day_j;      // 当天耗电 (J)
+  double lifetime_j; // 累计耗电 (J)
+} stored_energy_t;
+
+/**
+ * @brief NVS中保存的环境温度补偿参数 (与硬件有关，与环境温度无关)
+ */
+typedef struct {
+  uint8_t calibrated; // 芯片温度偏差已标定
+  float offset;       // 芯片温度 - 环境温度 (°C)
+  float loss;         // 散热系数 (%/K), <=0 未学习
+} stored_ambient_t;
+
+/**
+ * @brief NVS中保存的升温曲线
+ */
+typedef struct {
+  preheat_curve_t curves[PREHEAT_CURVES];
+} stored_preheat_t;
+
 // ============================================================================
 // 静态变量
 // ============================================================================
-static adc_oneshot_unit_handle_t s_adc_handle = NULL;
-static adc_cali_handle_t s_adc_cali_handle = NULL;
-static bool s_cali_enabled = false;
-
-static pid_controller_t s_pid;
+static pid_loop_t s_pid;
+#if CONFIG_PID_TIME_AWARE
+static int64_t s_pid_last_us = 0; // 上次PID计算时间 (0=无效)
+#endif
+static pid_gains_t s_gains;   // 当前生效的PID参数
+static bool s_gains_tuned = false;
+static autotune_t s_autotune; // 自整定器
+static int64_t s_autotune_last_us = 0; // 上次自整定更新时间 (0=无效)
 
 static bool s_power_on = false;
-static int s_target_temp = 55;       // 默认目标温度
-static float s_current_temp = 25.0f; // 当前温度
+static int s_target_temp = 55;          // 默认目标温度
+static int32_t s_setpoint_centi = 5500; // PID设定值 (0.01°C)
+static float s_current_temp = 25.0f;    // 当前温度
 static bool s_is_heating = false;
 static temp_state_t s_state = TEMP_STATE_IDLE;
 static bool s_sensor_ok = true;
+static float s_heater_duty = 0.0f; // 当前加热占空比 (%)
+static thermal_fault_t s_fault = THERMAL_FAULT_NONE;
+static temp_heat_mode_t s_heat_mode =
+    CONFIG_HEAT_BOOST_DEFAULT ? TEMP_HEAT_MODE_BOOST : TEMP_HEAT_MODE_PID;
 
-static SemaphoreHandle_t s_mutex = NULL;
+// 全功率升温阶段
+static boost_t s_boost;
+static bool s_boost_arm = false;     // 下一控制周期重新判断是否全功率升温
+static int64_t s_boost_last_us = 0; // 上次更新时间 (0=无效)
 
-// ============================================================================
-// ADC 初始化
-// ============================================================================
-static esp_err_t adc_init(void) {
-  // 创建ADC单元
-  adc_oneshot_unit_init_cfg_t init_cfg = {
-      .unit_id = ADC_UNIT_1,
-  };
-  ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_cfg, &s_adc_handle));
+#if CONFIG_THERMAL_PROTECTION
+static runaway_t s_runaway;         // 热失控检测器
+static int64_t s_protect_last_us = 0; // 上次检测时间 (0=无效)
+#endif
 
-  // 配置ADC通道
-  adc_oneshot_chan_cfg_t chan_cfg = {
-      .bitwidth = ADC_BITWIDTH_12,
-      .atten = ADC_ATTEN_DB_12, // 0-3.3V范围
-  };
-  ESP_ERROR_CHECK(
-      adc_oneshot_config_channel(s_adc_handle, NTC_ADC_CHANNEL, &chan_cfg));
-
-  // 尝试ADC校准
-#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
-  adc_cali_curve_fitting_config_t cali_cfg = {
-      .unit_id = ADC_UNIT_1,
-      .atten = ADC_ATTEN_DB_12,
-      .bitwidth = ADC_BITWIDTH_12,
-  };
-  if (adc_cali_create_scheme_curve_fitting(&cali_cfg, &s_adc_cali_handle) ==
-      ESP_OK) {
-    s_cali_enabled = true;
-    ESP_LOGI(TAG, "ADC calibration enabled (curve fitting)");
-  }
-#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
-  adc_cali_line_fitting_config_t cali_cfg = {
-      .unit_id = ADC_UNIT_1,
-      .atten = ADC_ATTEN_DB_12,
-      .bitwidth = ADC_BITWIDTH_12,
-  };
-  if (adc_cali_create_scheme_line_fitting(&cali_cfg, &s_adc_cali_handle) ==
-      ESP_OK) {
-    s_cali_enabled = true;
-    ESP_LOGI(TAG, "ADC calibration enabled (line fitting)");
-  }
+// 节能保温
+static bool s_eco_enabled = CONFIG_ECO_KEEP_WARM_DEFAULT;
+static eco_t s_eco;
+static int64_t s_eco_last_us = 0;         // 上次更新时间 (0=无效)
+static float s_ambient = AMBIENT_DEFAULT; // 环境温度估计 (°C)
+static int64_t s_heat_last_us = 0;        // 最近一次加热的时间 (0=开机后未加热)
+
+// 环境温度补偿
+#if CONFIG_AMBIENT_COMPENSATION
+static temperature_sensor_handle_t s_tsens = NULL;
+static ambient_t s_amb;
+static int64_t s_amb_last_us = 0;     // 上次更新时间 (0=无效)
+static float s_amb_saved_loss = 0.0f; // NVS中的散热系数
+static bool s_amb_dirty = false;      // 标定或散热系数待保存
+static int s_ff_ambient_c10 = INT_MIN; // 前馈量对应的环境温度 (0.1°C)
 #endif
+// 前馈量在散热系数、环境温度或设定值变化时才重新计算
+static bool s_ff_stale = true;
+static int32_t s_ff_setpoint_centi = 0; // 前馈量对应的设定值 (0.01°C)
 
-  return ESP_OK;
-}
+// 级联控温 (观测器在所有模式下运行, 快照中的杯温始终有效)
+static cascade_t s_cascade;
+static int64_t s_cascade_last_us = 0;  // 上次观测时间 (0=无效)
+static int64_t s_cascade_outer_us = 0; // 上次外环更新时间 (0=无效)
+static int64_t s_cascade_eta_us = 0;   // 上次到温预测时间
+
+// 加热驱动级
+static drive_t s_drive;
+static esp_timer_handle_t s_drive_timer = NULL;
+static bool s_drive_timer_on = false; // 推进定时器运行中
+static int64_t s_drive_last_us = 0;   // 上次推进时间 (0=无效)
+static int64_t s_tx_until_us = 0;     // 射频避让截止时间
+
+// 能量计量 (按指令占空比 * 加热功率积分)
+static double s_session_j = 0.0;      // 本次开机耗电 (J)
+static double s_day_j = 0.0;          // 当天耗电 (J)
+static double s_lifetime_j = 0.0;     // 累计耗电 (J)
+static int64_t s_session_us = 0;      // 本次开机时长 (us)
+static int64_t s_on_us = 0;           // 上电以来累计开机时长 (us)
+static int64_t s_energy_last_us = 0;  // 上次积分时间 (0=无效)
+static uint32_t s_energy_day = 0;     // 当天计数的日期 (0=RTC未同步)
+static uint32_t s_stored_day = 0;     // NVS中的日期
+static double s_stored_day_j = 0.0;   // NVS中该日期的耗电 (J)
+static bool s_energy_dirty = false;   // 有未保存的变化
+static bool s_energy_urgent = false;  // 尽快保存 (关机/换日/清零)
+static bool s_energy_was_on = false;  // 上一周期电源状态
+static int64_t s_energy_saved_us = 0; // 上次保存时间
+
+// 温度程序
+static profile_run_t s_profile;
+static int64_t s_profile_last_us = 0; // 上次推进时间 (0=无效)
+
+// 热模型辨识与到温预测
+static fopdt_t s_model;
+static int64_t s_model_last_us = 0; // 上次输入时间 (0=无效)
+static int32_t s_eta_s = -1;        // 预计到温剩余时间 (s)
+static bool s_ready = false;        // 本次目标已到温
+static int s_eta_target = 0;        // 当前预测对应的目标温度
+static float s_eta_scale = 1.0f;    // 实际/预测 到温时间比例 (闭环收敛段)
+static float s_eta_pred_s = -1.0f;  // 本次升温的首个预测 (s), <0 无
+static int64_t s_eta_pred_us = 0;   // 首个预测的时间
+
+// 预约提前量: 由历次升温曲线学习
+static stored_preheat_t s_preheat;
+static preheat_rec_t s_preheat_rec;   // 本次升温的记录
+static int s_preheat_curve = 0;       // 正在记录的曲线
+static int64_t s_preheat_base_us = 0; // 记录时刻的零点
+static void (*s_preheat_callback)(void) = NULL;
+static void (*s_power_off_callback)(void) = NULL; // 温度程序完成后自动关机
+
+static SemaphoreHandle_t s_mutex = NULL;
+static TaskHandle_t s_task = NULL;
+
+// 命令到PWM输出的延迟统计
+static int64_t s_cmd_us = 0; // 待处理命令的时间戳 (0=无)
+
+// ADC监视器已在中断中关断加热 (温控任务处理后清除)
+static volatile bool s_fast_tripped = false;
+static temp_latency_stats_t s_latency;
+static uint64_t s_latency_sum_us = 0;
+
+// 状态快照 (seqlock): 写者持有 s_mutex, 读者无锁
+static temp_snapshot_t s_snapshot;
+static atomic_uint s_snapshot_seq;
 
 // ============================================================================
 // PWM 初始化
@@ -168,214 +468,2063 @@ static esp_err_t pwm_init(void) {
 }
 
 // ============================================================================
-// 设置加热器PWM占空比
+// 能量计量
 // ============================================================================
-static void set_heater_duty(float duty_percent) {
-  if (duty_percent < 0)
-    duty_percent = 0;
-  if (duty_percent > 100)
-    duty_percent = 100;
-
-  // 10位分辨率: 0-1023
-  uint32_t duty = (uint32_t)(duty_percent * 10.23f);
-  ledc_set_duty(LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL, duty);
-  ledc_update_duty(LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL);
+/**
+ * @brief 按当前占空比把上次积分以来的能量计入各计数
+ *
+ * 在占空比改变前调用，调用者须持有 s_mutex (初始化阶段除外)
+ */
+static void energy_account(void) {
+  int64_t now_us = esp_timer_get_time();
+  if (s_energy_last_us > 0) {
+    int64_t dt_us = now_us - s_energy_last_us;
+    if (s_power_on) {
+      s_session_us += dt_us;
+      s_on_us += dt_us;
+    }
+    if (s_heater_duty > 0.0f) {
+      double joules = (double)s_heater_duty * CONFIG_HEATER_POWER_W / 100.0 *
+                      (double)dt_us * 1e-6;
+      s_session_j += joules;
+      s_day_j += joules;
+      s_lifetime_j += joules;
+      s_energy_dirty = true;
+    }
+  }
+  s_energy_last_us = now_us;
 }
 
-// ============================================================================
-// 读取NTC温度
-// ============================================================================
-static float read_ntc_temperature(void) {
-  int adc_raw = 0;
-  int voltage_mv = 0;
+/**
+ * @brief 开机时开始新的计量会话，调用者须持有 s_mutex
+ */
+static void energy_new_session(void) {
+  energy_account();
+  s_session_j = 0.0;
+  s_session_us = 0;
+}
 
-  // 读取ADC原始值
-  esp_err_t err = adc_oneshot_read(s_adc_handle, NTC_ADC_CHANNEL, &adc_raw);
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "ADC read error: %s", esp_err_to_name(err));
-    s_sensor_ok = false;
-    return -999.0f;
+/**
+ * @brief 按RTC日期切换当天计数，调用者须持有 s_mutex
+ *
+ * RTC同步前的耗电视为当天的；首次同步到与NVS相同的日期时接续保存的计数
+ */
+static void energy_check_day(void) {
+  if (!soft_rtc_is_synced()) {
+    return;
+  }
+  rtc_time_t now;
+  if (soft_rtc_get_time(&now) != ESP_OK) {
+    return;
+  }
+  uint32_t today = (uint32_t)(now.year * 10000 + now.month * 100 + now.day);
+  if (today == s_energy_day) {
+    return;
   }
 
-  // 转换为电压
-  if (s_cali_enabled) {
-    adc_cali_raw_to_voltage(s_adc_cali_handle, adc_raw, &voltage_mv);
+  if (s_energy_day == 0) {
+    if (today == s_stored_day) {
+      s_day_j += s_stored_day_j;
+    }
   } else {
-    // 简单线性估算
-    voltage_mv = (adc_raw * 3300) / 4095;
+    ESP_LOGI(TAG, "Energy day %lu: %.2f Wh", (unsigned long)s_energy_day,
+             s_day_j / 3600.0);
+    s_day_j = 0.0;
   }
+  s_energy_day = today;
+  s_energy_dirty = true;
+  s_energy_urgent = true;
+}
 
-  // 检查电压范围 (传感器异常检测)
-  if (voltage_mv < 100 || voltage_mv > 3200) {
-    ESP_LOGW(TAG, "NTC voltage out of range: %d mV", voltage_mv);
-    s_sensor_ok = false;
-    return -999.0f;
+/**
+ * @brief 更新计量并判断是否保存，调用者须持有 s_mutex
+ *
+ * 有变化时每 CONFIG_ENERGY_SAVE_INTERVAL_MIN 保存一次；关机、换日或
+ * 清零后提前保存，两次写入至少间隔 ENERGY_SAVE_MIN_S
+ *
+ * @param stored 需要保存时输出要写入的内容
+ * @return true 需要保存 (在锁外调用 save_energy)
+ */
+static bool energy_update(stored_energy_t *stored) {
+  energy_account();
+  energy_check_day();
+  if (s_energy_was_on && !s_power_on) {
+    s_energy_urgent = true;
   }
-  s_sensor_ok = true;
+  s_energy_was_on = s_power_on;
 
-  // 计算NTC电阻值 (分压公式: V_ntc = Vref * R_ntc / (R_series + R_ntc))
-  // R_ntc = R_series * V_ntc / (Vref - V_ntc)
-  float v_ntc = (float)voltage_mv;
-  float r_ntc = NTC_SERIES_R * v_ntc / (NTC_VREF_MV - v_ntc);
-
-  // 使用B值公式计算温度
-  // 1/T = 1/T25 + (1/B) * ln(R/R25)
-  // T = 1 / (1/T25 + (1/B) * ln(R/R25)) - 273.15
-  float t25_kelvin = 25.0f + 273.15f;
-  float temp_kelvin =
-      1.0f / (1.0f / t25_kelvin + (1.0f / NTC_BETA) * logf(r_ntc / NTC_R25));
-  float temp_celsius = temp_kelvin - 273.15f;
+  int64_t now_us = esp_timer_get_time();
+  int64_t since_us = now_us - s_energy_saved_us;
+  bool due =
+      s_energy_dirty &&
+      (since_us >= (int64_t)CONFIG_ENERGY_SAVE_INTERVAL_MIN * 60000000 ||
+       (s_energy_urgent && since_us >= (int64_t)ENERGY_SAVE_MIN_S * 1000000));
+  if (!due) {
+    return false;
+  }
 
-  return temp_celsius;
+  if (s_energy_day != 0) {
+    stored->day = s_energy_day;
+    stored->day_j = s_day_j;
+  } else {
+    // RTC未同步: 上电以来的耗电计入保存的日期
+    stored->day = s_stored_day;
+    stored->day_j = s_stored_day_j + s_day_j;
+  }
+  stored->lifetime_j = s_lifetime_j;
+  s_energy_dirty = false;
+  s_energy_urgent = false;
+  s_energy_saved_us = now_us;
+  return true;
 }
 
 // ============================================================================
-// 温控任务
+// 设置加热器PWM占空比
 // ============================================================================
-static void temp_control_task(void *arg) {
-  TickType_t last_wake_time = xTaskGetTickCount();
-  const TickType_t period = pdMS_TO_TICKS(500); // 500ms控制周期
-
-  while (1) {
-    // 读取当前温度
-    float temp = read_ntc_temperature();
-
-    xSemaphoreTake(s_mutex, portMAX_DELAY);
+/**
+ * @brief 写入PWM占空比 (驱动级输出)，调用者须持有 s_mutex
+ */
+static void heater_write(uint32_t duty) {
+  energy_account();
 
-    if (s_sensor_ok) {
-      s_current_temp = temp;
-    }
+  if (s_fast_tripped) {
+    duty = 0;
+  }
+  ledc_set_duty(LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL, duty);
+  ledc_update_duty(LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL);
+  // ledc_update_duty 会重新使能输出，期间若发生快速关断须再次停止
+  if (s_fast_tripped) {
+    ledc_stop(LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL, 0);
+    duty = 0;
+  }
+  // 采样同步/噪声诊断需要当前导通宽度
+  ntc_sampler_set_duty(duty, HEATER_DUTY_MAX);
+  s_heater_duty = (float)duty * 100.0f / (float)HEATER_DUTY_MAX;
+}
 
-    // 安全保护: 95°C强制断电
-    if (s_current_temp >= CONFIG_TEMP_HARD_LIMIT) {
-      ESP_LOGW(TAG, "SAFETY: Temperature %.1f >= %d, emergency shutoff!",
-               s_current_temp, CONFIG_TEMP_HARD_LIMIT);
-      s_power_on = false;
-      s_is_heating = false;
-      s_state = TEMP_STATE_IDLE;
-      set_heater_duty(0);
-      xSemaphoreGive(s_mutex);
-      vTaskDelayUntil(&last_wake_time, period);
-      continue;
-    }
+/**
+ * @brief 请求经驱动级限幅/限速后写入PWM，调用者须持有 s_mutex
+ *
+ * 输出尚未到达目标、射频避让期间或抖动输出含小数时，由定时器每
+ * DRIVE_STEP_US 继续推进。控制任务更新请求时抖动也推进一步，
+ * 相当于偶尔缩短一个周期，误差在1个计数以内
+ */
+static void drive_apply(uint32_t request) {
+  int64_t now_us = esp_timer_get_time();
+  bool tx = now_us < s_tx_until_us;
+  uint32_t dt_us =
+      s_drive_last_us > 0 ? (uint32_t)(now_us - s_drive_last_us) : 0;
+  s_drive_last_us = now_us;
+  uint32_t output = drive_update(&s_drive, request, tx, dt_us);
+  heater_write(drive_pwm(&s_drive, CONFIG_HEATER_DRIVE_DITHER));
+  if (CONFIG_HEATER_DRIVE_DITHER && !s_fast_tripped) {
+    // 抖动时平均功率由小数占空比决定
+    s_heater_duty = (float)output * 100.0f / (float)HEATER_DRIVE_FULL;
+  }
 
-    // NTC异常保护
-    if (!s_sensor_ok) {
-      ESP_LOGE(TAG, "SAFETY: NTC sensor error, stopping heater!");
-      s_is_heating = false;
-      s_state = TEMP_STATE_ERROR;
-      set_heater_duty(0);
-      xSemaphoreGive(s_mutex);
-      vTaskDelayUntil(&last_wake_time, period);
-      continue;
-    }
+  bool active = tx || !drive_settled(&s_drive) ||
+                (CONFIG_HEATER_DRIVE_DITHER && drive_fractional(&s_drive));
+  if (active && !s_drive_timer_on) {
+    s_drive_timer_on =
+        esp_timer_start_periodic(s_drive_timer, DRIVE_STEP_US) == ESP_OK;
+  } else if (!active && s_drive_timer_on) {
+    esp_timer_stop(s_drive_timer);
+    s_drive_timer_on = false;
+  }
+}
 
-    // 正常温控逻辑
-    if (s_power_on) {
-      // 设置PID目标
-      pid_set_setpoint(&s_pid, (float)s_target_temp);
+static void set_heater_duty_raw(uint32_t duty) { drive_apply(duty); }
 
-      // 计算PID输出 (0-100%)
-      float output = pid_compute(&s_pid, s_current_temp);
+static void set_heater_duty(float duty_percent) {
+  if (duty_percent < 0)
+    duty_percent = 0;
+  if (duty_percent > 100)
+    duty_percent = 100;
 
-      // 设置加热器PWM
-      set_heater_duty(output);
+  // 10位分辨率 + 小数位，由驱动级取整或抖动
+  set_heater_duty_raw(
+      (uint32_t)(duty_percent * (float)HEATER_DRIVE_FULL / 100.0f + 0.5f));
+}
 
-      s_is_heating = (output > 5.0f); // 输出>5%认为在加热
-      s_state = s_is_heating ? TEMP_STATE_HEATING : TEMP_STATE_KEEPING;
+// ============================================================================
+// 状态快照
+// ============================================================================
+/**
+ * @brief 发布状态快照
+ *
+ * 调用者须持有 s_mutex (保证单写者)。序号为奇数时表示正在写入
+ */
+static void publish_snapshot(void) {
+  unsigned seq = atomic_load_explicit(&s_snapshot_seq, memory_order_relaxed);
+  atomic_store_explicit(&s_snapshot_seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
 
-      ESP_LOGD(TAG, "Temp: %.1f -> %d, PID output: %.1f%%", s_current_temp,
-               s_target_temp, output);
-    } else {
-      // 电源关闭
-      set_heater_duty(0);
-      s_is_heating = false;
-      s_state = TEMP_STATE_IDLE;
-      pid_reset(&s_pid);
-    }
+  s_snapshot.version = (seq + 2) / 2;
+  s_snapshot.current_temp = s_current_temp;
+  s_snapshot.cup_temp = s_cascade.has_state ? s_cascade.cup : s_current_temp;
+  s_snapshot.target_temp = s_target_temp;
+  s_snapshot.power_on = s_power_on;
+  s_snapshot.is_heating = s_is_heating;
+  s_snapshot.sensor_ok = s_sensor_ok;
+  s_snapshot.state = s_state;
+  s_snapshot.duty = s_heater_duty;
+  s_snapshot.fault = s_fault;
+  s_snapshot.eta_s = s_eta_s;
+  s_snapshot.heat_mode = s_heat_mode;
+  s_snapshot.boosting = s_boost.active;
+  s_snapshot.profile_step = profile_running(&s_profile) ? s_profile.step : -1;
 
-    xSemaphoreGive(s_mutex);
+  atomic_store_explicit(&s_snapshot_seq, seq + 2, memory_order_release);
+}
 
-    vTaskDelayUntil(&last_wake_time, period);
+/**
+ * @brief 驱动级定时推进 (esp_timer任务)
+ *
+ * 爬升期间占空比在控制周期之间变化，变化时同步更新快照
+ */
+static void drive_timer_cb(void *arg) {
+  // 不阻塞esp_timer任务: 锁被占用时跳过，下个周期再推进
+  if (xSemaphoreTake(s_mutex, 0) != pdTRUE) {
+    return;
   }
+  float duty = s_heater_duty;
+  drive_apply(s_drive.request);
+  if (s_heater_duty != duty) {
+    publish_snapshot();
+  }
+  xSemaphoreGive(s_mutex);
 }
 
 // ============================================================================
-// 公开接口实现
+// PID引擎封装 (浮点 / 定点, 由Kconfig选择)
 // ============================================================================
+/**
+ * @brief 按散热模型更新维持当前设定值所需的前馈占空比
+ *
+ * 输入未变时直接返回，定点引擎的控制步骤不做浮点运算和Q16转换
+ */
+static void feedforward_update(void) {
+  if (!s_ff_stale && s_ff_setpoint_centi == s_setpoint_centi) {
+    return;
+  }
+  s_ff_stale = false;
+  s_ff_setpoint_centi = s_setpoint_centi;
+#if CONFIG_AMBIENT_COMPENSATION
+  pid_loop_set_feedforward(
+      &s_pid, ambient_ff_duty(&s_amb, (float)s_setpoint_centi * 0.01f));
+#endif
+}
 
-esp_err_t temp_control_init(void) {
-  s_mutex = xSemaphoreCreateMutex();
-  if (s_mutex == NULL) {
-    return ESP_FAIL;
+static void pid_engine_init(const pid_gains_t *gains) {
+  // 参数按控制周期整定，级联内环按内环周期计算
+  const int step_ms = s_heat_mode == TEMP_HEAT_MODE_CASCADE
+                          ? CONFIG_CASCADE_INNER_PERIOD_MS
+                          : CONFIG_TEMP_CONTROL_PERIOD_MS;
+  const pid_loop_config_t cfg = {
+      .engine = PID_ENGINE,
+      .period_s = (float)CONFIG_TEMP_CONTROL_PERIOD_MS / 1000.0f,
+      .step_s = (float)step_ms / 1000.0f,
+      .d_filter_s = (float)CONFIG_PID_D_FILTER_MS / 1000.0f,
+      .cap_percent = HEATER_CAP_PERCENT,
+      .drive_full = HEATER_DRIVE_FULL,
+  };
+  pid_loop_init(&s_pid, &cfg, gains->kp, gains->ki, gains->kd);
+  s_ff_stale = true;
+}
+
+static void pid_engine_reset(void) {
+  pid_loop_reset(&s_pid);
+#if CONFIG_PID_TIME_AWARE
+  s_pid_last_us = 0;
+#endif
+}
+
+/**
+ * @brief 执行一次PID控制并输出到加热器
+ *
+ * @param temp_centi 当前温度 (0.01°C)
+ * @return true 输出超过加热阈值
+ */
+static bool pid_engine_run(int32_t temp_centi) {
+  float dt = (float)CONFIG_TEMP_CONTROL_PERIOD_MS / 1000.0f;
+#if CONFIG_PID_TIME_AWARE
+  // 使用实测采样间隔
+  int64_t now_us = esp_timer_get_time();
+  if (s_pid_last_us > 0) {
+    dt = (float)(now_us - s_pid_last_us) * 1e-6f;
   }
+  s_pid_last_us = now_us;
+#endif
+  feedforward_update();
+  bool is_heating;
+  uint32_t request =
+      pid_loop_run(&s_pid, temp_centi, s_setpoint_centi, dt, &is_heating);
+  set_heater_duty_raw(request);
+
+  ESP_LOGD(TAG, "Temp: %ld -> %d, PID output: %lu/%d", (long)temp_centi / 100,
+           s_target_temp, (unsigned long)request, HEATER_DRIVE_FULL);
+  return is_heating;
+}
+
+/**
+ * @brief 预置积分，使下一次 pid_engine_run() 输出指定占空比 (无扰切换)
+ *
+ * @param temp_centi 当前温度 (0.01°C)
+ * @param duty_percent 期望占空比 (%)
+ */
+static void pid_engine_preload(int32_t temp_centi, float duty_percent) {
+  feedforward_update();
+  pid_loop_preload(&s_pid, temp_centi, s_setpoint_centi, duty_percent);
+}
 
-  // 初始化ADC
-  esp_err_t err = adc_init();
+// ============================================================================
+// PID参数 NVS 存储
+// ============================================================================
+static esp_err_t load_energy(void) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
   if (err != ESP_OK) {
     return err;
   }
 
-  // 初始化PWM
-  err = pwm_init();
+  stored_energy_t stored;
+  size_t len = sizeof(stored);
+  err = nvs_get_blob(nvs_handle, NVS_KEY_ENERGY, &stored, &len);
+  nvs_close(nvs_handle);
   if (err != ESP_OK) {
     return err;
   }
+  if (len != sizeof(stored)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
 
-  // 初始化PID控制器 (参数从Kconfig读取，除以100)
-  float kp = (float)CONFIG_PID_KP / 100.0f;
-  float ki = (float)CONFIG_PID_KI / 100.0f;
-  float kd = (float)CONFIG_PID_KD / 100.0f;
-
-  pid_init(&s_pid, kp, ki, kd);
-  pid_set_output_limits(&s_pid, 0, 100); // 输出0-100%
-
-  ESP_LOGI(TAG, "Temp control initialized. PID: Kp=%.2f, Ki=%.2f, Kd=%.2f", kp,
-           ki, kd);
-  ESP_LOGI(TAG, "NTC ADC on GPIO%d (TODO: verify pin)", CONFIG_NTC_ADC_PIN);
-  ESP_LOGI(TAG, "Heater PWM on GPIO%d (TODO: verify pin)",
-           CONFIG_HEATER_PWM_PIN);
-
+  s_stored_day = stored.day;
+  s_stored_day_j = stored.day_j;
+  s_lifetime_j = stored.lifetime_j;
   return ESP_OK;
 }
 
-void temp_control_start_task(void) {
-  xTaskCreate(temp_control_task, "temp_ctrl", 4096, NULL, 6, NULL);
-  ESP_LOGI(TAG, "Temp control task started");
-}
+static esp_err_t save_energy(const stored_energy_t *stored) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+    return err;
+  }
 
-void temp_control_set_power(bool on) {
-  xSemaphoreTake(s_mutex, portMAX_DELAY);
-  s_power_on = on;
-  if (!on) {
-    set_heater_duty(0);
-    pid_reset(&s_pid);
+  err = nvs_set_blob(nvs_handle, NVS_KEY_ENERGY, stored, sizeof(*stored));
+  if (err == ESP_OK) {
+    err = nvs_commit(nvs_handle);
   }
-  xSemaphoreGive(s_mutex);
-  ESP_LOGI(TAG, "Power %s", on ? "ON" : "OFF");
+  nvs_close(nvs_handle);
+
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to save energy: %s", esp_err_to_name(err));
+  }
+  return err;
 }
 
-bool temp_control_get_power(void) { return s_power_on; }
+static esp_err_t load_preheat(void) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
 
-void temp_control_set_target_temp(int temp) {
-  // 限制范围
-  if (temp < CONFIG_TEMP_MIN)
-    temp = CONFIG_TEMP_MIN;
-  if (temp > CONFIG_TEMP_MAX)
-    temp = CONFIG_TEMP_MAX;
+  stored_preheat_t stored;
+  size_t len = sizeof(stored);
+  err = nvs_get_blob(nvs_handle, NVS_KEY_PREHEAT, &stored, &len);
+  nvs_close(nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+  if (len != sizeof(stored)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  for (int i = 0; i < PREHEAT_CURVES; i++) {
+    if (!preheat_curve_valid(&stored.curves[i])) {
+      return ESP_ERR_INVALID_STATE;
+    }
+  }
+
+  s_preheat = stored;
+  return ESP_OK;
+}
+
+static esp_err_t save_preheat(const stored_preheat_t *stored) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  err = nvs_set_blob(nvs_handle, NVS_KEY_PREHEAT, stored, sizeof(*stored));
+  if (err == ESP_OK) {
+    err = nvs_commit(nvs_handle);
+  }
+  nvs_close(nvs_handle);
+
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to save preheat curves: %s", esp_err_to_name(err));
+  }
+  return err;
+}
+
+#if CONFIG_AMBIENT_COMPENSATION
+static esp_err_t load_ambient(void) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+
+  stored_ambient_t stored;
+  size_t len = sizeof(stored);
+  err = nvs_get_blob(nvs_handle, NVS_KEY_AMBIENT, &stored, &len);
+  nvs_close(nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+  if (len != sizeof(stored)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  ambient_restore(&s_amb, stored.calibrated != 0, stored.offset, stored.loss);
+  s_amb_saved_loss = stored.loss;
+  return ESP_OK;
+}
+
+static esp_err_t save_ambient(const stored_ambient_t *stored) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  err = nvs_set_blob(nvs_handle, NVS_KEY_AMBIENT, stored, sizeof(*stored));
+  if (err == ESP_OK) {
+    err = nvs_commit(nvs_handle);
+  }
+  nvs_close(nvs_handle);
+
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to save ambient model: %s", esp_err_to_name(err));
+  }
+  return err;
+}
+#endif
+
+static void default_pid_gains(pid_gains_t *gains) {
+  // 参数从Kconfig读取，除以100
+  gains->kp = (float)CONFIG_PID_KP / 100.0f;
+  gains->ki = (float)CONFIG_PID_KI / 100.0f;
+  gains->kd = (float)CONFIG_PID_KD / 100.0f;
+}
+
+static esp_err_t load_pid_gains(pid_gains_t *gains) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+
+  stored_pid_gains_t stored;
+  size_t len = sizeof(stored);
+  err = nvs_get_blob(nvs_handle, NVS_KEY_PID_GAINS, &stored, &len);
+  nvs_close(nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+  if (len != sizeof(stored) || stored.period_ms == 0) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  // 整定时的控制周期与当前不同，按周期比例换算每步参数
+  float ratio = (float)CONFIG_TEMP_CONTROL_PERIOD_MS / (float)stored.period_ms;
+  gains->kp = stored.gains.kp;
+  gains->ki = stored.gains.ki * ratio;
+  gains->kd = stored.gains.kd / ratio;
+  return ESP_OK;
+}
+
+static esp_err_t save_pid_gains(const pid_gains_t *gains) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+    return err;
+  }
+
+  stored_pid_gains_t stored = {
+      .period_ms = CONFIG_TEMP_CONTROL_PERIOD_MS,
+      .gains = *gains,
+  };
+  err = nvs_set_blob(nvs_handle, NVS_KEY_PID_GAINS, &stored, sizeof(stored));
+  if (err == ESP_OK) {
+    err = nvs_commit(nvs_handle);
+  }
+  nvs_close(nvs_handle);
+
+  if (err == ESP_OK) {
+    ESP_LOGI(TAG, "PID gains saved to NVS");
+  }
+  return err;
+}
+
+// ============================================================================
+// 读取NTC温度
+// ============================================================================
+/**
+ * @brief 读取NTC温度
+ *
+ * @param temp_centi 输出温度 (0.01°C)
+ * @return true 读数有效
+ */
+static bool read_ntc_temperature(int32_t *temp_centi) {
+  int voltage_mv = 0;
+
+  // 读取抽取+中值滤波后的电压
+  esp_err_t err = ntc_sampler_read_mv(&voltage_mv);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "NTC sampler error: %s", esp_err_to_name(err));
+    return false;
+  }
+
+  // 检查电压范围 (传感器异常检测)
+  if (voltage_mv < 100 || voltage_mv > 3200) {
+    ESP_LOGW(TAG, "NTC voltage out of range: %d mV", voltage_mv);
+    return false;
+  }
+
+  // 查表得到温度 (0.01°C)，替代逐次的 R_ntc 除法和 logf()
+  *temp_centi = ntc_mv_to_centi_celsius(voltage_mv);
+  return true;
+}
+
+// ============================================================================
+// 快速超温关断
+// ============================================================================
+/**
+ * @brief ADC监视器超温回调 (中断上下文, 位于IRAM)
+ *
+ * 直接停止LEDC输出 (空闲电平为低) 并唤醒温控任务，
+ * 关断不依赖温控任务是否被调度；任务随后按超温处理并关闭电源。
+ * ledc_stop() 位于flash (LEDC_CTRL_FUNC_IN_IRAM 未启用时)，写flash期间
+ * 缓存关闭，这里用内联的 LL 函数完成与其相同的寄存器操作
+ */
+static bool IRAM_ATTR heater_fast_trip(void *arg) {
+  ledc_dev_t *hw = LEDC_LL_GET_HW();
+  ledc_ll_set_idle_level(hw, LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL, 0);
+  ledc_ll_set_sig_out_en(hw, LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL, false);
+  ledc_ll_ls_channel_update(hw, LEDC_LOW_SPEED_MODE, HEATER_LEDC_CHANNEL);
+  s_fast_tripped = true;
+
+  BaseType_t woken = pdFALSE;
+  if (s_task != NULL) {
+    vTaskNotifyGiveFromISR(s_task, &woken);
+  }
+  return woken == pdTRUE;
+}
+
+// ============================================================================
+// 故障处理
+// ============================================================================
+/**
+ * @brief 故障是否锁定 (需显式清除后才能重新开启加热)
+ *
+ * 传感器异常随读数恢复自动解除，超温断电后可直接重新开启
+ */
+static bool fault_latched(thermal_fault_t fault) {
+  return fault != THERMAL_FAULT_NONE && fault != THERMAL_FAULT_SENSOR &&
+         fault != THERMAL_FAULT_OVER_TEMP;
+}
+
+static void protection_reset(void) {
+#if CONFIG_THERMAL_PROTECTION
+  runaway_reset(&s_runaway);
+  s_protect_last_us = 0;
+#endif
+}
+
+/**
+ * @brief 锁定故障并关闭加热，调用者须持有 s_mutex
+ */
+static void trip_fault(thermal_fault_t fault) {
+  ESP_LOGE(TAG, "SAFETY: thermal fault '%s' at %.1f C (target %d), heater off!",
+           thermal_fault_to_string(fault), s_current_temp, s_target_temp);
+  s_fault = fault;
+  s_power_on = false;
+  s_is_heating = false;
+  s_state = TEMP_STATE_ERROR;
+  autotune_cancel(&s_autotune);
+  boost_cancel(&s_boost);
+  profile_stop(&s_profile);
+  eco_reset(&s_eco);
+  set_heater_duty(0);
+  pid_engine_reset();
+  protection_reset();
+}
+
+/**
+ * @brief 热失控检测 (加热开启时每个控制周期调用)，调用者须持有 s_mutex
+ */
+static void protection_update(void) {
+#if CONFIG_THERMAL_PROTECTION
+  int64_t now_us = esp_timer_get_time();
+  float dt = 0.0f;
+  if (s_protect_last_us > 0) {
+    dt = (float)(now_us - s_protect_last_us) * 1e-6f;
+  }
+  s_protect_last_us = now_us;
+
+  // 与PID相同的设定值 (温度程序爬升、节能保温、级联时不同于目标温度)
+  thermal_fault_t fault = runaway_update(
+      &s_runaway, s_current_temp, (float)s_setpoint_centi * 0.01f,
+      s_heater_duty, s_ambient, dt);
+  if (fault != THERMAL_FAULT_NONE) {
+    trip_fault(fault);
+  }
+#endif
+}
+
+// ============================================================================
+// 全功率升温 (混合模式)
+// ============================================================================
+/**
+ * @brief 全功率升温阶段，调用者须持有 s_mutex
+ *
+ * 开机、修改目标或切换模式后的首个周期判断是否进入全功率阶段；
+ * 到达切换点后按估算的保温占空比预置PID积分，本周期即交给PID
+ *
+ * @param temp_centi 当前温度 (0.01°C)
+ * @return true 本周期以满占空比输出
+ */
+static bool boost_run(int32_t temp_centi) {
+  int64_t now_us = esp_timer_get_time();
+  if (s_boost_arm) {
+    s_boost_arm = false;
+    boost_cancel(&s_boost);
+    // 程序斜坡段按设定的速率升温，不全功率
+    if (s_heat_mode == TEMP_HEAT_MODE_BOOST &&
+        s_profile.phase != PROFILE_PHASE_RAMP &&
+        boost_start(&s_boost, s_current_temp, (float)s_target_temp)) {
+      s_boost_last_us = now_us;
+      ESP_LOGI(TAG, "Boost: full power %.1f -> %d C", s_current_temp,
+               s_target_temp);
+    }
+  }
+  if (!s_boost.active) {
+    return false;
+  }
+
+  float dt = (float)(now_us - s_boost_last_us) * 1e-6f;
+  s_boost_last_us = now_us;
+  if (!boost_update(&s_boost, s_current_temp, dt)) {
+    set_heater_duty(100);
+    return true;
+  }
+
+  float hold_duty = boost_preload_duty(&s_boost, (float)HEATER_CAP_PERCENT);
+  ESP_LOGI(TAG, "Boost: handoff to PID at %.1f C, hold duty %.0f%%",
+           s_current_temp, hold_duty);
+  if (hold_duty >= 0.0f) {
+    pid_engine_preload(temp_centi, hold_duty);
+  }
+  return false;
+}
+
+/**
+ * @brief 关闭电源并结束自整定、温度程序等，调用者须持有 s_mutex
+ */
+static void power_off(void) {
+  // 关机前计入开机时长
+  energy_account();
+  s_power_on = false;
+  set_heater_duty(0);
+  pid_engine_reset();
+  autotune_cancel(&s_autotune);
+  boost_cancel(&s_boost);
+  profile_stop(&s_profile);
+  eco_reset(&s_eco);
+  protection_reset();
+  s_is_heating = false;
+  if (s_state != TEMP_STATE_ERROR) {
+    s_state = TEMP_STATE_IDLE;
+  }
+}
+
+// ============================================================================
+// 温度程序
+// ============================================================================
+/**
+ * @brief 推进温度程序并更新PID设定值，调用者须持有 s_mutex
+ *
+ * 进入新段时更新目标温度 (直接跳变的段按加热策略判断是否全功率)，
+ * 程序完成且设置了完成后关闭时关闭电源
+ *
+ * @param temp_centi 当前温度 (0.01°C)
+ * @return true 程序完成并已关闭电源，本周期不再控温
+ */
+static bool profile_tick(int32_t temp_centi) {
+  int64_t now_us = esp_timer_get_time();
+  uint32_t dt_ms = 0;
+  if (s_profile_last_us > 0) {
+    dt_ms = (uint32_t)((now_us - s_profile_last_us) / 1000);
+  }
+  s_profile_last_us = now_us;
+
+  if (!profile_running(&s_profile)) {
+    s_setpoint_centi = (int32_t)s_target_temp * 100;
+    return false;
+  }
+
+  profile_event_t event = profile_update(&s_profile, temp_centi, dt_ms);
+  const profile_step_t *step = &s_profile.prog.steps[s_profile.step];
+  if (event == PROFILE_EVENT_STEP) {
+    ESP_LOGI(TAG, "Profile step %d/%d: %d C, ramp %d.%d C/min, hold %u min",
+             s_profile.step + 1, s_profile.prog.n_steps, step->target,
+             step->ramp_c10_min / 10, step->ramp_c10_min % 10,
+             (unsigned)step->hold_min);
+    s_target_temp = step->target;
+    s_boost_arm = (step->ramp_c10_min == 0);
+    pid_loop_restore_integral_limit(&s_pid);
+  } else if (event == PROFILE_EVENT_DONE) {
+    ESP_LOGI(TAG, "Profile done, %s", s_profile.prog.power_off
+                                          ? "power off"
+                                          : "keeping last target");
+    if (s_profile.prog.power_off) {
+      power_off();
+      return true;
+    }
+  }
+  s_setpoint_centi = s_profile.setpoint_centi;
+  return false;
+}
+
+// ============================================================================
+// 节能保温
+// ============================================================================
+/**
+ * @brief 开机时测量环境温度，调用者须持有 s_mutex
+ *
+ * 加热停止足够久 (或上电后尚未加热) 时加热板已冷却到环境温度
+ */
+static void ambient_capture(void) {
+  int64_t idle_us = esp_timer_get_time() - s_heat_last_us;
+  if (s_heat_last_us != 0 && idle_us < (int64_t)AMBIENT_IDLE_S * 1000000) {
+    return;
+  }
+  if (!s_sensor_ok || s_current_temp > AMBIENT_MAX) {
+    return;
+  }
+  s_ambient = s_current_temp;
+#if CONFIG_AMBIENT_COMPENSATION
+  // 同时标定芯片温度偏差，之后环境温度随芯片温度跟踪
+  ambient_calibrate(&s_amb, s_current_temp);
+  if (s_amb.calibrated) {
+    s_amb_dirty = true;
+    ESP_LOGI(TAG, "Ambient estimate: %.1f C (chip offset %.1f C)", s_ambient,
+             s_amb.offset);
+    return;
+  }
+#endif
+  ESP_LOGI(TAG, "Ambient estimate: %.1f C", s_ambient);
+}
+
+#if CONFIG_AMBIENT_COMPENSATION
+/**
+ * @brief 读取芯片内部温度 (锁外调用)
+ */
+static bool chip_temp_read(float *celsius) {
+  return s_tsens != NULL &&
+         temperature_sensor_get_celsius(s_tsens, celsius) == ESP_OK;
+}
+
+/**
+ * @brief 跟踪环境温度并学习散热系数，调用者须持有 s_mutex
+ *
+ * 散热系数更新后按新前馈量预置积分，保持当前输出不变
+ *
+ * @param temp_centi 当前温度 (0.01°C)
+ * @param chip_ok 芯片温度读取成功
+ * @param chip 芯片温度 (°C)
+ * @param stored 需要保存时输出待写入NVS的内容
+ * @return true 需要在锁外调用 save_ambient()
+ */
+static bool ambient_tick(int32_t temp_centi, bool chip_ok, float chip,
+                         stored_ambient_t *stored) {
+  int64_t now_us = esp_timer_get_time();
+  float dt = 0.0f;
+  if (s_amb_last_us > 0) {
+    dt = (float)(now_us - s_amb_last_us) * 1e-6f;
+  }
+  s_amb_last_us = now_us;
+
+  if (chip_ok) {
+    ambient_update(&s_amb, chip, dt);
+  }
+  if (!ambient_valid(&s_amb)) {
+    return false;
+  }
+  s_ambient = s_amb.ambient;
+  fopdt_set_ambient(&s_model, s_ambient);
+  int ambient_c10 = (int)lroundf(s_ambient * 10.0f);
+  if (ambient_c10 != s_ff_ambient_c10) {
+    s_ff_ambient_c10 = ambient_c10;
+    s_ff_stale = true;
+  }
+
+  int learned = s_amb.loss_count;
+  ambient_learn(&s_amb, s_current_temp, s_heater_duty, dt);
+  if (s_amb.loss_count != learned) {
+    s_ff_stale = true;
+    feedforward_update();
+    ESP_LOGI(TAG, "Heat loss %.3f %%/K (ambient %.1f C), feedforward %.1f%%",
+             s_amb.loss, s_ambient, s_pid.ff);
+    if (s_power_on && s_autotune.state != AUTOTUNE_RUNNING &&
+        !s_boost.active) {
+      pid_engine_preload(temp_centi, s_heater_duty);
+    }
+    // 学习收敛后很少再写Flash
+    if (fabsf(s_amb.loss - s_amb_saved_loss) >
+        AMBIENT_SAVE_CHANGE * s_amb_saved_loss) {
+      s_amb_dirty = true;
+    }
+  }
+
+  if (!s_amb_dirty) {
+    return false;
+  }
+  stored->calibrated = s_amb.calibrated ? 1 : 0;
+  stored->offset = s_amb.offset;
+  stored->loss = s_amb.loss;
+  s_amb_saved_loss = s_amb.loss;
+  s_amb_dirty = false;
+  return true;
+}
+#endif
+
+/**
+ * @brief 节能保温: 到温后降低PID设定值，调用者须持有 s_mutex
+ *
+ * 温度程序执行、全功率升温期间或级联模式下不介入 (本次保温结束)
+ */
+static void eco_tick(void) {
+  int64_t now_us = esp_timer_get_time();
+  float dt = 0.0f;
+  if (s_eco_last_us > 0) {
+    dt = (float)(now_us - s_eco_last_us) * 1e-6f;
+  }
+  s_eco_last_us = now_us;
+
+  if (!s_eco_enabled || profile_running(&s_profile) || s_boost.active ||
+      s_heat_mode == TEMP_HEAT_MODE_CASCADE) {
+    if (s_eco.holding) {
+      eco_reset(&s_eco);
+    }
+    return;
+  }
+
+  bool was_holding = s_eco.holding;
+  float setpoint = eco_update(&s_eco, s_current_temp, (float)s_target_temp,
+                              s_heater_duty, s_ambient, dt);
+  s_setpoint_centi = (int32_t)lroundf(setpoint * 100.0f);
+  if (s_eco.holding && !was_holding) {
+    ESP_LOGI(TAG, "Eco keep-warm: setpoint %.2f C (target %d C)", setpoint,
+             s_target_temp);
+  }
+}
+
+/**
+ * @brief 电源 关->开 的公共处理，调用者须持有 s_mutex
+ */
+static void power_on_edge(void) {
+  protection_reset();
+  if (s_fault == THERMAL_FAULT_OVER_TEMP) {
+    s_fault = THERMAL_FAULT_NONE;
+  }
+  ambient_capture();
+  energy_new_session();
+  // 可能换了杯子: 杯温重新估计
+  cascade_reset(&s_cascade);
+  s_cascade_outer_us = 0;
+}
+
+// ============================================================================
+// 级联控温
+// ============================================================================
+/**
+ * @brief 当前控制的温度 (°C): 级联模式下为估计杯温，否则为读数
+ */
+static float controlled_temp(void) {
+  if (s_heat_mode == TEMP_HEAT_MODE_CASCADE && s_cascade.has_state) {
+    return s_cascade.cup;
+  }
+  return s_current_temp;
+}
+
+/**
+ * @brief 杯温观测器输入当前读数，调用者须持有 s_mutex
+ *
+ * 每次读取NTC后调用 (包括内环)，占空比为上一区间实际施加值
+ */
+static void cascade_observe_tick(void) {
+  int64_t now_us = esp_timer_get_time();
+  float dt = 0.0f;
+  if (s_cascade_last_us > 0) {
+    dt = (float)(now_us - s_cascade_last_us) * 1e-6f;
+  }
+  s_cascade_last_us = now_us;
+  cascade_observe(&s_cascade, s_current_temp, s_heater_duty, s_ambient, dt);
+}
+
+/**
+ * @brief 级联外环，调用者须持有 s_mutex
+ *
+ * 在温度程序之后调用，把 s_setpoint_centi 由杯温设定值改写为
+ * 内环PID的加热板设定值；非级联模式或未在控温时不改动
+ */
+static void cascade_tick(void) {
+  if (!s_power_on || s_autotune.state == AUTOTUNE_RUNNING ||
+      s_heat_mode != TEMP_HEAT_MODE_CASCADE) {
+    s_cascade_outer_us = 0;
+    return;
+  }
+
+  int64_t now_us = esp_timer_get_time();
+  float dt = 0.0f;
+  if (s_cascade_outer_us > 0) {
+    dt = (float)(now_us - s_cascade_outer_us) * 1e-6f;
+  }
+  s_cascade_outer_us = now_us;
+
+  float setpoint = cascade_update(
+      &s_cascade, (float)s_setpoint_centi * 0.01f, s_ambient, dt);
+  s_setpoint_centi = (int32_t)lroundf(setpoint * 100.0f);
+}
+
+/**
+ * @brief 是否在控制周期之间运行内环，调用者须持有 s_mutex
+ */
+static bool cascade_inner_active(void) {
+  return CONFIG_CASCADE_INNER_PERIOD_MS < CONFIG_TEMP_CONTROL_PERIOD_MS &&
+         s_power_on && s_sensor_ok && s_heat_mode == TEMP_HEAT_MODE_CASCADE &&
+         s_autotune.state != AUTOTUNE_RUNNING;
+}
+
+// ============================================================================
+// 热模型与到温预测
+// ============================================================================
+/**
+ * @brief 输入辨识数据 (PID计算前调用，占空比为上一周期实际施加值)
+ */
+static void model_update(void) {
+  int64_t now_us = esp_timer_get_time();
+  float dt = 0.0f;
+  if (s_model_last_us > 0) {
+    dt = (float)(now_us - s_model_last_us) * 1e-6f;
+  }
+  s_model_last_us = now_us;
+  fopdt_update(&s_model, s_current_temp, s_heater_duty, dt);
+}
+
+/**
+ * @brief 更新预计到温时间，调用者须持有 s_mutex
+ *
+ * 模型按满功率预测，PID在接近目标时减小输出，实际更慢；
+ * 每次到温后用 实际/预测 时间修正比例
+ */
+static void eta_update(void) {
+  float ready_temp = (float)s_target_temp - READY_BAND;
+  // 级联模式下按估计杯温判断到温
+  const bool cascade = s_heat_mode == TEMP_HEAT_MODE_CASCADE;
+  const float temp = controlled_temp();
+
+  if (!s_power_on || s_state == TEMP_STATE_AUTOTUNE ||
+      s_target_temp != s_eta_target) {
+    s_ready = false;
+    s_eta_pred_s = -1.0f;
+    s_eta_target = s_target_temp;
+    s_cascade_eta_us = 0;
+  }
+  if (!s_power_on || s_state == TEMP_STATE_AUTOTUNE) {
+    s_eta_s = -1;
+    return;
+  }
+
+  // 到温后回差 READY_BAND 内波动或节能保温时仍视为就绪
+  if (s_ready && (temp >= ready_temp - READY_BAND || s_eco.holding)) {
+    s_eta_s = 0;
+    return;
+  }
+  if (temp >= ready_temp) {
+    if (s_eta_pred_s >= ETA_LEARN_MIN_S) {
+      float actual = (float)(esp_timer_get_time() - s_eta_pred_us) * 1e-6f;
+      float ratio = actual / s_eta_pred_s;
+      if (ratio < ETA_SCALE_MIN) {
+        ratio = ETA_SCALE_MIN;
+      } else if (ratio > ETA_SCALE_MAX) {
+        ratio = ETA_SCALE_MAX;
+      }
+      s_eta_scale += 0.5f * (ratio - s_eta_scale);
+      ESP_LOGI(TAG, "Ready in %.0fs (predicted %.0fs), ETA scale %.2f",
+               actual, s_eta_pred_s, s_eta_scale);
+    }
+    s_ready = true;
+    s_eta_pred_s = -1.0f;
+    s_eta_s = 0;
+    return;
+  }
+  s_ready = false;
+
+  float eta;
+  if (cascade) {
+    // 逐步仿真较耗时，间隔计算，其间沿用上次结果
+    int64_t now_us = esp_timer_get_time();
+    if (s_cascade_eta_us > 0 &&
+        now_us - s_cascade_eta_us < (int64_t)CASCADE_ETA_INTERVAL_S * 1000000) {
+      return;
+    }
+    s_cascade_eta_us = now_us;
+    eta = cascade_time_to_target(&s_cascade, ready_temp, s_ambient,
+                                 (float)HEATER_CAP_PERCENT);
+  } else {
+    eta = fopdt_time_to_target(&s_model, s_current_temp, ready_temp,
+                               (float)HEATER_CAP_PERCENT);
+  }
+  if (eta < 0.0f) {
+    s_eta_s = -1;
+    return;
+  }
+  if (s_eta_pred_s < 0.0f) {
+    s_eta_pred_s = eta;
+    s_eta_pred_us = esp_timer_get_time();
+  }
+  s_eta_s = (int32_t)(eta * s_eta_scale + 0.5f);
+}
+
+/**
+ * @brief 记录升温曲线，调用者须持有 s_mutex (在 eta_update 之后调用)
+ *
+ * 温度程序执行、自整定或级联观测器未收敛时不记录
+ *
+ * @param stored 需要保存时输出待写入NVS的内容
+ * @return true 需要在锁外调用 save_preheat()
+ */
+static bool preheat_tick(stored_preheat_t *stored) {
+  const bool cascade = s_heat_mode == TEMP_HEAT_MODE_CASCADE;
+  const int curve = cascade ? 1 : 0;
+  const bool heating = s_power_on && s_state != TEMP_STATE_AUTOTUNE &&
+                       !profile_running(&s_profile) &&
+                       (!cascade || s_cascade.has_state);
+  preheat_rec_t *r = &s_preheat_rec;
+
+  if (r->active && (!heating || curve != s_preheat_curve ||
+                    (float)s_target_temp != r->target)) {
+    r->active = false; // 本次升温中断，已学到的分段保留
+  }
+  if (!heating) {
+    return false;
+  }
+
+  int64_t now_us = esp_timer_get_time();
+  if (!r->active) {
+    if (!s_ready) {
+      s_preheat_base_us = now_us;
+      s_preheat_curve = curve;
+      preheat_start(r, PREHEAT_APPROACH_C, controlled_temp(),
+                    (float)s_target_temp, 0.0f);
+    }
+    return false;
+  }
+
+  float t = (float)(now_us - s_preheat_base_us) * 1e-6f;
+  preheat_curve_t *c = &s_preheat.curves[curve];
+  if (!preheat_update(r, c, controlled_temp(), t, s_ready,
+                      PREHEAT_MAX_GAP_S)) {
+    return false;
+  }
+  ESP_LOGI(TAG, "Preheat curve %d: approach %.0fs, %lu sessions", curve,
+           c->approach_s, (unsigned long)c->sessions);
+  *stored = s_preheat;
+  return true;
+}
+
+// ============================================================================
+// 命令唤醒
+// ============================================================================
+/**
+ * @brief 记录命令时间并唤醒温控任务
+ *
+ * 调用者须持有 s_mutex
+ */
+static void notify_command(void) {
+  if (s_task == NULL) {
+    return;
+  }
+  if (s_cmd_us == 0) {
+    s_cmd_us = esp_timer_get_time();
+  }
+  xTaskNotifyGive(s_task);
+}
+
+/**
+ * @brief 统计命令到PWM输出的延迟
+ *
+ * 在温控任务更新占空比后调用，调用者须持有 s_mutex
+ */
+static void record_command_latency(void) {
+  if (s_cmd_us == 0) {
+    return;
+  }
+  uint32_t latency_us = (uint32_t)(esp_timer_get_time() - s_cmd_us);
+  s_cmd_us = 0;
+
+  s_latency.count++;
+  s_latency.last_us = latency_us;
+  if (latency_us > s_latency.max_us) {
+    s_latency.max_us = latency_us;
+  }
+  s_latency_sum_us += latency_us;
+  s_latency.avg_us = (uint32_t)(s_latency_sum_us / s_latency.count);
+}
+
+/**
+ * @brief 等待下一控制周期，或被命令提前唤醒
+ *
+ * 命令唤醒时立即返回，周期从唤醒时刻重新计时
+ */
+static void wait_next_period(TickType_t *last_wake_time, TickType_t period) {
+  TickType_t next = *last_wake_time + period;
+  TickType_t now = xTaskGetTickCount();
+  TickType_t wait = (int32_t)(next - now) > 0 ? next - now : 0;
+
+  if (ulTaskNotifyTake(pdTRUE, wait) > 0) {
+    *last_wake_time = xTaskGetTickCount();
+  } else {
+    *last_wake_time = next;
+  }
+}
+
+/**
+ * @brief 级联内环: 控制周期内每 CONFIG_CASCADE_INNER_PERIOD_MS 调节加热板
+ *
+ * 替代 wait_next_period()，外环、热保护和到温预测仍按控制周期运行。
+ * 读数异常、超温或被命令唤醒时提前返回，由控制周期立即处理
+ */
+static void cascade_inner_loop(TickType_t *last_wake_time, TickType_t period) {
+  const TickType_t inner = pdMS_TO_TICKS(CONFIG_CASCADE_INNER_PERIOD_MS);
+  const TickType_t next = *last_wake_time + period;
+  TickType_t wake = *last_wake_time + inner;
+
+  while (inner > 0 && (int32_t)(next - wake) > 0) {
+    TickType_t now = xTaskGetTickCount();
+    TickType_t wait = (int32_t)(wake - now) > 0 ? wake - now : 0;
+    if (ulTaskNotifyTake(pdTRUE, wait) > 0) {
+      *last_wake_time = xTaskGetTickCount();
+      return;
+    }
+    wake += inner;
+
+    int32_t temp_centi = 0;
+    bool sensor_ok = read_ntc_temperature(&temp_centi);
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (!sensor_ok || s_fast_tripped || !cascade_inner_active() ||
+        temp_centi >= CONFIG_TEMP_HARD_LIMIT * 100) {
+      xSemaphoreGive(s_mutex);
+      *last_wake_time = xTaskGetTickCount();
+      return;
+    }
+    s_current_temp = (float)temp_centi * 0.01f;
+    cascade_observe_tick();
+    s_is_heating = pid_engine_run(temp_centi);
+    s_state = s_is_heating ? TEMP_STATE_HEATING : TEMP_STATE_KEEPING;
+    publish_snapshot();
+    xSemaphoreGive(s_mutex);
+  }
+
+  wait_next_period(last_wake_time, period);
+}
+
+// ============================================================================
+// 温控任务
+// ============================================================================
+static void temp_control_task(void *arg) {
+  TickType_t last_wake_time = xTaskGetTickCount();
+  const TickType_t period = pdMS_TO_TICKS(CONFIG_TEMP_CONTROL_PERIOD_MS);
+
+  while (1) {
+    // 读取当前温度 (0.01°C)
+    int32_t temp_centi = 0;
+    bool sensor_ok = read_ntc_temperature(&temp_centi);
+#if CONFIG_AMBIENT_COMPENSATION
+    float chip_temp = 0.0f;
+    bool chip_ok = chip_temp_read(&chip_temp);
+#endif
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+
+    s_sensor_ok = sensor_ok;
+    if (s_sensor_ok) {
+      s_current_temp = (float)temp_centi * 0.01f;
+      if (s_fault == THERMAL_FAULT_SENSOR) {
+        s_fault = THERMAL_FAULT_NONE;
+      }
+    }
+
+    // 安全保护: 95°C强制断电 (ADC监视器可能已在中断中关断)
+    bool fast_tripped = s_fast_tripped;
+    if (fast_tripped || s_current_temp >= CONFIG_TEMP_HARD_LIMIT) {
+      if (fast_tripped) {
+        ntc_trip_stats_t trip;
+        ntc_sampler_get_trip_stats(&trip);
+        ESP_LOGW(TAG,
+                 "SAFETY: hardware over-temp trip in %lu us (filtered %.1f C)",
+                 (unsigned long)trip.detect_us, s_current_temp);
+        s_fast_tripped = false;
+      } else {
+        ESP_LOGW(TAG, "SAFETY: Temperature %.1f >= %d, emergency shutoff!",
+                 s_current_temp, CONFIG_TEMP_HARD_LIMIT);
+      }
+      s_power_on = false;
+      s_is_heating = false;
+      s_state = TEMP_STATE_IDLE;
+      if (!fault_latched(s_fault)) {
+        s_fault = THERMAL_FAULT_OVER_TEMP;
+      }
+      autotune_cancel(&s_autotune);
+      boost_cancel(&s_boost);
+      profile_stop(&s_profile);
+      eco_reset(&s_eco);
+      set_heater_duty(0);
+      protection_reset();
+      record_command_latency();
+      publish_snapshot();
+      xSemaphoreGive(s_mutex);
+      wait_next_period(&last_wake_time, period);
+      continue;
+    }
+
+    // NTC异常保护
+    if (!s_sensor_ok) {
+      ESP_LOGE(TAG, "SAFETY: NTC sensor error, stopping heater!");
+      s_is_heating = false;
+      autotune_cancel(&s_autotune);
+      boost_cancel(&s_boost);
+      s_profile_last_us = 0; // 温度程序、节能保温、散热学习、观测器暂停
+      s_eco_last_us = 0;
+      s_cascade_last_us = 0;
+      s_cascade_outer_us = 0;
+#if CONFIG_AMBIENT_COMPENSATION
+      s_amb_last_us = 0;
+#endif
+      s_state = TEMP_STATE_ERROR;
+      if (!fault_latched(s_fault)) {
+        s_fault = THERMAL_FAULT_SENSOR;
+      }
+      set_heater_duty(0);
+      protection_reset();
+      record_command_latency();
+      publish_snapshot();
+      xSemaphoreGive(s_mutex);
+      wait_next_period(&last_wake_time, period);
+      continue;
+    }
+
+    bool save_gains = false;
+    stored_energy_t energy;
+
+    model_update();
+    cascade_observe_tick();
+    if (s_power_on && s_autotune.state != AUTOTUNE_RUNNING) {
+      // 级联模式下温度程序按估计杯温推进
+      if (profile_tick((int32_t)lroundf(controlled_temp() * 100.0f))) {
+        record_command_latency();
+        publish_snapshot();
+        xSemaphoreGive(s_mutex);
+        if (s_power_off_callback) {
+          s_power_off_callback();
+        }
+        wait_next_period(&last_wake_time, period);
+        continue;
+      }
+      eco_tick();
+    }
+    cascade_tick();
+#if CONFIG_AMBIENT_COMPENSATION
+    stored_ambient_t ambient;
+    bool save_ambient_now =
+        ambient_tick(temp_centi, chip_ok, chip_temp, &ambient);
+#endif
+
+    // 正常温控逻辑
+    if (s_power_on && s_autotune.state == AUTOTUNE_RUNNING) {
+      // 自整定: 继电输出。命令会提前唤醒任务，按实测间隔计时，
+      // 否则振荡周期 Pu 及由其得到的参数偏差
+      int64_t now_us = esp_timer_get_time();
+      float dt = 0.0f;
+      if (s_autotune_last_us > 0) {
+        dt = (float)(now_us - s_autotune_last_us) * 1e-6f;
+      }
+      s_autotune_last_us = now_us;
+      float output = autotune_update(&s_autotune, s_current_temp, dt);
+      set_heater_duty(output);
+      s_is_heating = (output > (float)HEATING_DUTY_THRESHOLD);
+      s_state = TEMP_STATE_AUTOTUNE;
+
+      if (s_autotune.state == AUTOTUNE_DONE &&
+          autotune_get_gains(&s_autotune,
+                             CONFIG_TEMP_CONTROL_PERIOD_MS / 1000.0f,
+                             &s_gains.kp, &s_gains.ki, &s_gains.kd)) {
+        ESP_LOGI(TAG,
+                 "Autotune done: Ku=%.2f, Pu=%.1fs -> Kp=%.3f, Ki=%.4f, "
+                 "Kd=%.3f",
+                 s_autotune.ku, s_autotune.pu, s_gains.kp, s_gains.ki,
+                 s_gains.kd);
+        pid_engine_init(&s_gains);
+        pid_engine_reset();
+        s_gains_tuned = true;
+        save_gains = true;
+      } else if (s_autotune.state == AUTOTUNE_FAILED) {
+        ESP_LOGW(TAG, "Autotune failed, keeping current PID gains");
+        pid_engine_reset();
+      }
+      protection_update();
+    } else if (s_power_on) {
+      if (boost_run(temp_centi)) {
+        s_is_heating = true;
+        s_state = TEMP_STATE_HEATING;
+      } else {
+        // PID计算并设置加热器PWM
+        s_is_heating = pid_engine_run(temp_centi);
+        s_state = s_is_heating ? TEMP_STATE_HEATING : TEMP_STATE_KEEPING;
+      }
+      protection_update();
+    } else {
+      // 电源关闭 (锁定故障时保持错误状态)
+      set_heater_duty(0);
+      s_is_heating = false;
+      s_state = fault_latched(s_fault) ? TEMP_STATE_ERROR : TEMP_STATE_IDLE;
+      pid_engine_reset();
+    }
+
+    if (s_heater_duty > 0.0f) {
+      s_heat_last_us = esp_timer_get_time();
+    }
+    eta_update();
+    stored_preheat_t preheat;
+    bool save_preheat_now = preheat_tick(&preheat);
+    bool save_energy_now = energy_update(&energy);
+    record_command_latency();
+    publish_snapshot();
+    bool inner = cascade_inner_active();
+    xSemaphoreGive(s_mutex);
+
+    // 写Flash较慢，在锁外进行
+    if (save_gains) {
+      save_pid_gains(&s_gains);
+    }
+    if (save_energy_now) {
+      save_energy(&energy);
+    }
+    if (save_preheat_now) {
+      save_preheat(&preheat);
+      if (s_preheat_callback) {
+        s_preheat_callback();
+      }
+    }
+#if CONFIG_AMBIENT_COMPENSATION
+    if (save_ambient_now) {
+      save_ambient(&ambient);
+    }
+#endif
+
+    if (inner) {
+      cascade_inner_loop(&last_wake_time, period);
+    } else {
+      wait_next_period(&last_wake_time, period);
+    }
+  }
+}
+
+// ============================================================================
+// 公开接口实现
+// ============================================================================
+
+esp_err_t temp_control_init(void) {
+  s_mutex = xSemaphoreCreateMutex();
+  if (s_mutex == NULL) {
+    return ESP_FAIL;
+  }
+
+  // 硬件快速超温关断，门限与软件保护相同
+  int trip_mv = ntc_centi_celsius_to_mv(CONFIG_TEMP_HARD_LIMIT * 100);
+  if (ntc_sampler_set_trip(trip_mv, heater_fast_trip, NULL) != ESP_OK) {
+    ESP_LOGW(TAG, "Hardware over-temp trip not available, software only");
+  }
+
+  // 初始化ADC连续采样
+  esp_err_t err = ntc_sampler_init(NTC_ADC_CHANNEL, HEATER_PWM_FREQ);
+  if (err != ESP_OK) {
+    return err;
+  }
+
+  // 初始化PWM
+  err = pwm_init();
+  if (err != ESP_OK) {
+    return err;
+  }
+
+  // 加热驱动级 (PWM已输出0)
+  drive_config_t drive_cfg;
+  drive_config_percent(&drive_cfg, HEATER_DRIVE_FULL, HEATER_CAP_PERCENT,
+                       CONFIG_HEATER_SLEW_PCT_S, CONFIG_HEATER_TX_BACKOFF_PCT);
+  drive_init(&s_drive, &drive_cfg);
+  const esp_timer_create_args_t drive_timer_args = {
+      .callback = drive_timer_cb,
+      .name = "heater_drive",
+  };
+  err = esp_timer_create(&drive_timer_args, &s_drive_timer);
+  if (err != ESP_OK) {
+    return err;
+  }
+  ESP_LOGI(TAG,
+           "Heater drive: %d Hz%s, cap %d%%, slew %d%%/s, TX backoff %s",
+           HEATER_PWM_FREQ, CONFIG_HEATER_DRIVE_DITHER ? " dithered" : "",
+           HEATER_CAP_PERCENT, CONFIG_HEATER_SLEW_PCT_S,
+           CONFIG_HEATER_TX_BACKOFF ? "on" : "off");
+
+  // 累计耗电从NVS接续
+  if (load_energy() == ESP_OK) {
+    ESP_LOGI(TAG, "Energy: lifetime %.1f Wh", s_lifetime_j / 3600.0);
+  }
+
+  // 初始化PID控制器 (优先使用NVS中的自整定参数)
+  if (load_pid_gains(&s_gains) == ESP_OK) {
+    s_gains_tuned = true;
+  } else {
+    default_pid_gains(&s_gains);
+  }
+  pid_engine_init(&s_gains);
+  fopdt_init(&s_model, MODEL_SAMPLE_PERIOD_S);
+  for (int i = 0; i < PREHEAT_CURVES; i++) {
+    preheat_curve_init(&s_preheat.curves[i]);
+  }
+  if (load_preheat() == ESP_OK) {
+    ESP_LOGI(TAG, "Preheat curves: %lu / %lu sessions",
+             (unsigned long)s_preheat.curves[0].sessions,
+             (unsigned long)s_preheat.curves[1].sessions);
+  }
+
+  cascade_config_t cascade_cfg;
+  cascade_default_config(&cascade_cfg);
+  cascade_cfg.heater_w = (float)CONFIG_HEATER_POWER_W;
+  cascade_cfg.plate_c = (float)CONFIG_CASCADE_PLATE_CAP_J_K;
+  cascade_cfg.cup_c = (float)CONFIG_CASCADE_CUP_CAP_J_K;
+  cascade_cfg.g_plate_amb = (float)CONFIG_CASCADE_G_PLATE_AMB_MW_K / 1000.0f;
+  cascade_cfg.g_plate_cup = (float)CONFIG_CASCADE_G_PLATE_CUP_MW_K / 1000.0f;
+  cascade_cfg.g_cup_amb = (float)CONFIG_CASCADE_G_CUP_AMB_MW_K / 1000.0f;
+  cascade_cfg.plate_max = (float)CONFIG_CASCADE_PLATE_MAX;
+  cascade_init(&s_cascade, &cascade_cfg);
+
+  boost_config_t boost_cfg;
+  boost_default_config(&boost_cfg);
+  boost_cfg.min_step = (float)CONFIG_HEAT_BOOST_MIN_STEP;
+  boost_init(&s_boost, &boost_cfg);
+
+  eco_config_t eco_cfg;
+  eco_default_config(&eco_cfg);
+  eco_cfg.band = (float)CONFIG_ECO_BAND;
+  eco_init(&s_eco, &eco_cfg);
+
+#if CONFIG_AMBIENT_COMPENSATION
+  ambient_config_t amb_cfg;
+  ambient_default_config(&amb_cfg);
+  amb_cfg.offset = (float)CONFIG_AMBIENT_CHIP_OFFSET_C;
+  ambient_init(&s_amb, &amb_cfg);
+  if (load_ambient() == ESP_OK) {
+    ESP_LOGI(TAG, "Ambient model: chip offset %.1f C%s, loss %.3f %%/K",
+             s_amb.offset, s_amb.calibrated ? "" : " (default)", s_amb.loss);
+  }
+  // -10~80°C 量程误差最小 (<1°C)
+  temperature_sensor_config_t tsens_cfg =
+      TEMPERATURE_SENSOR_CONFIG_DEFAULT(-10, 80);
+  if (temperature_sensor_install(&tsens_cfg, &s_tsens) != ESP_OK) {
+    s_tsens = NULL;
+  } else if (temperature_sensor_enable(s_tsens) != ESP_OK) {
+    temperature_sensor_uninstall(s_tsens);
+    s_tsens = NULL;
+  }
+  if (s_tsens == NULL) {
+    ESP_LOGW(TAG, "Chip temperature sensor not available, no ambient "
+                  "compensation");
+  }
+#endif
+
+#if CONFIG_THERMAL_PROTECTION
+  runaway_config_t protect_cfg;
+  runaway_default_config(&protect_cfg);
+  protect_cfg.watch_period = (float)CONFIG_THERMAL_WATCH_PERIOD_S;
+  protect_cfg.watch_rise = (float)CONFIG_THERMAL_WATCH_RISE_C10 / 10.0f;
+  protect_cfg.full_rise = (float)CONFIG_THERMAL_FULL_DUTY_RISE;
+  protect_cfg.hysteresis = (float)CONFIG_THERMAL_RUNAWAY_HYSTERESIS;
+  protect_cfg.runaway_period = (float)CONFIG_THERMAL_RUNAWAY_PERIOD_S;
+  runaway_init(&s_runaway, &protect_cfg);
+#endif
+
+  // 温控任务尚未启动，无需加锁
+  publish_snapshot();
+
+  ESP_LOGI(TAG,
+           "Temp control initialized. PID (%s, %s): Kp=%.3f, Ki=%.4f, "
+           "Kd=%.3f, period=%d ms",
+           CONFIG_PID_ENGINE_FIXED ? "fixed"
+           : CONFIG_PID_TIME_AWARE ? "float, time-aware"
+                                   : "float",
+           s_gains_tuned ? "autotuned" : "Kconfig", s_gains.kp, s_gains.ki,
+           s_gains.kd, CONFIG_TEMP_CONTROL_PERIOD_MS);
+  ESP_LOGI(TAG, "NTC ADC on GPIO%d (TODO: verify pin)", CONFIG_NTC_ADC_PIN);
+  ESP_LOGI(TAG, "Heater PWM on GPIO%d (TODO: verify pin)",
+           CONFIG_HEATER_PWM_PIN);
+
+  return ESP_OK;
+}
+
+void temp_control_start_task(void) {
+  xTaskCreate(temp_control_task, "temp_ctrl", 4096, NULL, 6, &s_task);
+  ESP_LOGI(TAG, "Temp control task started");
+}
+
+void temp_control_set_power(bool on) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (on && fault_latched(s_fault)) {
+    xSemaphoreGive(s_mutex);
+    ESP_LOGW(TAG, "Power ON rejected, thermal fault '%s' not cleared",
+             thermal_fault_to_string(s_fault));
+    return;
+  }
+  if (on) {
+    if (!s_power_on) {
+      power_on_edge();
+      s_boost_arm = true;
+    }
+    energy_account();
+    s_power_on = true;
+  } else {
+    power_off();
+  }
+  publish_snapshot();
+  notify_command();
+  xSemaphoreGive(s_mutex);
+  ESP_LOGI(TAG, "Power %s", on ? "ON" : "OFF");
+}
+
+bool temp_control_get_power(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.power_on;
+}
+
+void temp_control_set_target_temp(int temp) {
+  // 限制范围
+  if (temp < CONFIG_TEMP_MIN)
+    temp = CONFIG_TEMP_MIN;
+  if (temp > CONFIG_TEMP_MAX)
+    temp = CONFIG_TEMP_MAX;
 
   xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (profile_running(&s_profile)) {
+    // 手动设定接管温度程序
+    profile_stop(&s_profile);
+    ESP_LOGI(TAG, "Profile stopped by manual target");
+  }
+  if (temp != s_target_temp) {
+    s_boost_arm = true;
+    // 结束上次全功率切换预置时放宽的积分限幅
+    pid_loop_restore_integral_limit(&s_pid);
+  }
   s_target_temp = temp;
+  publish_snapshot();
+  notify_command();
   xSemaphoreGive(s_mutex);
   ESP_LOGI(TAG, "Target temp set to %d", temp);
 }
 
-int temp_control_get_target_temp(void) { return s_target_temp; }
+int temp_control_get_target_temp(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.target_temp;
+}
+
+float temp_control_get_current_temp(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.current_temp;
+}
+
+bool temp_control_is_heating(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.is_heating;
+}
+
+temp_state_t temp_control_get_state(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.state;
+}
+
+bool temp_control_is_sensor_ok(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.sensor_ok;
+}
+
+void temp_control_get_snapshot(temp_snapshot_t *snap) {
+  if (snap == NULL) {
+    return;
+  }
+
+  for (int tries = 0;; tries++) {
+    unsigned seq =
+        atomic_load_explicit(&s_snapshot_seq, memory_order_acquire);
+    if ((seq & 1) == 0) {
+      *snap = s_snapshot;
+      atomic_thread_fence(memory_order_acquire);
+      if (atomic_load_explicit(&s_snapshot_seq, memory_order_relaxed) ==
+          seq) {
+        return;
+      }
+    }
+    // 写者被抢占在写入途中时，让其先完成
+    if (tries >= SNAPSHOT_SPIN_LIMIT) {
+      vTaskDelay(1);
+    }
+  }
+}
+
+esp_err_t temp_control_start_autotune(int setpoint) {
+  // 限制范围
+  if (setpoint < CONFIG_TEMP_MIN)
+    setpoint = CONFIG_TEMP_MIN;
+  if (setpoint > CONFIG_TEMP_MAX)
+    setpoint = CONFIG_TEMP_MAX;
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (!s_sensor_ok || fault_latched(s_fault)) {
+    xSemaphoreGive(s_mutex);
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!s_power_on) {
+    protection_reset();
+    energy_new_session();
+  }
+  s_autotune_last_us = 0;
+  autotune_start(&s_autotune, (float)setpoint, 0.0f,
+                 (float)HEATER_CAP_PERCENT, AUTOTUNE_HYSTERESIS);
+  boost_cancel(&s_boost);
+  s_boost_arm = false;
+  profile_stop(&s_profile);
+  eco_reset(&s_eco);
+  s_target_temp = setpoint;
+  s_setpoint_centi = (int32_t)setpoint * 100;
+  s_power_on = true;
+  publish_snapshot();
+  notify_command();
+  xSemaphoreGive(s_mutex);
+
+  ESP_LOGI(TAG, "Autotune started at %d C", setpoint);
+  return ESP_OK;
+}
+
+void temp_control_cancel_autotune(void) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (s_autotune.state == AUTOTUNE_RUNNING) {
+    autotune_cancel(&s_autotune);
+    pid_engine_reset();
+    notify_command();
+    ESP_LOGI(TAG, "Autotune cancelled");
+  }
+  xSemaphoreGive(s_mutex);
+}
+
+esp_err_t temp_control_reset_pid_gains(void) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+  err = nvs_erase_key(nvs_handle, NVS_KEY_PID_GAINS);
+  if (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND) {
+    err = nvs_commit(nvs_handle);
+  }
+  nvs_close(nvs_handle);
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  default_pid_gains(&s_gains);
+  s_gains_tuned = false;
+  pid_engine_init(&s_gains);
+  xSemaphoreGive(s_mutex);
+
+  ESP_LOGI(TAG, "PID gains reset to Kconfig defaults");
+  return err;
+}
+
+void temp_control_get_autotune_status(temp_autotune_status_t *status) {
+  if (status == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  status->state = s_autotune.state;
+  status->cycles = s_autotune.cycles;
+  status->ku = s_autotune.ku;
+  status->pu = s_autotune.pu;
+  status->kp = s_gains.kp;
+  status->ki = s_gains.ki;
+  status->kd = s_gains.kd;
+  status->tuned = s_gains_tuned;
+  xSemaphoreGive(s_mutex);
+}
+
+void temp_control_get_latency_stats(temp_latency_stats_t *stats) {
+  if (stats == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  *stats = s_latency;
+  xSemaphoreGive(s_mutex);
+}
+
+thermal_fault_t temp_control_get_fault(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.fault;
+}
+
+void temp_control_clear_fault(void) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  thermal_fault_t fault = s_fault;
+  if (fault_latched(fault)) {
+    s_fault = THERMAL_FAULT_NONE;
+    s_state = TEMP_STATE_IDLE;
+    protection_reset();
+    publish_snapshot();
+  }
+  xSemaphoreGive(s_mutex);
+
+  if (fault_latched(fault)) {
+    ESP_LOGI(TAG, "Thermal fault '%s' cleared",
+             thermal_fault_to_string(fault));
+  }
+}
+
+void temp_control_get_model(fopdt_params_t *params) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  fopdt_get_params(&s_model, params);
+  xSemaphoreGive(s_mutex);
+}
+
+void temp_control_set_heat_mode(temp_heat_mode_t mode) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (mode != s_heat_mode) {
+    s_heat_mode = mode;
+    // 恢复积分限幅 (全功率阶段结束时可能已放宽)，并按新模式重新判断
+    boost_cancel(&s_boost);
+    pid_engine_init(&s_gains);
+    pid_engine_reset();
+    s_boost_arm = true;
+    publish_snapshot();
+    notify_command();
+  }
+  xSemaphoreGive(s_mutex);
+  ESP_LOGI(TAG, "Heat mode: %s", temp_heat_mode_to_string(mode));
+}
+
+temp_heat_mode_t temp_control_get_heat_mode(void) {
+  temp_snapshot_t snap;
+  temp_control_get_snapshot(&snap);
+  return snap.heat_mode;
+}
+
+const char *temp_heat_mode_to_string(temp_heat_mode_t mode) {
+  switch (mode) {
+  case TEMP_HEAT_MODE_BOOST:
+    return "boost";
+  case TEMP_HEAT_MODE_CASCADE:
+    return "cascade";
+  default:
+    return "pid";
+  }
+}
+
+// ============================================================================
+// 温度程序接口
+// ============================================================================
+
+esp_err_t temp_control_save_profile(const profile_t *prog) {
+  if (prog == NULL ||
+      !profile_validate(prog, CONFIG_TEMP_MIN, CONFIG_TEMP_MAX)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+  if (err != ESP_OK) {
+    return err;
+  }
+  err = nvs_set_blob(nvs_handle, NVS_KEY_PROFILE, prog, sizeof(*prog));
+  if (err == ESP_OK) {
+    err = nvs_commit(nvs_handle);
+  }
+  nvs_close(nvs_handle);
+
+  if (err == ESP_OK) {
+    ESP_LOGI(TAG, "Profile saved (%d steps)", prog->n_steps);
+  }
+  return err;
+}
+
+esp_err_t temp_control_load_profile(profile_t *prog) {
+  nvs_handle_t nvs_handle;
+  esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+  if (err != ESP_OK) {
+    return err == ESP_ERR_NVS_NOT_FOUND ? ESP_ERR_NOT_FOUND : err;
+  }
+
+  size_t len = sizeof(*prog);
+  err = nvs_get_blob(nvs_handle, NVS_KEY_PROFILE, prog, &len);
+  nvs_close(nvs_handle);
+  if (err != ESP_OK) {
+    return err == ESP_ERR_NVS_NOT_FOUND ? ESP_ERR_NOT_FOUND : err;
+  }
+  if (len != sizeof(*prog) ||
+      !profile_validate(prog, CONFIG_TEMP_MIN, CONFIG_TEMP_MAX)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  return ESP_OK;
+}
+
+esp_err_t temp_control_start_profile(const profile_t *prog) {
+  if (prog == NULL ||
+      !profile_validate(prog, CONFIG_TEMP_MIN, CONFIG_TEMP_MAX)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (fault_latched(s_fault)) {
+    xSemaphoreGive(s_mutex);
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!s_power_on) {
+    power_on_edge();
+  }
+  if (s_autotune.state == AUTOTUNE_RUNNING) {
+    autotune_cancel(&s_autotune);
+    pid_engine_reset();
+  }
+
+  profile_start(&s_profile, prog, (int32_t)(controlled_temp() * 100.0f));
+  s_profile_last_us = 0;
+  s_setpoint_centi = s_profile.setpoint_centi;
+  s_target_temp = prog->steps[0].target;
+  s_boost_arm = (prog->steps[0].ramp_c10_min == 0);
+  pid_loop_restore_integral_limit(&s_pid);
+  s_power_on = true;
+  publish_snapshot();
+  notify_command();
+  xSemaphoreGive(s_mutex);
+
+  ESP_LOGI(TAG, "Profile started: %d steps, first %d C", prog->n_steps,
+           prog->steps[0].target);
+  return ESP_OK;
+}
+
+void temp_control_stop_profile(void) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  bool running = profile_running(&s_profile);
+  if (running) {
+    // 保持当前段目标继续控温
+    profile_stop(&s_profile);
+    publish_snapshot();
+    notify_command();
+  }
+  xSemaphoreGive(s_mutex);
+
+  if (running) {
+    ESP_LOGI(TAG, "Profile stopped");
+  }
+}
+
+void temp_control_get_profile_status(temp_profile_status_t *status) {
+  if (status == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  status->phase = s_profile.phase;
+  status->step = s_profile.step;
+  status->n_steps = s_profile.prog.n_steps;
+  status->setpoint = (float)s_setpoint_centi * 0.01f;
+  status->hold_remaining_s = profile_hold_remaining_s(&s_profile);
+  xSemaphoreGive(s_mutex);
+}
+
+// ============================================================================
+// 节能保温接口
+// ============================================================================
+
+void temp_control_set_eco(bool enable) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  if (enable != s_eco_enabled) {
+    s_eco_enabled = enable;
+    // 关闭时下一周期设定值恢复为目标温度
+    eco_reset(&s_eco);
+    notify_command();
+  }
+  xSemaphoreGive(s_mutex);
+  ESP_LOGI(TAG, "Eco keep-warm: %s", enable ? "on" : "off");
+}
+
+bool temp_control_get_eco(void) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  bool enabled = s_eco_enabled;
+  xSemaphoreGive(s_mutex);
+  return enabled;
+}
+
+void temp_control_get_eco_status(temp_eco_status_t *status) {
+  if (status == NULL) {
+    return;
+  }
+
+  const float watt_per_duty = (float)CONFIG_HEATER_POWER_W / 100.0f;
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  status->enabled = s_eco_enabled;
+  status->holding = s_eco.holding;
+  status->setpoint = (float)s_setpoint_centi * 0.01f;
+  status->ambient = s_ambient;
+  status->loss_w_per_k = s_eco.loss > 0.0f ? s_eco.loss * watt_per_duty : 0.0f;
+  float baseline = eco_hold_duty(&s_eco, (float)s_target_temp, s_ambient);
+  status->baseline_w = baseline >= 0.0f ? baseline * watt_per_duty : -1.0f;
+  status->saved_wh = eco_saved_duty_s(&s_eco) * watt_per_duty / 3600.0f;
+  xSemaphoreGive(s_mutex);
+}
+
+void temp_control_get_ambient_status(temp_ambient_status_t *status) {
+  if (status == NULL) {
+    return;
+  }
+
+  *status = (temp_ambient_status_t){0};
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  status->ambient = s_ambient;
+#if CONFIG_AMBIENT_COMPENSATION
+  const float watt_per_duty = (float)CONFIG_HEATER_POWER_W / 100.0f;
+  status->sensor = ambient_valid(&s_amb);
+  status->calibrated = s_amb.calibrated;
+  status->chip = s_amb.chip;
+  status->offset = s_amb.offset;
+  status->loss_w_per_k = s_amb.loss > 0.0f ? s_amb.loss * watt_per_duty : 0.0f;
+  // 控制任务最近一次设置的前馈量，查询不改变控制输出
+  status->ff_pct = s_pid.ff;
+#endif
+  xSemaphoreGive(s_mutex);
+}
+
+// ============================================================================
+// 能量计量接口
+// ============================================================================
+
+void temp_control_get_energy_stats(temp_energy_stats_t *stats) {
+  if (stats == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  energy_account();
+  stats->session_wh = (float)(s_session_j / 3600.0);
+  stats->session_s = (uint32_t)(s_session_us / 1000000);
+  stats->day_wh = (float)(s_day_j / 3600.0);
+  stats->lifetime_wh = (float)(s_lifetime_j / 3600.0);
+  stats->power_w = s_heater_duty * (float)CONFIG_HEATER_POWER_W / 100.0f;
+  stats->heater_w = CONFIG_HEATER_POWER_W;
+  stats->day = s_energy_day;
+  xSemaphoreGive(s_mutex);
+}
+
+int32_t temp_control_get_preheat_s(int target, bool cold) {
+  if (target < CONFIG_TEMP_MIN) {
+    target = CONFIG_TEMP_MIN;
+  } else if (target > CONFIG_TEMP_MAX) {
+    target = CONFIG_TEMP_MAX;
+  }
+
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  const bool cascade = s_heat_mode == TEMP_HEAT_MODE_CASCADE;
+  float start = controlled_temp();
+  if (cold && s_ambient < start) {
+    start = s_ambient; // 届时最多冷却到环境温度
+  }
+  float t = preheat_time(&s_preheat.curves[cascade ? 1 : 0],
+                         PREHEAT_APPROACH_C, start, (float)target);
+  xSemaphoreGive(s_mutex);
+
+  return t < 0.0f ? -1 : (int32_t)(t + 0.5f);
+}
+
+void temp_control_set_preheat_callback(void (*callback)(void)) {
+  s_preheat_callback = callback;
+}
+
+void temp_control_set_power_off_callback(void (*callback)(void)) {
+  s_power_off_callback = callback;
+}
+
+int64_t temp_control_get_on_time_us(void) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  energy_account();
+  int64_t on_us = s_on_us;
+  xSemaphoreGive(s_mutex);
+  return on_us;
+}
 
-float temp_control_get_current_temp(void) { return s_current_temp; }
+void temp_control_reset_energy(void) {
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  energy_account();
+  s_session_j = 0.0;
+  s_day_j = 0.0;
+  s_lifetime_j = 0.0;
+  s_stored_day_j = 0.0;
+  s_energy_dirty = true;
+  s_energy_urgent = true;
+  xSemaphoreGive(s_mutex);
+  ESP_LOGI(TAG, "Energy counters cleared");
+}
 
-bool temp_control_is_heating(void) { return s_is_heating; }
+// ============================================================================
+// 射频发射避让
+// ============================================================================
 
-temp_state_t temp_control_get_state(void) { return s_state; }
+void temp_control_tx_backoff(uint32_t duration_ms) {
+#if CONFIG_HEATER_TX_BACKOFF
+  if (s_mutex == NULL) {
+    return;
+  }
 
-bool temp_control_is_sensor_ok(void) { return s_sensor_ok; }
+  xSemaphoreTake(s_mutex, portMAX_DELAY);
+  int64_t until_us = esp_timer_get_time() + (int64_t)duration_ms * 1000;
+  if (until_us > s_tx_until_us) {
+    s_tx_until_us = until_us;
+  }
+  // 立即降低输出，到期后由驱动级定时器按斜率恢复
+  drive_apply(s_drive.request);
+  xSemaphoreGive(s_mutex);
+#else
+  (void)duration_ms;
+#endif
+}
@@ -8,6 +8,7 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,6 +19,15 @@ extern "C" {
  */
 typedef void (*wifi_event_callback_t)(bool connected);
 
+/**
+ * @brief 射频发射提示回调类型
+ *
+ * 在扫描/连接等持续大电流发射之前调用，供其他负载 (如加热器) 避让
+ *
+ * @param duration_ms 预计发射时长 (ms)
+ */
+typedef void (*wifi_tx_hint_callback_t)(uint32_t duration_ms);
+
 /**
  * @brief 初始化WiFi管理器
  *
@@ -29,6 +39,13 @@ typedef void (*wifi_event_callback_t)(bool connected);
  */
 esp_err_t wifi_manager_init(wifi_event_callback_t callback);
 
+/**
+ * @brief 设置射频发射提示回调
+ *
+ * @param callback 回调函数（可为NULL）
+ */
+void wifi_manager_set_tx_hint_callback(wifi_tx_hint_callback_t callback);
+
 /**
  * @brief 强制启动SmartConfig配网
  *
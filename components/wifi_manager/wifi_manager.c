@@ -36,6 +36,9 @@ static const char *TAG = "WiFiManager";
 #define CONFIG_CUP_WARMER_MDNS_HOSTNAME "heated-cup"
 #endif
 
+// 扫描+认证+关联+DHCP期间的发射时长估计 (ms)
+#define CONNECT_TX_MS 3000
+
 // 事件组标志位
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT BIT1
@@ -44,6 +47,7 @@ static const char *TAG = "WiFiManager";
 // 静态变量
 static EventGroupHandle_t s_wifi_event_group = NULL;
 static wifi_event_callback_t s_user_callback = NULL;
+static wifi_tx_hint_callback_t s_tx_hint_callback = NULL;
 static bool s_is_connected = false;
 static esp_netif_t *s_sta_netif = NULL;
 static bool s_smartconfig_running = false;
@@ -98,6 +102,16 @@ static esp_err_t load_wifi_credentials(char *ssid, size_t ssid_len,
   return err;
 }
 
+/**
+ * @brief 发起连接 (连接期间射频持续发射，先通知避让)
+ */
+static void wifi_connect(void) {
+  if (s_tx_hint_callback) {
+    s_tx_hint_callback(CONNECT_TX_MS);
+  }
+  esp_wifi_connect();
+}
+
 /**
  * @brief WiFi事件处理函数
  */
@@ -121,7 +135,7 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
 
       // 尝试重连
       if (!s_smartconfig_running) {
-        esp_wifi_connect();
+        wifi_connect();
       }
       break;
 
@@ -171,7 +185,7 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
 
       ESP_ERROR_CHECK(esp_wifi_disconnect());
       ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
-      esp_wifi_connect();
+      wifi_connect();
       break;
 
     case SC_EVENT_SEND_ACK_DONE:
@@ -268,6 +282,10 @@ esp_err_t wifi_manager_init(wifi_event_callback_t callback) {
   return ESP_OK;
 }
 
+void wifi_manager_set_tx_hint_callback(wifi_tx_hint_callback_t callback) {
+  s_tx_hint_callback = callback;
+}
+
 void wifi_manager_start_smartconfig(void) {
   if (!s_smartconfig_running) {
     xTaskCreate(smartconfig_task, "smartconfig_task", 4096, NULL, 3, NULL);
@@ -52,16 +52,22 @@ static void ui_update_task(void *arg) {
   const TickType_t period = pdMS_TO_TICKS(200); // 200ms刷新周期
 
   while (1) {
-    // 根据当前状态更新UI
-    float current_temp = temp_control_get_current_temp();
-    int target_temp = temp_control_get_target_temp();
-    bool is_heating = temp_control_is_heating();
+    // 根据当前状态更新UI (一次读取一致的温控快照)
+    temp_snapshot_t snap;
+    temp_control_get_snapshot(&snap);
+    // 级联模式下目标温度指杯温，显示估计杯温
+    float current_temp = snap.heat_mode == TEMP_HEAT_MODE_CASCADE
+                             ? snap.cup_temp
+                             : snap.current_temp;
+    int target_temp = snap.target_temp;
+    bool is_heating = snap.is_heating;
     bool wifi_ok = wifi_manager_is_connected();
 
     // 更新全局状态
     g_app_state.current_temp = current_temp;
     g_app_state.target_temp = target_temp;
     g_app_state.is_heating = is_heating;
+    g_app_state.power_on = snap.power_on;
 
     // 如果正在配网，显示配网界面
     if (!wifi_ok && lcd_display_get_current_screen() != UI_SCREEN_CONFIG) {
@@ -74,7 +80,8 @@ static void ui_update_task(void *arg) {
 
     // 更新主界面
     if (lcd_display_get_current_screen() == UI_SCREEN_MAIN) {
-      lcd_display_update_main(current_temp, target_temp, is_heating, wifi_ok);
+      lcd_display_update_main(current_temp, target_temp, is_heating, wifi_ok,
+                              snap.eta_s);
     }
 
     vTaskDelayUntil(&last_wake_time, period);
@@ -142,6 +149,7 @@ void app_main(void) {
 
   // 7. 初始化WiFi (会自动从NVS恢复或启动SmartConfig)
   ESP_LOGI(TAG, "[6/7] Starting WiFi...");
+  wifi_manager_set_tx_hint_callback(temp_control_tx_backoff);
   ret = wifi_manager_init(wifi_status_callback);
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "WiFi init failed!");
@@ -181,8 +189,9 @@ void app_main(void) {
     vTaskDelay(pdMS_TO_TICKS(5000));
 
     // 可以在这里添加看门狗喂狗、状态打印等
-    ESP_LOGD(TAG, "Temp: %.1f°C -> %d°C, Heating: %s",
-             temp_control_get_current_temp(), temp_control_get_target_temp(),
-             temp_control_is_heating() ? "Yes" : "No");
+    temp_snapshot_t snap;
+    temp_control_get_snapshot(&snap);
+    ESP_LOGD(TAG, "Temp: %.1f°C -> %d°C, Heating: %s", snap.current_temp,
+             snap.target_temp, snap.is_heating ? "Yes" : "No");
   }
 }
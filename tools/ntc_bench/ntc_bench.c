@@ -0,0 +1,132 @@
+/**
+ * @file ntc_bench.c
+ * @brief NTC查找表与 logf() 换算的主机基准
+ *
+ * 在传感器有效电压范围 (100-3200 mV) 内逐 mV 比较 ntc.c 的查表插值与
+ * 原 read_ntc_temperature() 的单精度B值公式 (除法 + logf)：
+ * 以双精度公式为参考输出两者的最大/平均误差，并计时每次换算的耗时。
+ * 主机有硬件浮点，ESP32-C3 上浮点为软件实现，实际差距大于此处结果
+ *
+ * 构建与运行:
+ *   cmake -S tools/ntc_bench -B build/ntc && cmake --build build/ntc
+ *   ./build/ntc/ntc_bench --rounds 2000
+ */
+
+#include "ntc.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MV_MIN 100 // 与 temp_control.c 的有效电压窗口一致
+#define MV_MAX 3200
+#define VREF_MV 3300
+#define T25_KELVIN (25.0 + 273.15)
+#define MV_COUNT (MV_MAX - MV_MIN + 1)
+
+/**
+ * @brief 原 read_ntc_temperature() 的单精度换算
+ */
+static float beta_logf(int voltage_mv) {
+  float v_ntc = (float)voltage_mv;
+  float r_ntc = (float)NTC_SERIES_R * v_ntc / ((float)VREF_MV - v_ntc);
+  float t25_kelvin = 25.0f + 273.15f;
+  float temp_kelvin =
+      1.0f / (1.0f / t25_kelvin +
+              (1.0f / (float)NTC_BETA) * logf(r_ntc / (float)NTC_R25));
+  return temp_kelvin - 273.15f;
+}
+
+/**
+ * @brief 双精度参考值, 与 gen_ntc_table.py 的 beta_celsius() 相同
+ */
+static double beta_ref(int voltage_mv) {
+  double r_ntc = (double)NTC_SERIES_R * voltage_mv / (VREF_MV - voltage_mv);
+  return 1.0 / (1.0 / T25_KELVIN + log(r_ntc / NTC_R25) / NTC_BETA) - 273.15;
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+typedef struct {
+  double max;
+  double sum;
+  int max_mv;
+} err_stats_t;
+
+static void error_add(err_stats_t *e, int mv, double err) {
+  err = fabs(err);
+  e->sum += err;
+  if (err > e->max) {
+    e->max = err;
+    e->max_mv = mv;
+  }
+}
+
+int main(int argc, char **argv) {
+  int rounds = 1000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+      rounds = atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--rounds N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (rounds < 1) {
+    rounds = 1;
+  }
+
+  // 误差: 逐 mV 对比双精度参考
+  err_stats_t table_err = {0};
+  err_stats_t logf_err = {0};
+  for (int mv = MV_MIN; mv <= MV_MAX; mv++) {
+    double ref = beta_ref(mv);
+    error_add(&table_err, mv, ntc_mv_to_centi_celsius(mv) / 100.0 - ref);
+    error_add(&logf_err, mv, (double)beta_logf(mv) - ref);
+  }
+
+  // 耗时: 输入经 volatile 读取, 结果累加到 volatile, 防止编译器预先计算
+  static int inputs[MV_COUNT];
+  for (int i = 0; i < MV_COUNT; i++) {
+    inputs[i] = MV_MIN + i;
+  }
+  volatile int *in = inputs;
+  volatile int64_t table_sink = 0;
+  volatile float logf_sink = 0.0f;
+
+  double t0 = now_ns();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < MV_COUNT; i++) {
+      table_sink += ntc_mv_to_centi_celsius(in[i]);
+    }
+  }
+  double t1 = now_ns();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < MV_COUNT; i++) {
+      logf_sink += beta_logf(in[i]);
+    }
+  }
+  double t2 = now_ns();
+
+  double calls = (double)rounds * MV_COUNT;
+  double table_ns = (t1 - t0) / calls;
+  double logf_ns = (t2 - t1) / calls;
+
+  printf("NTC %d-%d mV, B=%d R25=%d R_series=%d, %d rounds\n", MV_MIN, MV_MAX,
+         NTC_BETA, NTC_R25, NTC_SERIES_R, rounds);
+  printf("%-8s %10s %10s %10s %8s\n", "method", "ns/call", "max_err_C",
+         "mean_err_C", "at_mV");
+  printf("%-8s %10.2f %10.5f %10.5f %8d\n", "table", table_ns, table_err.max,
+         table_err.sum / MV_COUNT, table_err.max_mv);
+  printf("%-8s %10.2f %10.5f %10.5f %8d\n", "logf", logf_ns, logf_err.max,
+         logf_err.sum / MV_COUNT, logf_err.max_mv);
+  printf("speedup  %.1fx\n", table_ns > 0.0 ? logf_ns / table_ns : 0.0);
+  return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file pid_equiv.c
+ * @brief pid_compute() 与 pid_fixed_compute() 的主机等价性测试
+ *
+ * 每个用例用同一测量序列 (0.01°C 整数, 与 NTC 查找表输出一致) 分别驱动
+ * 浮点与 Q16.16 定点PID, 参数转换与 temp_control.c 的 pid_engine_init()
+ * 相同。测量序列来自一阶热模型在浮点输出下的闭环响应, 覆盖输出饱和、
+ * 积分限幅 (正反两向)、设定值阶跃、测量噪声、前馈和预置积分。
+ * 任一步两者输出之差超过 EQUIV_TOL_PERCENT 即失败 (退出码 1)
+ *
+ * 构建与运行:
+ *   cmake -S tools/pid_equiv -B build/pid && cmake --build build/pid
+ *   ctest --test-dir build/pid   (或 ./build/pid/pid_equiv -v)
+ */
+
+#include "pid.h"
+#include "pid_fixed.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// 允许的输出偏差 (%): 约为10位LEDC占空比一个LSB (0.098%) 的 1/10
+#define EQUIV_TOL_PERCENT 0.01f
+#define STEPS 3000
+
+/**
+ * @brief 测试用例
+ */
+typedef struct {
+  const char *name;
+  float kp;
+  float ki;
+  float kd;
+  float ratio;     // 级联内环步长比 (与 pid_engine_init() 相同)
+  float out_max;   // 输出上限 (%)
+  int32_t start;   // 初始温度 (0.01°C)
+  int32_t sp[3];   // 设定值, 每 STEPS/3 步切换一次 (0.01°C)
+  float ff;        // 前馈量 (%)
+  float preload;   // 第0步预置的输出 (%), <0 不预置
+  float noise;     // 测量噪声峰值 (°C)
+  float gain;      // 热模型: 满功率稳态温升 (°C)
+  float tau_steps; // 热模型时间常数 (步)
+} equiv_case_t;
+
+static const equiv_case_t s_cases[] = {
+    // 冷启动: 输出先饱和于上限, 积分顶在正限幅
+    {"cold-start", 3.0f, 0.1f, 0.5f, 1.0f, 100.0f, 2500, {6000, 6000, 6000},
+     0.0f, -1.0f, 0.0f, 80.0f, 400.0f},
+    // 起始高于目标: 输出饱和于0, 积分顶在负限幅
+    {"overshoot", 2.0f, 0.1f, 0.5f, 1.0f, 100.0f, 9000, {5000, 5000, 5000},
+     0.0f, -1.0f, 0.0f, 80.0f, 400.0f},
+    // 设定值升降阶跃, 两次穿越饱和
+    {"sp-steps", 2.0f, 0.1f, 0.5f, 1.0f, 100.0f, 2500, {4000, 8500, 3000},
+     0.0f, -1.0f, 0.0f, 80.0f, 300.0f},
+    // 高增益 + 测量噪声, 微分项放大噪声
+    {"noisy-high", 10.0f, 0.5f, 5.0f, 1.0f, 100.0f, 2500, {7000, 7000, 5500},
+     0.0f, -1.0f, 0.3f, 80.0f, 300.0f},
+    // 功率上限与前馈
+    {"cap-ff", 3.0f, 0.05f, 1.0f, 1.0f, 80.0f, 2500, {5500, 7500, 5500},
+     20.0f, -1.0f, 0.05f, 80.0f, 400.0f},
+    // 级联内环换算 (ki*0.2, kd/0.2, 积分限幅/0.2)
+    {"cascade", 2.0f, 0.1f, 0.5f, 0.2f, 100.0f, 2500, {6500, 6500, 4500},
+     0.0f, -1.0f, 0.05f, 80.0f, 2000.0f},
+    // boost 切换: 预置积分后继续运行
+    {"preload", 2.0f, 0.1f, 0.5f, 1.0f, 100.0f, 5800, {6000, 6000, 6000},
+     10.0f, 35.0f, 0.05f, 80.0f, 400.0f},
+};
+
+static uint32_t s_rng = 1;
+
+static float rng_sym(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return (float)(s_rng / 4294967296.0) * 2.0f - 1.0f;
+}
+
+/**
+ * @brief 运行单个用例
+ *
+ * @return float 两者输出的最大偏差 (%)
+ */
+static float run_case(const equiv_case_t *c, bool verbose) {
+  pid_controller_t pf;
+  pid_fixed_t pq;
+
+  pid_init(&pf, c->kp, c->ki * c->ratio, c->kd / c->ratio);
+  pid_set_output_limits(&pf, 0.0f, c->out_max);
+  pid_set_integral_limit(&pf, pf.integral_max / c->ratio);
+  pid_set_feedforward(&pf, c->ff);
+
+  pid_fixed_init(&pq, Q16_FROM_FLOAT(c->kp), Q16_FROM_FLOAT(c->ki * c->ratio),
+                 Q16_FROM_FLOAT(c->kd / c->ratio));
+  pid_fixed_set_output_limits(&pq, 0, Q16_FROM_FLOAT(c->out_max));
+  pid_fixed_set_integral_limit(&pq, (q16_t)((float)pq.integral_max / c->ratio));
+  pid_fixed_set_feedforward(&pq, Q16_FROM_FLOAT(c->ff));
+
+  s_rng = 12345;
+  float plant = (float)c->start * 0.01f;
+  const float ambient = 25.0f;
+  float max_diff = 0.0f;
+  int max_step = 0;
+
+  for (int step = 0; step < STEPS; step++) {
+    int32_t sp = c->sp[step * 3 / STEPS];
+    int32_t centi = (int32_t)lroundf((plant + c->noise * rng_sym()) * 100.0f);
+
+    pid_set_setpoint(&pf, (float)sp * 0.01f);
+    pid_fixed_set_setpoint(&pq, q16_from_centi(sp));
+    if (step == 0 && c->preload >= 0.0f) {
+      pid_preload(&pf, (float)centi * 0.01f, c->preload);
+      pid_fixed_preload(&pq, q16_from_centi(centi), Q16_FROM_FLOAT(c->preload));
+    }
+
+    float out_f = pid_compute(&pf, (float)centi * 0.01f);
+    float out_q = (float)pid_fixed_compute(&pq, q16_from_centi(centi)) /
+                  (float)Q16_ONE;
+    float diff = fabsf(out_f - out_q);
+    if (diff > max_diff) {
+      max_diff = diff;
+      max_step = step;
+    }
+    if (verbose && step % 500 == 0) {
+      printf("  %-10s step %4d  temp %6.2f  float %7.3f  fixed %7.3f\n",
+             c->name, step, centi * 0.01f, out_f, out_q);
+    }
+
+    // 一阶热模型, 由浮点输出驱动
+    float target = ambient + c->gain * out_f / 100.0f;
+    plant += (target - plant) / c->tau_steps;
+  }
+
+  printf("%-10s max |float - fixed| = %.5f%% at step %d  %s\n", c->name,
+         max_diff, max_step, max_diff <= EQUIV_TOL_PERCENT ? "ok" : "FAIL");
+  return max_diff;
+}
+
+int main(int argc, char **argv) {
+  bool verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+  int failed = 0;
+
+  printf("pid_compute vs pid_fixed_compute, %d steps, tolerance %.3f%%\n",
+         STEPS, EQUIV_TOL_PERCENT);
+  for (size_t i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); i++) {
+    if (run_case(&s_cases[i], verbose) > EQUIV_TOL_PERCENT) {
+      failed++;
+    }
+  }
+  if (failed > 0) {
+    printf("%d case(s) diverged\n", failed);
+    return 1;
+  }
+  return 0;
+}
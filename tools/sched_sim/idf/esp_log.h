@@ -0,0 +1,19 @@
+/**
+ * @file esp_log.h
+ * @brief ESP-IDF 日志的主机替身, 带虚拟时间戳输出 (sched_sim -v)
+ */
+
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+#include "esp_err.h"
+
+void host_log(char level, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, fmt, ...) host_log('E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) host_log('W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) host_log('I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) host_log('D', tag, fmt, ##__VA_ARGS__)
+
+#endif // ESP_LOG_H
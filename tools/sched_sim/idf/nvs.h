@@ -0,0 +1,26 @@
+/**
+ * @file nvs.h
+ * @brief NVS 的主机替身 (内存中保存 blob, 仿真期间有效)
+ */
+
+#ifndef NVS_H
+#define NVS_H
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode,
+                   nvs_handle_t *handle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *value,
+                       size_t *length);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key,
+                       const void *value, size_t length);
+esp_err_t nvs_commit(nvs_handle_t handle);
+
+#endif // NVS_H
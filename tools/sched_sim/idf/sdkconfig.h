@@ -0,0 +1,4 @@
+/**
+ * @file sdkconfig.h
+ * @brief 主机仿真不定义 Kconfig 选项, 各模块使用 #ifndef 中的默认值
+ */
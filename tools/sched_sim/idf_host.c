@@ -0,0 +1,119 @@
+/**
+ * @file idf_host.c
+ * @brief idf/ 目录中 ESP-IDF 替身头文件的主机实现
+ */
+
+#include "esp_err.h"
+#include "nvs.h"
+
+#include <string.h>
+
+#define NVS_MAX_ITEMS 8
+#define NVS_MAX_NAME 16  // 与 NVS 一致: namespace/key 最长15字符
+#define NVS_MAX_BLOB 512 // 单个 blob 上限 (字节)
+
+typedef struct {
+  char ns[NVS_MAX_NAME];
+  char key[NVS_MAX_NAME];
+  size_t length;
+  unsigned char data[NVS_MAX_BLOB];
+} nvs_item_t;
+
+static nvs_item_t s_items[NVS_MAX_ITEMS];
+static int s_item_count = 0;
+static const char *s_open_ns[NVS_MAX_ITEMS + 1]; // 句柄 -> namespace
+
+const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+  case ESP_OK:
+    return "ESP_OK";
+  case ESP_FAIL:
+    return "ESP_FAIL";
+  case ESP_ERR_NO_MEM:
+    return "ESP_ERR_NO_MEM";
+  case ESP_ERR_INVALID_ARG:
+    return "ESP_ERR_INVALID_ARG";
+  case ESP_ERR_INVALID_STATE:
+    return "ESP_ERR_INVALID_STATE";
+  case ESP_ERR_INVALID_SIZE:
+    return "ESP_ERR_INVALID_SIZE";
+  case ESP_ERR_NOT_FOUND:
+    return "ESP_ERR_NOT_FOUND";
+  case ESP_ERR_TIMEOUT:
+    return "ESP_ERR_TIMEOUT";
+  case ESP_ERR_NVS_NOT_FOUND:
+    return "ESP_ERR_NVS_NOT_FOUND";
+  default:
+    return "UNKNOWN_ERROR";
+  }
+}
+
+static nvs_item_t *nvs_find(nvs_handle_t handle, const char *key) {
+  for (int i = 0; i < s_item_count; i++) {
+    if (strcmp(s_items[i].ns, s_open_ns[handle]) == 0 &&
+        strcmp(s_items[i].key, key) == 0) {
+      return &s_items[i];
+    }
+  }
+  return NULL;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode,
+                   nvs_handle_t *handle) {
+  (void)mode;
+  if (strlen(name) >= NVS_MAX_NAME) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  for (nvs_handle_t h = 1; h <= NVS_MAX_ITEMS; h++) {
+    if (s_open_ns[h] == NULL) {
+      s_open_ns[h] = name;
+      *handle = h;
+      return ESP_OK;
+    }
+  }
+  return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t handle) { s_open_ns[handle] = NULL; }
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *value,
+                       size_t *length) {
+  const nvs_item_t *item = nvs_find(handle, key);
+  if (item == NULL) {
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+  if (value == NULL) {
+    *length = item->length;
+    return ESP_OK;
+  }
+  if (*length < item->length) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  memcpy(value, item->data, item->length);
+  *length = item->length;
+  return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key,
+                       const void *value, size_t length) {
+  if (strlen(key) >= NVS_MAX_NAME || length > NVS_MAX_BLOB) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  nvs_item_t *item = nvs_find(handle, key);
+  if (item == NULL) {
+    if (s_item_count >= NVS_MAX_ITEMS) {
+      return ESP_ERR_NO_MEM;
+    }
+    item = &s_items[s_item_count++];
+    strcpy(item->ns, s_open_ns[handle]);
+    strcpy(item->key, key);
+  }
+  memcpy(item->data, value, length);
+  item->length = length;
+  return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+  (void)handle;
+  return ESP_OK;
+}
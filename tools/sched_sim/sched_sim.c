@@ -0,0 +1,709 @@
+/**
+ * @file sched_sim.c
+ * @brief 预约/倒计时/软件RTC主机仿真
+ *
+ * 在 vclock.c 的虚拟时钟上运行 components 中真实的 soft_rtc.c 和
+ * scheduler.c (经由 os_port.h)，用替身 temp_control 记录加热开关，
+ * 数秒内模拟数周的运行：
+ *   - 按 --schedule 添加每周重复 (或单次) 预约，与独立计算的应启动时刻
+ *     比较，输出漏触发、多余触发、因加热中跳过的次数和触发误差分布；
+ *     替身按 --lead/--warm-lead 返回冷态/当前读数下的预热时间，
+ *     应启动时刻取两者中较晚者 (到时按当前读数推迟)
+ *   - 每次加热按预约时长倒计时，--pause-prob 的概率在中途手动关机
+ *     1-10分钟，输出按累计开机时长计的倒计时误差
+ *   - 每秒读取软件RTC与参考时钟比较，检查月/年/闰日进位和星期，
+ *     输出偏差范围和最终漂移；--resync 定期校时
+ *   - --tick-subs 订阅RTC秒节拍，检查每个订阅者每秒恰好收到一次且时间
+ *     与参考时钟一致
+ *   - --contention/--hold-ms 在每次获取互斥锁时注入其他任务的持有，
+ *     输出各锁的竞争、失败次数和定时器回调最大延迟
+ *   - 定时器回调总次数即设备上的唤醒次数，输出平均每秒唤醒数
+ * 漏触发、多余触发、RTC字段错误、读取失败或秒节拍缺失时返回1。
+ *
+ * 构建与运行:
+ *   cmake -S tools/sched_sim -B build/sched && cmake --build build/sched
+ *   ./build/sched/sched_sim --weeks 8 --start 2027-12-20 --contention 0.01
+ */
+
+#include "esp_log.h"
+#include "os_port.h"
+#include "scheduler.h"
+#include "soft_rtc.h"
+#include "temp_control.h"
+#include "vclock.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define US_PER_S 1000000LL
+#define MAX_HEATING_S (240 * 60)  // 与 scheduler.c 一致
+#define PREHEAT_DEFAULT_S (5 * 60) // 与 scheduler.c 一致 (未学习时)
+#define SCHEDULE_LATE_S 60         // 与 scheduler.c 一致
+#define MATCH_WINDOW_S 1800        // 触发与应启动时刻的配对范围 (s)
+#define LATE_MS 2000               // 触发误差超过此值计为迟到 (ms)
+#define CHECK_PHASE_US 500000      // RTC检查相对参考整秒的相位 (us)
+#define PAUSE_MIN_S 60             // 手动关机时长范围 (s)
+#define PAUSE_MAX_S 600
+
+/**
+ * @brief 应触发的一次预约
+ */
+typedef struct {
+  int64_t start_s; // 应启动时刻 (参考时钟, Unix秒)
+  int entry;       // --schedule 序号
+  bool matched;    // 已配对到实际触发
+} expected_t;
+
+/**
+ * @brief 一次加热 (预约触发到倒计时关机)
+ */
+typedef struct {
+  bool active;
+  int64_t start_on_us; // 开始时的累计开机时长 (us)
+  int64_t duration_us; // 倒计时时长 (us)
+  int64_t pause_on_us; // 累计开机到此值时手动关机, <0 不关机
+  int64_t resume_us;   // 手动开机时刻 (虚拟时钟), 0 未关机
+} session_t;
+
+/**
+ * @brief 秒节拍订阅者的记录
+ */
+typedef struct {
+  uint32_t calls;
+  uint32_t gaps; // 与上次相差不是1秒的次数 (校时后的第一次不计)
+  int64_t last_s; // 上次的时间 (Unix秒), -1 未收到或刚校时
+} tick_rec_t;
+
+/**
+ * @brief 误差样本
+ */
+typedef struct {
+  int64_t *v;
+  int n;
+  int cap;
+} samples_t;
+
+// 参数
+static schedule_entry_t s_sched[SCHEDULER_MAX_ENTRIES];
+static int s_sched_count = 0;
+static int s_lead_s = 900;
+static int s_warm_lead_s = 600;
+static double s_pause_prob = 0.2;
+static int s_tick_subs = 0;
+static bool s_verbose = false;
+
+// 参考时钟: 最近一次校时时刻的虚拟时钟和墙上时间
+static int64_t s_sync_us = -1;
+static int64_t s_sync_wall_s = 0;
+
+// 替身 temp_control 状态
+static bool s_power = false;
+static int s_target = 60;
+static int64_t s_on_us = 0;    // 已结束的开机时长 (us)
+static int64_t s_on_since = 0; // 本次开机时刻 (us)
+static void (*s_preheat_callback)(void) = NULL;
+
+static expected_t *s_expected = NULL;
+static int s_expected_count = 0;
+static session_t s_session;
+static samples_t s_fire_err;      // 触发误差 (ms)
+static samples_t s_countdown_err; // 倒计时误差 (ms)
+static samples_t s_heat_from;     // 各次加热的开始时刻 (参考时钟, ms)
+static samples_t s_heat_to;       // 各次加热的结束时刻 (参考时钟, ms)
+static int s_spurious = 0;
+static int s_timeouts = 0;
+static tick_rec_t s_ticks[SOFT_RTC_MAX_TICK_SUBSCRIBERS];
+static samples_t s_tick_err; // 秒节拍时间误差 (ms)
+static uint32_t s_rng = 1;
+
+// ============================================================================
+// 工具函数
+// ============================================================================
+
+static uint32_t rng_next(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static double rng_uniform(void) { return rng_next() / 4294967296.0; }
+
+/**
+ * @brief 公历日期到 1970-01-01 起的天数 (与 weekly.c 独立实现)
+ */
+static int64_t days_from_civil(int y, int m, int d) {
+  y -= m <= 2;
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int *y, int *m, int *d) {
+  z += 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  int64_t doe = z - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153;
+  *d = (int)(doy - (153 * mp + 2) / 5 + 1);
+  *m = (int)(mp < 10 ? mp + 3 : mp - 9);
+  *y = (int)(yoe + era * 400 + (*m <= 2));
+}
+
+/**
+ * @brief 星期 (1-7, 1=周一), 1970-01-01 为周四
+ */
+static int weekday_from_days(int64_t days) {
+  int64_t w = (days + 3) % 7;
+  return (int)(w < 0 ? w + 7 : w) + 1;
+}
+
+static int days_in_month(int y, int m) {
+  return (int)(days_from_civil(m == 12 ? y + 1 : y, m == 12 ? 1 : m + 1, 1) -
+               days_from_civil(y, m, 1));
+}
+
+static void wall_to_rtc(int64_t wall_s, rtc_time_t *t) {
+  int64_t days = wall_s / 86400;
+  int sod = (int)(wall_s % 86400);
+  civil_from_days(days, &t->year, &t->month, &t->day);
+  t->hour = sod / 3600;
+  t->minute = sod / 60 % 60;
+  t->second = sod % 60;
+  t->weekday = weekday_from_days(days);
+}
+
+static void format_wall(int64_t wall_s, char *buf, size_t size) {
+  rtc_time_t t;
+  wall_to_rtc(wall_s, &t);
+  snprintf(buf, size, "%04d-%02d-%02d %02d:%02d:%02d", t.year, t.month, t.day,
+           t.hour, t.minute, t.second);
+}
+
+/**
+ * @brief 参考时钟 (Unix时间, ms)
+ */
+static int64_t ref_ms(void) {
+  return s_sync_wall_s * 1000 + (os_now_us() - s_sync_us) / 1000;
+}
+
+static void sample_add(samples_t *s, int64_t v) {
+  if (s->n == s->cap) {
+    s->cap = s->cap ? s->cap * 2 : 256;
+    s->v = realloc(s->v, sizeof(*s->v) * (size_t)s->cap);
+    if (s->v == NULL) {
+      perror("realloc");
+      exit(2);
+    }
+  }
+  s->v[s->n++] = v;
+}
+
+static int cmp_i64(const void *a, const void *b) {
+  int64_t x = *(const int64_t *)a;
+  int64_t y = *(const int64_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void print_dist(const char *name, samples_t *s) {
+  if (s->n == 0) {
+    printf("%-14s n=0\n", name);
+    return;
+  }
+  qsort(s->v, (size_t)s->n, sizeof(*s->v), cmp_i64);
+  printf("%-14s n=%-5d min %7lld  p50 %7lld  p90 %7lld  p99 %7lld  max %7lld"
+         " ms\n",
+         name, s->n, (long long)s->v[0], (long long)s->v[s->n / 2],
+         (long long)s->v[s->n * 9 / 10], (long long)s->v[s->n * 99 / 100],
+         (long long)s->v[s->n - 1]);
+}
+
+void host_log(char level, const char *tag, const char *fmt, ...) {
+  if (!s_verbose && level != 'E') {
+    return;
+  }
+  printf("%12.3f %c %s: ", os_now_us() / 1e6, level, tag);
+  va_list ap;
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+  printf("\n");
+}
+
+static int64_t rtc_to_wall(const rtc_time_t *t) {
+  return days_from_civil(t->year, t->month, t->day) * 86400 + t->hour * 3600 +
+         t->minute * 60 + t->second;
+}
+
+static void on_tick(const rtc_time_t *now, void *arg) {
+  tick_rec_t *rec = arg;
+  if (s_sync_us < 0) {
+    return; // 校时前没有参考时间
+  }
+  int64_t wall = rtc_to_wall(now);
+  if (rec->last_s >= 0 && wall != rec->last_s + 1) {
+    rec->gaps++;
+  }
+  rec->last_s = wall;
+  rec->calls++;
+  if (rec == &s_ticks[0]) {
+    sample_add(&s_tick_err, wall * 1000 - ref_ms());
+  }
+}
+
+// ============================================================================
+// 替身 temp_control (scheduler.c 使用的接口)
+// ============================================================================
+
+int64_t temp_control_get_on_time_us(void) {
+  return s_on_us + (s_power ? os_now_us() - s_on_since : 0);
+}
+
+static void heater_apply(bool on) {
+  if (on && !s_power) {
+    s_on_since = os_now_us();
+  } else if (!on && s_power) {
+    s_on_us += os_now_us() - s_on_since;
+  }
+  s_power = on;
+}
+
+static int lead_effective(bool cold) {
+  int lead = temp_control_get_preheat_s(s_target, cold);
+  if (lead < 0) {
+    return PREHEAT_DEFAULT_S;
+  }
+  return lead < MAX_HEATING_S ? lead : MAX_HEATING_S;
+}
+
+/**
+ * @brief 预约触发: 与应启动时刻配对并开始记录本次加热
+ */
+static void on_fire(void) {
+  int64_t now_ms = ref_ms();
+  expected_t *best = NULL;
+  int64_t best_dist = MATCH_WINDOW_S * 1000 + 1;
+  for (int i = 0; i < s_expected_count; i++) {
+    expected_t *e = &s_expected[i];
+    int64_t dist = llabs(now_ms - e->start_s * 1000);
+    if (!e->matched && dist < best_dist) {
+      best = e;
+      best_dist = dist;
+    }
+  }
+  if (best == NULL) {
+    char buf[24];
+    format_wall(now_ms / 1000, buf, sizeof(buf));
+    printf("spurious fire at %s\n", buf);
+    s_spurious++;
+    return;
+  }
+  best->matched = true;
+  sample_add(&s_fire_err, now_ms - best->start_s * 1000);
+  sample_add(&s_heat_from, now_ms);
+
+  const schedule_entry_t *e = &s_sched[best->entry];
+  s_session.active = true;
+  s_session.start_on_us = temp_control_get_on_time_us();
+  s_session.duration_us = (int64_t)e->duration_min * 60 * US_PER_S;
+  s_session.pause_on_us = -1;
+  s_session.resume_us = 0;
+  if (rng_uniform() < s_pause_prob) {
+    s_session.pause_on_us =
+        s_session.start_on_us +
+        (int64_t)(rng_uniform() * (double)s_session.duration_us);
+  }
+}
+
+void temp_control_set_power(bool on) {
+  if (on && !s_power) {
+    on_fire();
+  } else if (!on && s_power && s_session.active) {
+    int64_t ran = temp_control_get_on_time_us() - s_session.start_on_us;
+    sample_add(&s_countdown_err, (ran - s_session.duration_us) / 1000);
+    sample_add(&s_heat_to, ref_ms());
+    s_session.active = false;
+  }
+  heater_apply(on);
+}
+
+bool temp_control_get_power(void) { return s_power; }
+
+void temp_control_set_target_temp(int temp) { s_target = temp; }
+
+int temp_control_get_target_temp(void) { return s_target; }
+
+int32_t temp_control_get_preheat_s(int target, bool cold) {
+  (void)target;
+  return cold ? s_lead_s : s_warm_lead_s;
+}
+
+void temp_control_set_preheat_callback(void (*callback)(void)) {
+  s_preheat_callback = callback;
+}
+
+void temp_control_set_power_off_callback(void (*callback)(void)) {
+  (void)callback;
+}
+
+// ============================================================================
+// 应触发时刻
+// ============================================================================
+
+/**
+ * @brief 按参考时钟独立计算 [from_s, to_s) 内各预约的应启动时刻
+ */
+static void expected_build(int64_t from_s, int64_t to_s) {
+  int64_t lead = lead_effective(true);
+  int64_t warm = lead_effective(false);
+  if (warm < lead) {
+    lead = warm; // 到时按当前读数推迟
+  }
+
+  int cap = (int)((to_s - from_s) / 86400 + 3) * (s_sched_count + 1);
+  s_expected = calloc((size_t)cap, sizeof(*s_expected));
+  if (s_expected == NULL) {
+    perror("calloc");
+    exit(2);
+  }
+  for (int i = 0; i < s_sched_count; i++) {
+    const schedule_entry_t *e = &s_sched[i];
+    for (int64_t day = from_s / 86400; day * 86400 < to_s + lead; day++) {
+      int wd = weekday_from_days(day);
+      if (e->weekdays != 0 && !(e->weekdays & (1u << (wd - 1)))) {
+        continue;
+      }
+      int64_t start = day * 86400 + e->minute * 60 - lead;
+      if (start < from_s - SCHEDULE_LATE_S + 1 || start >= to_s) {
+        continue; // 校时前刚过的仍会触发
+      }
+      expected_t *x = &s_expected[s_expected_count++];
+      x->start_s = start;
+      x->entry = i;
+      if (e->weekdays == 0) {
+        break; // 单次预约
+      }
+    }
+  }
+}
+
+// ============================================================================
+// 参数
+// ============================================================================
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --weeks N                simulated weeks (default 4)\n"
+          "  --start YYYY-MM-DD[ HH:MM:SS]\n"
+          "                           wall time at first sync\n"
+          "                           (default 2028-02-20, spans a leap day)\n"
+          "  --sync-at S              first RTC sync after boot"
+          " (default 30.25)\n"
+          "  --resync H               re-sync RTC every H hours (default 0,"
+          " never)\n"
+          "  --schedule HH:MM/DAYS/MIN  entry, repeatable; DAYS digits 1-7"
+          " (1=Mon)\n"
+          "                           or 'once' (default 07:00/12345/30,\n"
+          "                           09:30/67/45, 18:45/1234567/20)\n"
+          "  --lead S                 learned cold preheat (default 900,"
+          " -1 unlearned)\n"
+          "  --warm-lead S            learned preheat from current reading"
+          " (600)\n"
+          "  --pause-prob P           manual off/on during a countdown"
+          " (0.2)\n"
+          "  --tick-subs N            RTC tick subscribers (default 0,"
+          " max %d)\n"
+          "  --contention P           lock busy probability per take"
+          " (default 0.001)\n"
+          "  --hold-ms MS             max hold by the other task (default 20)\n"
+          "  --seed N                 random seed (default 1)\n"
+          "  -v                       log scheduler output\n",
+          prog, SOFT_RTC_MAX_TICK_SUBSCRIBERS);
+}
+
+static bool parse_schedule(const char *arg, schedule_entry_t *e) {
+  char days[16];
+  int dur;
+  int minute = scheduler_parse_time(arg);
+  if (minute < 0 || sscanf(arg + 5, "/%15[^/]/%d", days, &dur) != 2 ||
+      dur <= 0 || dur > MAX_HEATING_S / 60) {
+    return false;
+  }
+  memset(e, 0, sizeof(*e));
+  e->minute = (uint16_t)minute;
+  e->duration_min = (uint16_t)dur;
+  if (strcmp(days, "once") == 0) {
+    return true;
+  }
+  for (const char *p = days; *p; p++) {
+    if (*p < '1' || *p > '7') {
+      return false;
+    }
+    e->weekdays |= 1u << (*p - '1');
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  int weeks = 4;
+  int start_y = 2028, start_mo = 2, start_d = 20;
+  int start_h = 0, start_mi = 0, start_s = 0;
+  double sync_at = 30.25; // 与RTC节拍错开, 校时后RTC落后0.25s
+  int resync_h = 0;
+  double contention = 0.001;
+  int hold_ms = 20;
+  uint32_t seed = 1;
+
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+    if (strcmp(a, "-v") == 0) {
+      s_verbose = true;
+      continue;
+    }
+    if (v == NULL) {
+      usage(argv[0]);
+      return 2;
+    }
+    i++;
+    if (strcmp(a, "--weeks") == 0) {
+      weeks = atoi(v);
+    } else if (strcmp(a, "--start") == 0) {
+      start_h = start_mi = start_s = 0;
+      if (sscanf(v, "%d-%d-%d %d:%d:%d", &start_y, &start_mo, &start_d,
+                 &start_h, &start_mi, &start_s) < 3) {
+        usage(argv[0]);
+        return 2;
+      }
+    } else if (strcmp(a, "--sync-at") == 0) {
+      sync_at = atof(v);
+    } else if (strcmp(a, "--resync") == 0) {
+      resync_h = atoi(v);
+    } else if (strcmp(a, "--schedule") == 0) {
+      if (s_sched_count >= SCHEDULER_MAX_ENTRIES ||
+          !parse_schedule(v, &s_sched[s_sched_count])) {
+        usage(argv[0]);
+        return 2;
+      }
+      s_sched_count++;
+    } else if (strcmp(a, "--lead") == 0) {
+      s_lead_s = atoi(v);
+    } else if (strcmp(a, "--warm-lead") == 0) {
+      s_warm_lead_s = atoi(v);
+    } else if (strcmp(a, "--pause-prob") == 0) {
+      s_pause_prob = atof(v);
+    } else if (strcmp(a, "--tick-subs") == 0) {
+      s_tick_subs = atoi(v);
+    } else if (strcmp(a, "--contention") == 0) {
+      contention = atof(v);
+    } else if (strcmp(a, "--hold-ms") == 0) {
+      hold_ms = atoi(v);
+    } else if (strcmp(a, "--seed") == 0) {
+      seed = (uint32_t)strtoul(v, NULL, 0);
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (weeks <= 0 || start_mo < 1 || start_mo > 12 || start_d < 1 ||
+      start_d > days_in_month(start_y, start_mo) || sync_at < 0 ||
+      s_tick_subs < 0 || s_tick_subs > SOFT_RTC_MAX_TICK_SUBSCRIBERS) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (s_sched_count == 0) {
+    const char *defaults[] = {"07:00/12345/30", "09:30/67/45",
+                              "18:45/1234567/20"};
+    for (int i = 0; i < 3; i++) {
+      parse_schedule(defaults[i], &s_sched[s_sched_count++]);
+    }
+  }
+  if (s_warm_lead_s < 0) {
+    s_warm_lead_s = s_lead_s;
+  }
+  s_rng = seed != 0 ? seed : 1;
+  vclock_set_contention(contention, (int64_t)hold_ms * 1000, seed * 7 + 1);
+
+  const int64_t wall0 =
+      days_from_civil(start_y, start_mo, start_d) * 86400 + start_h * 3600 +
+      start_mi * 60 + start_s;
+  const int64_t sync_us = (int64_t)(sync_at * US_PER_S);
+  const int64_t end_us = sync_us + (int64_t)weeks * 7 * 86400 * US_PER_S;
+
+  // 上电: 与 main.c 相同的初始化顺序, 预约在校时前添加
+  if (soft_rtc_init() != ESP_OK || scheduler_init() != ESP_OK) {
+    fprintf(stderr, "init failed\n");
+    return 2;
+  }
+  scheduler_set_timeout_callback(NULL);
+  for (int i = 0; i < s_sched_count; i++) {
+    if (scheduler_add_entry(&s_sched[i], NULL) != ESP_OK) {
+      fprintf(stderr, "scheduler_add_entry %d failed\n", i);
+      return 2;
+    }
+  }
+  for (int i = 0; i < s_tick_subs; i++) {
+    s_ticks[i].last_s = -1;
+    soft_rtc_subscribe_tick(on_tick, &s_ticks[i]);
+  }
+  expected_build(wall0, wall0 + (end_us - sync_us) / US_PER_S);
+
+  int64_t next_sync_us = sync_us;
+  int64_t next_check_us = next_sync_us + CHECK_PHASE_US;
+  int64_t rtc_err_min = 0, rtc_err_max = 0, rtc_err_last = 0;
+  int rtc_checks = 0, rtc_bad = 0, rollover_days = 0, rollover_months = 0;
+  int rollover_years = 0, leap_days = 0;
+  rtc_time_t prev = {0};
+
+  while (os_now_us() < end_us) {
+    int64_t next = next_check_us < next_sync_us ? next_check_us : next_sync_us;
+    if (s_session.resume_us > 0 && s_session.resume_us < next) {
+      next = s_session.resume_us;
+    }
+    vclock_run_until(next);
+    int64_t now = os_now_us();
+
+    if (now >= next_sync_us) {
+      int64_t wall = wall0 + (next_sync_us - sync_us) / US_PER_S;
+      rtc_time_t t;
+      wall_to_rtc(wall, &t);
+      s_sync_us = now;
+      s_sync_wall_s = wall;
+      for (int i = 0; i < s_tick_subs; i++) {
+        s_ticks[i].last_s = -1; // 校时改变整秒相位, 可能跳过或重复一秒
+      }
+      if (soft_rtc_set_time(&t) != ESP_OK) {
+        s_timeouts++;
+      }
+      next_sync_us = resync_h > 0 ? next_sync_us + resync_h * 3600 * US_PER_S
+                                  : INT64_MAX;
+    }
+
+    // 手动关机/开机 (其他任务调用 temp_control_set_power)
+    if (s_session.resume_us > 0 && now >= s_session.resume_us) {
+      s_session.resume_us = 0;
+      heater_apply(true);
+    } else if (s_session.active && s_power && s_session.pause_on_us >= 0 &&
+               temp_control_get_on_time_us() >= s_session.pause_on_us) {
+      s_session.pause_on_us = -1;
+      heater_apply(false);
+      s_session.resume_us =
+          now + (PAUSE_MIN_S + rng_next() % (PAUSE_MAX_S - PAUSE_MIN_S + 1)) *
+                    US_PER_S;
+    }
+
+    if (now < next_check_us) {
+      continue;
+    }
+    next_check_us += US_PER_S;
+
+    rtc_time_t t;
+    if (soft_rtc_get_time(&t) != ESP_OK) {
+      s_timeouts++;
+      continue;
+    }
+    rtc_checks++;
+    bool valid = t.month >= 1 && t.month <= 12 && t.day >= 1 &&
+                 t.day <= days_in_month(t.year, t.month) && t.hour < 24 &&
+                 t.minute < 60 && t.second < 60;
+    int64_t days = valid ? days_from_civil(t.year, t.month, t.day) : 0;
+    if (!valid || t.weekday != weekday_from_days(days)) {
+      if (rtc_bad++ < 10) {
+        printf("bad RTC fields %04d-%02d-%02d %02d:%02d:%02d weekday %d\n",
+               t.year, t.month, t.day, t.hour, t.minute, t.second, t.weekday);
+      }
+      continue;
+    }
+    int64_t err = rtc_to_wall(&t) * 1000 - ref_ms();
+    rtc_err_min = rtc_checks == 1 || err < rtc_err_min ? err : rtc_err_min;
+    rtc_err_max = rtc_checks == 1 || err > rtc_err_max ? err : rtc_err_max;
+    rtc_err_last = err;
+    if (rtc_checks > 1 && t.day != prev.day) {
+      rollover_days++;
+      rollover_months += t.month != prev.month;
+      rollover_years += t.year != prev.year;
+      leap_days += t.month == 2 && t.day == 29;
+    }
+    prev = t;
+  }
+
+  // 加热中 (含中途手动关机) 到期的预约按设计跳过
+  if (s_session.active) {
+    sample_add(&s_heat_to, ref_ms());
+  }
+  int missed = 0, busy = 0;
+  for (int i = 0; i < s_expected_count; i++) {
+    const expected_t *x = &s_expected[i];
+    if (x->matched) {
+      continue;
+    }
+    bool heating = false;
+    for (int k = 0; k < s_heat_from.n && !heating; k++) {
+      heating = s_heat_from.v[k] <= x->start_s * 1000 &&
+                x->start_s * 1000 <= s_heat_to.v[k];
+    }
+    if (heating) {
+      busy++;
+    } else if (missed++ < 10) {
+      char buf[24];
+      format_wall(x->start_s, buf, sizeof(buf));
+      printf("missed schedule %d at %s\n", x->entry, buf);
+    }
+  }
+
+  char from[24], to[24];
+  format_wall(wall0, from, sizeof(from));
+  format_wall(s_sync_wall_s + (end_us - s_sync_us) / US_PER_S, to, sizeof(to));
+  printf("sched_sim: %s .. %s, %d schedules, lead %d/%d s, contention %.4f"
+         " (hold <= %d ms), seed %u\n",
+         from, to, s_sched_count, lead_effective(true), lead_effective(false),
+         contention, hold_ms, seed);
+  printf("fires          expected %d, fired %d, skipped while heating %d, "
+         "missed %d, spurious %d, late (>%d ms) ",
+         s_expected_count, s_fire_err.n, busy, missed, s_spurious, LATE_MS);
+  int late = 0;
+  for (int i = 0; i < s_fire_err.n; i++) {
+    late += s_fire_err.v[i] > LATE_MS;
+  }
+  printf("%d\n", late);
+  print_dist("fire error", &s_fire_err);
+  print_dist("countdown err", &s_countdown_err);
+  printf("rtc            checks %d, bad fields %d, read timeouts %d, "
+         "error %lld .. %lld ms, final %lld ms\n",
+         rtc_checks, rtc_bad, s_timeouts, (long long)rtc_err_min,
+         (long long)rtc_err_max, (long long)rtc_err_last);
+  printf("rollovers      days %d, months %d, years %d, leap days %d\n",
+         rollover_days, rollover_months, rollover_years, leap_days);
+  const char *lock_names[] = {"soft_rtc", "scheduler"};
+  for (int i = 0; i < 2; i++) {
+    vclock_lock_stats_t st;
+    if (vclock_lock_stats(i, &st)) {
+      printf("lock %-9s takes %u, busy %u, failed %u, wait max %lld us\n",
+             lock_names[i], st.takes, st.busy, st.failed,
+             (long long)st.wait_max);
+    }
+  }
+  uint32_t calls = 0, gaps = 0;
+  for (int i = 0; i < s_tick_subs; i++) {
+    calls += s_ticks[i].calls;
+    gaps += s_ticks[i].gaps;
+  }
+  if (s_tick_subs > 0) {
+    printf("ticks          subscribers %d, calls %u, gaps %u\n", s_tick_subs,
+           calls, gaps);
+    print_dist("tick error", &s_tick_err);
+  }
+  printf("timer latency  max %lld us\n", (long long)vclock_max_latency_us());
+  printf("wakeups        %llu timer callbacks, %.4f/s\n",
+         (unsigned long long)vclock_dispatches(),
+         (double)vclock_dispatches() * US_PER_S / (double)end_us);
+
+  return missed > 0 || s_spurious > 0 || rtc_bad > 0 || s_timeouts > 0 ||
+         gaps > 0;
+}
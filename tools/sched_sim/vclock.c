@@ -0,0 +1,192 @@
+/**
+ * @file vclock.c
+ * @brief os_port.h 的虚拟时钟实现
+ */
+
+#include "vclock.h"
+#include "os_port.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct os_timer {
+  void (*callback)(void *);
+  void *arg;
+  const char *name;
+  bool active;
+  int64_t due_us;
+  uint64_t period_us; // 0 为单次
+};
+
+struct os_lock {
+  bool held;             // 被仿真中的代码持有
+  int64_t busy_until_us; // 被其他任务持有到此时刻
+  vclock_lock_stats_t stats;
+};
+
+static int64_t s_now_us = 0;
+static int64_t s_max_latency_us = 0;
+static uint64_t s_dispatches = 0;
+static struct os_timer s_timers[VCLOCK_MAX_TIMERS];
+static int s_timer_count = 0;
+static struct os_lock s_locks[VCLOCK_MAX_LOCKS];
+static int s_lock_count = 0;
+
+static double s_contention = 0.0;
+static int64_t s_hold_max_us = 0;
+static uint32_t s_rng = 1;
+
+/**
+ * @brief xorshift32, 各平台结果一致便于复现
+ */
+static uint32_t rng_next(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static double rng_uniform(void) { return rng_next() / 4294967296.0; }
+
+void vclock_set_contention(double prob, int64_t hold_max_us, uint32_t seed) {
+  s_contention = prob;
+  s_hold_max_us = hold_max_us > 0 ? hold_max_us : 1;
+  s_rng = seed != 0 ? seed : 1;
+}
+
+void vclock_run_until(int64_t t_us) {
+  for (;;) {
+    struct os_timer *next = NULL;
+    for (int i = 0; i < s_timer_count; i++) {
+      struct os_timer *tm = &s_timers[i];
+      if (tm->active && tm->due_us <= t_us &&
+          (next == NULL || tm->due_us < next->due_us)) {
+        next = tm;
+      }
+    }
+    if (next == NULL) {
+      break;
+    }
+
+    int64_t due = next->due_us;
+    if (due > s_now_us) {
+      s_now_us = due;
+    } else if (s_now_us - due > s_max_latency_us) {
+      s_max_latency_us = s_now_us - due;
+    }
+    if (next->period_us > 0) {
+      // 与 esp_timer 相同: 下次到期按上次的计划时刻累加, 不因延迟漂移
+      next->due_us += (int64_t)next->period_us;
+    } else {
+      next->active = false;
+    }
+    s_dispatches++;
+    next->callback(next->arg);
+  }
+  if (t_us > s_now_us) {
+    s_now_us = t_us;
+  }
+}
+
+int64_t vclock_max_latency_us(void) { return s_max_latency_us; }
+
+uint64_t vclock_dispatches(void) { return s_dispatches; }
+
+bool vclock_lock_stats(int index, vclock_lock_stats_t *stats) {
+  if (index < 0 || index >= s_lock_count) {
+    return false;
+  }
+  *stats = s_locks[index].stats;
+  return true;
+}
+
+// ============================================================================
+// os_port.h
+// ============================================================================
+
+int64_t os_now_us(void) { return s_now_us; }
+
+esp_err_t os_timer_create(void (*callback)(void *), void *arg,
+                          const char *name, os_timer_t *timer) {
+  if (s_timer_count >= VCLOCK_MAX_TIMERS) {
+    return ESP_ERR_NO_MEM;
+  }
+  struct os_timer *tm = &s_timers[s_timer_count++];
+  tm->callback = callback;
+  tm->arg = arg;
+  tm->name = name;
+  tm->active = false;
+  *timer = tm;
+  return ESP_OK;
+}
+
+esp_err_t os_timer_start_once(os_timer_t timer, uint64_t timeout_us) {
+  if (timer->active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->active = true;
+  timer->due_us = s_now_us + (int64_t)timeout_us;
+  timer->period_us = 0;
+  return ESP_OK;
+}
+
+esp_err_t os_timer_start_periodic(os_timer_t timer, uint64_t period_us) {
+  if (timer->active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->active = true;
+  timer->due_us = s_now_us + (int64_t)period_us;
+  timer->period_us = period_us;
+  return ESP_OK;
+}
+
+esp_err_t os_timer_stop(os_timer_t timer) {
+  if (!timer->active) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->active = false;
+  return ESP_OK;
+}
+
+os_lock_t os_lock_create(void) {
+  if (s_lock_count >= VCLOCK_MAX_LOCKS) {
+    return NULL;
+  }
+  return &s_locks[s_lock_count++];
+}
+
+bool os_lock_take(os_lock_t lock, int timeout_ms) {
+  if (lock->held) {
+    // 单线程仿真中重复获取即为真实设备上的死锁
+    fprintf(stderr, "vclock: lock %d taken twice (deadlock) at %lld us\n",
+            (int)(lock - s_locks), (long long)s_now_us);
+    abort();
+  }
+
+  lock->stats.takes++;
+  if (s_now_us >= lock->busy_until_us && rng_uniform() < s_contention) {
+    lock->busy_until_us =
+        s_now_us + 1 + (int64_t)(rng_next() % (uint32_t)s_hold_max_us);
+  }
+  if (s_now_us < lock->busy_until_us) {
+    lock->stats.busy++;
+    int64_t wait = lock->busy_until_us - s_now_us;
+    if (timeout_ms == 0 ||
+        (timeout_ms > 0 && wait > (int64_t)timeout_ms * 1000)) {
+      lock->stats.failed++;
+      if (timeout_ms > 0) {
+        s_now_us += (int64_t)timeout_ms * 1000;
+      }
+      return false;
+    }
+    s_now_us = lock->busy_until_us;
+    lock->stats.wait_us += wait;
+    if (wait > lock->stats.wait_max) {
+      lock->stats.wait_max = wait;
+    }
+  }
+  lock->held = true;
+  return true;
+}
+
+void os_lock_give(os_lock_t lock) { lock->held = false; }
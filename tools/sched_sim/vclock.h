@@ -0,0 +1,68 @@
+/**
+ * @file vclock.h
+ * @brief os_port.h 的虚拟时钟实现 (主机仿真)
+ *
+ * 时间只在 vclock_run_until() 中推进，按到期顺序在同一线程中依次执行
+ * 定时器回调 (与 esp_timer 任务相同，回调之间串行)。
+ * 互斥锁可注入竞争：每次获取时以给定概率视为被其他任务持有一段随机时间，
+ * 不等待的获取失败，等待的获取把虚拟时钟推进到释放时刻 (超时则失败)
+ */
+
+#ifndef VCLOCK_H
+#define VCLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define VCLOCK_MAX_TIMERS 8
+#define VCLOCK_MAX_LOCKS 8
+
+/**
+ * @brief 单个互斥锁的统计
+ */
+typedef struct {
+  uint32_t takes;   // 获取次数
+  uint32_t busy;    // 遇到其他任务持有的次数
+  uint32_t failed;  // 获取失败次数 (不等待或超时)
+  int64_t wait_us;  // 等待获取的累计时间 (us)
+  int64_t wait_max; // 单次最长等待 (us)
+} vclock_lock_stats_t;
+
+/**
+ * @brief 设置锁竞争
+ *
+ * @param prob 每次获取时被其他任务持有的概率 (0-1)
+ * @param hold_max_us 其他任务的持有时长上限, 在 [1, hold_max_us] 内均匀分布
+ * @param seed 随机数种子
+ */
+void vclock_set_contention(double prob, int64_t hold_max_us, uint32_t seed);
+
+/**
+ * @brief 执行到期时刻不晚于 t_us 的全部定时器回调，然后把时钟推进到 t_us
+ *
+ * 回调中的等待可能已使时钟越过 t_us, 此时不回退
+ *
+ * @param t_us 目标时刻 (us)
+ */
+void vclock_run_until(int64_t t_us);
+
+/**
+ * @brief 定时器回调相对到期时刻的最大延迟 (us)
+ */
+int64_t vclock_max_latency_us(void);
+
+/**
+ * @brief 已执行的定时器回调次数 (设备上每次对应一次唤醒)
+ */
+uint64_t vclock_dispatches(void);
+
+/**
+ * @brief 读取互斥锁统计
+ *
+ * @param index 按创建顺序的序号
+ * @param stats 输出统计
+ * @return true 序号有效
+ */
+bool vclock_lock_stats(int index, vclock_lock_stats_t *stats);
+
+#endif // VCLOCK_H
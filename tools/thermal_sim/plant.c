@@ -0,0 +1,141 @@
+/**
+ * @file plant.c
+ * @brief 加热杯垫集总热模型实现
+ */
+
+#include "plant.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define T25_KELVIN 298.15f
+#define VREF_MV 3300
+#define ADC_RAW_MAX 4095
+#define OVERSAMPLE_BITS 4 // 与 ntc_sampler.c 一致
+#define MAX_MEDIAN 31
+
+void plant_default_params(plant_params_t *p) {
+  p->heater_power_w = 15.0f;
+  p->plate_c = 60.0f;
+  p->cup_c = 1200.0f;
+  p->g_plate_amb = 0.08f;
+  p->g_plate_cup = 0.5f;
+  p->g_cup_amb = 0.15f;
+  p->ambient = 25.0f;
+  p->sensor_tau = 3.0f;
+  p->adc_noise_lsb = 3.0f;
+  p->adc_oversample = 200;
+  p->adc_median = 9;
+
+  p->ntc_beta = 3950.0f;
+  p->ntc_r25 = 10000.0f;
+  p->ntc_series_r = 10000.0f;
+}
+
+void plant_init(plant_t *pl, const plant_params_t *p, uint32_t seed) {
+  pl->p = *p;
+  pl->plate = p->ambient;
+  pl->cup = p->ambient;
+  pl->sensor = p->ambient;
+  pl->sensor_detached = false;
+  pl->energy_j = 0.0;
+  pl->rng = seed ? seed : 1;
+}
+
+void plant_step(plant_t *pl, float duty, float dt) {
+  const plant_params_t *p = &pl->p;
+  if (duty < 0.0f) {
+    duty = 0.0f;
+  } else if (duty > 1.0f) {
+    duty = 1.0f;
+  }
+
+  float q_heater = p->heater_power_w * duty;
+  float q_plate_amb = p->g_plate_amb * (pl->plate - p->ambient);
+  float q_plate_cup = p->cup_c > 0.0f ? p->g_plate_cup * (pl->plate - pl->cup)
+                                      : 0.0f;
+
+  pl->plate += (q_heater - q_plate_amb - q_plate_cup) / p->plate_c * dt;
+  if (p->cup_c > 0.0f) {
+    float q_cup_amb = p->g_cup_amb * (pl->cup - p->ambient);
+    pl->cup += (q_plate_cup - q_cup_amb) / p->cup_c * dt;
+  }
+
+  // NTC一阶滞后 (脱落后悬空, 按约10倍时间常数向环境温度靠拢)
+  if (pl->sensor_detached) {
+    float tau = p->sensor_tau > 0.0f ? p->sensor_tau * 10.0f : 30.0f;
+    pl->sensor += (p->ambient - pl->sensor) * dt / (tau + dt);
+  } else if (p->sensor_tau > 0.0f) {
+    pl->sensor += (pl->plate - pl->sensor) * dt / (p->sensor_tau + dt);
+  } else {
+    pl->sensor = pl->plate;
+  }
+
+  pl->energy_j += (double)q_heater * dt;
+}
+
+/**
+ * @brief xorshift32 均匀分布 [0, 1)
+ */
+static float rand_uniform(plant_t *pl) {
+  uint32_t x = pl->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  pl->rng = x;
+  return (float)(x >> 8) / 16777216.0f;
+}
+
+/**
+ * @brief 近似标准正态分布 (12个均匀分布求和)
+ */
+static float rand_gauss(plant_t *pl) {
+  float sum = 0.0f;
+  for (int i = 0; i < 12; i++) {
+    sum += rand_uniform(pl);
+  }
+  return sum - 6.0f;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+int plant_read_mv(plant_t *pl) {
+  const plant_params_t *p = &pl->p;
+
+  // NTC在分压下端: V = Vref * Rntc / (Rntc + Rs)
+  float t_k = pl->sensor + 273.15f;
+  float r_ntc =
+      p->ntc_r25 * expf(p->ntc_beta * (1.0f / t_k - 1.0f / T25_KELVIN));
+  float code = (float)ADC_RAW_MAX * r_ntc / (r_ntc + p->ntc_series_r);
+
+  // 每个抽取值为 adc_oversample 个采样的均值, 噪声按 sqrt(N) 缩小；
+  // 单次采样先量化，均值保留 OVERSAMPLE_BITS 位小数
+  int n = p->adc_oversample > 0 ? p->adc_oversample : 1;
+  int m = p->adc_median > 0 ? p->adc_median : 1;
+  if (m > MAX_MEDIAN) {
+    m = MAX_MEDIAN;
+  }
+  uint32_t window[MAX_MEDIAN];
+  for (int k = 0; k < m; k++) {
+    float mean;
+    if (n == 1) {
+      mean = roundf(code + p->adc_noise_lsb * rand_gauss(pl));
+    } else {
+      mean = code + p->adc_noise_lsb / sqrtf((float)n) * rand_gauss(pl);
+    }
+    if (mean < 0.0f) {
+      mean = 0.0f;
+    } else if (mean > (float)ADC_RAW_MAX) {
+      mean = (float)ADC_RAW_MAX;
+    }
+    window[k] = (uint32_t)lroundf(mean * (float)(1 << OVERSAMPLE_BITS));
+  }
+  qsort(window, (size_t)m, sizeof(window[0]), cmp_u32);
+
+  // 无校准时的线性换算
+  return (int)((int64_t)window[m / 2] * VREF_MV /
+               ((int64_t)ADC_RAW_MAX << OVERSAMPLE_BITS));
+}
@@ -0,0 +1,85 @@
+/**
+ * @file plant.h
+ * @brief 加热杯垫集总热模型 (主机仿真)
+ *
+ * 两节点模型：加热板 + 杯子(液体)，各自向环境散热，
+ * 加热板与杯子之间通过接触热导换热。NTC贴在加热板上，
+ * 带一阶传感器滞后，经分压、ADC噪声和12位量化后得到读数
+ */
+
+#ifndef PLANT_H
+#define PLANT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 热模型参数
+ */
+typedef struct {
+  float heater_power_w; // 满占空比加热功率 (W)
+  float plate_c;        // 加热板热容 (J/K)
+  float cup_c;          // 杯子+液体热容 (J/K), 0 表示空载
+  float g_plate_amb;    // 加热板-环境热导 (W/K)
+  float g_plate_cup;    // 加热板-杯子热导 (W/K)
+  float g_cup_amb;      // 杯子-环境热导 (W/K)
+  float ambient;        // 环境温度 (°C)
+  float sensor_tau;     // NTC一阶滞后时间常数 (s)
+  float adc_noise_lsb;  // 单次ADC采样噪声标准差 (LSB)
+  int adc_oversample;   // 每个抽取值平均的采样数 (与 ntc_sampler 一致)
+  int adc_median;       // 中值滤波窗口 (抽取值个数)
+
+  // NTC分压 (与 Kconfig 默认值一致)
+  float ntc_beta;
+  float ntc_r25;
+  float ntc_series_r;
+} plant_params_t;
+
+/**
+ * @brief 热模型状态
+ */
+typedef struct {
+  plant_params_t p;
+  float plate;  // 加热板温度 (°C)
+  float cup;    // 杯子温度 (°C)
+  float sensor; // NTC自身温度 (°C)
+  bool sensor_detached; // NTC脱离加热板 (仅与环境换热)
+  double energy_j; // 累计加热能量 (J)
+  uint32_t rng;    // 噪声随机数状态
+} plant_t;
+
+/**
+ * @brief 填充默认参数 (约15W USB杯垫 + 250ml陶瓷杯)
+ */
+void plant_default_params(plant_params_t *p);
+
+/**
+ * @brief 初始化模型，所有节点处于环境温度
+ */
+void plant_init(plant_t *pl, const plant_params_t *p, uint32_t seed);
+
+/**
+ * @brief 推进仿真
+ *
+ * @param pl 模型
+ * @param duty 加热占空比 (0-1)
+ * @param dt 步长 (s)
+ */
+void plant_step(plant_t *pl, float duty, float dt);
+
+/**
+ * @brief 模拟一次ADC读数 (分压 + 噪声 + 量化 + 过采样 + 中值)
+ *
+ * @return int 分压点电压 (mV, 与无校准时的线性换算一致)
+ */
+int plant_read_mv(plant_t *pl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PLANT_H
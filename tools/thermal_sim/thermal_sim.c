@@ -0,0 +1,744 @@
+/**
+ * @file thermal_sim.c
+ * @brief 温控闭环主机仿真与基准测试
+ *
+ * plant.c 的热模型驱动与固件相同的控制模块 (pid_loop.c、驱动级、NTC查找表
+ * 等)，对目标温度 × PID参数矩阵输出到温、超调、纹波、耗电和故障检测等指标。
+ * 选项见 usage() (--help)
+ *
+ * 构建与运行:
+ *   cmake -S tools/thermal_sim -B build/sim && cmake --build build/sim
+ *   ./build/sim/thermal_sim --gains 2,0.1,0.5 --gains 3,0.05,1 --csv
+ *   ctest --test-dir build/sim   (故障检测回归)
+ */
+
+#include "ambient.h"
+#include "boost.h"
+#include "cascade.h"
+#include "drive.h"
+#include "eco.h"
+#include "fopdt.h"
+#include "ntc.h"
+#include "pid_loop.h"
+#include "plant.h"
+#include "preheat.h"
+#include "runaway.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_DT 0.01f              // 热模型步长 (s)
+#define HEATER_DUTY_MAX 1023      // 与 temp_control.c 一致 (10位)
+#define MAX_GAIN_SETS 16
+#define MAX_TARGETS 16
+#define MODEL_PERIOD_S 5.0f // 与 temp_control.c 一致
+#define READY_BAND 0.5f     // 与 temp_control.c 一致 (°C)
+#define ECO_AMBIENT_DEFAULT 25.0f // 与 temp_control.c 一致 (°C)
+#define DRIVE_FULL (HEATER_DUTY_MAX << DRIVE_FRAC_BITS)
+#define CHIP_SELF_HEAT 6.0f       // 芯片温度高于环境 (°C), 冷启动时标定
+#define LEARN_AMBIENT 25.0f       // 散热系数学习时的室温 (°C)
+#define DRIVE_STEP_S 0.02f        // 与 temp_control.c 一致 (s)
+#define TX_BACKOFF_PCT 30         // 与 Kconfig 默认值一致 (%)
+#define PREHEAT_APPROACH_C 5.0f   // 与 temp_control.c 一致 (°C)
+#define PREHEAT_MAX_GAP_S 5.0f    // 与 temp_control.c 一致 (s)
+
+/**
+ * @brief PID参数 (每控制周期, 与 Kconfig/100 相同单位)
+ */
+typedef struct {
+  float kp;
+  float ki;
+  float kd;
+} gains_t;
+
+/**
+ * @brief 加热驱动级 (对应 temp_control.c 的 drive_apply)
+ */
+typedef struct {
+  drive_t drive;
+  int64_t last_us; // 上次推进时间 (us), <0 无效
+  float duty;      // 当前输出占空比 (0-1), 即固件的 s_heater_duty
+} heater_t;
+
+typedef struct {
+  pid_loop_engine_t engine;
+  float period_s;
+  float d_filter_s;
+  float duration_s;
+  float band;
+  float detach_s; // NTC脱落时间 (s), <0 不脱落
+  bool boost;     // 全功率升温后切换PID
+  float eco_band; // 节能保温带宽度 (°C), <=0 不启用
+  bool dither;    // 低频PWM + sigma-delta抖动
+  float pwm_freq; // PWM频率 (Hz)
+  bool ambient_ff; // 环境温度补偿前馈
+  bool cascade;    // 级联控温 (目标为杯温)
+  float inner_s;   // 级联内环周期 (s)
+  int cap;         // 功率上限 (%)
+  int slew;        // 上升斜率限制 (%/s), 0=不限
+  uint32_t seed;
+  plant_params_t plant;
+} sim_config_t;
+
+/**
+ * @brief 单次闭环运行的结果
+ */
+typedef struct {
+  float rise_s;    // 10% -> 90% 上升时间 (s), <0 未达到
+  float overshoot; // 最高温度超出目标 (°C)
+  float settle_s;  // 最后一次离开 ±band 的时间 (s), <0 未稳定
+  float ripple;    // 最后10分钟峰峰值 (°C)
+  float energy_wh; // 耗电量 (Wh)
+  float cup_final; // 结束时杯温 (°C)
+  int state_flips; // 加热/保温状态切换次数
+  thermal_fault_t fault; // 热失控检测结果
+  float fault_s;         // 检出时间 (s), <0 未检出
+  float ready_s;         // 读数首次到达 目标-READY_BAND 的时间 (s)
+  float eta_err_s;       // 升温过半时预测的到温时间 - ready_s (s)
+  fopdt_params_t model;  // 结束时的辨识结果
+  float boost_s;         // 全功率阶段结束时间 (s), <0 未启用
+  float boost_hold;      // 切换时估算的保温占空比 (%), <0 未知
+  float eco_saved_wh;    // 节能保温估算的节省量 (Wh)
+  float eco_loss;        // 学得的散热系数 (%/K), <=0 未学习
+  float hold_err;        // 最后10分钟 |加热板温度-目标| 的平均值 (°C)
+  float sw_per_s;        // 平均每秒开关沿数 (MOSFET开关损耗正比于此)
+  float ff_pct;          // 结束时的前馈占空比 (%)
+  float int_pct;         // 最后10分钟 PID输出-前馈 的平均值 (%)
+  float cup_ready_s;     // 杯温首次到达 目标-READY_BAND 的时间 (s)
+  float cup_overshoot;   // 杯温最高超出目标 (°C)
+  float cup_err;         // 最后10分钟 |杯温-目标| 的平均值 (°C)
+  float plate_peak;      // 加热板最高温度 (°C)
+  float preheat_err_s;   // 开始时按已学升温曲线预测的到温时间 - ready_s (s)
+} metrics_t;
+
+// ============================================================================
+// 控制器与驱动级
+// ============================================================================
+static void controller_init(pid_loop_t *c, const sim_config_t *cfg,
+                            const gains_t *g) {
+  const pid_loop_config_t loop_cfg = {
+      .engine = cfg->engine,
+      .period_s = cfg->period_s,
+      .step_s = cfg->cascade ? cfg->inner_s : cfg->period_s,
+      .d_filter_s = cfg->d_filter_s,
+      .cap_percent = cfg->cap,
+      .drive_full = DRIVE_FULL,
+  };
+  pid_loop_init(c, &loop_cfg, g->kp, g->ki, g->kd);
+}
+
+/**
+ * @brief 按散热模型设置前馈量 (对应 temp_control.c 的 feedforward_update,
+ *        这里每次都重新计算)
+ */
+static void feedforward_update(pid_loop_t *c, const ambient_t *amb,
+                               int32_t setpoint_centi) {
+  if (amb != NULL) {
+    pid_loop_set_feedforward(
+        c, ambient_ff_duty(amb, (float)setpoint_centi * 0.01f));
+  }
+}
+
+static float duty_percent(uint32_t raw) {
+  return (float)raw * 100.0f / (float)DRIVE_FULL;
+}
+
+/**
+ * @brief 请求经驱动级限幅/限速后写入PWM
+ *
+ * @param plant_duty 输出PWM占空比 (0-1)
+ */
+static void heater_apply(heater_t *h, uint32_t request, int64_t now_us,
+                         bool dither, float *plant_duty) {
+  uint32_t dt_us = h->last_us >= 0 ? (uint32_t)(now_us - h->last_us) : 0;
+  h->last_us = now_us;
+  drive_update(&h->drive, request, false, dt_us);
+  *plant_duty = (float)drive_pwm(&h->drive, dither) /
+                (float)(HEATER_DUTY_MAX + 1); // LEDC: duty / 2^bits
+  h->duty = duty_percent(h->drive.output) / 100.0f;
+}
+
+/**
+ * @param amb 环境温度估计器, NULL 不做环境温度补偿
+ */
+static void run_closed_loop(const sim_config_t *cfg, const gains_t *g,
+                            int target, ambient_t *amb, preheat_curve_t *curve,
+                            metrics_t *m) {
+  plant_t pl;
+  plant_init(&pl, &cfg->plant, cfg->seed);
+  pid_loop_t c;
+  controller_init(&c, cfg, g);
+  runaway_config_t rw_cfg;
+  runaway_default_config(&rw_cfg);
+  runaway_t rw;
+  runaway_init(&rw, &rw_cfg);
+  fopdt_t model;
+  fopdt_init(&model, MODEL_PERIOD_S);
+  boost_config_t boost_cfg;
+  boost_default_config(&boost_cfg);
+  boost_t boost;
+  boost_init(&boost, &boost_cfg);
+  eco_config_t eco_cfg;
+  eco_default_config(&eco_cfg);
+  eco_cfg.band = cfg->eco_band;
+  eco_t eco;
+  eco_init(&eco, &eco_cfg);
+  drive_config_t drive_cfg;
+  drive_config_percent(&drive_cfg, DRIVE_FULL, cfg->cap, cfg->slew,
+                       TX_BACKOFF_PCT);
+  heater_t heater = {.last_us = -1};
+  drive_init(&heater.drive, &drive_cfg);
+  cascade_config_t casc_cfg;
+  cascade_default_config(&casc_cfg);
+  cascade_t casc;
+  cascade_init(&casc, &casc_cfg);
+  preheat_rec_t preheat;
+  float predicted_ready = -1.0f;
+  float preheat_pred = -1.0f;
+  float ambient = ECO_AMBIENT_DEFAULT;
+  const float chip = cfg->plant.ambient + CHIP_SELF_HEAT;
+  float ff = 0.0f;
+
+  const float t0 = pl.plate;
+  const float span = (float)target - t0;
+  const float ripple_from = cfg->duration_s > 1200.0f
+                                ? cfg->duration_s - 600.0f
+                                : cfg->duration_s * 0.75f;
+  const int steps_per_ctrl = (int)lroundf(cfg->period_s / SIM_DT);
+  const int steps_per_inner = (int)lroundf(c.cfg.step_s / SIM_DT);
+  const int total_steps = (int)(cfg->duration_s / SIM_DT);
+  // 抖动时驱动级每个PWM周期推进一次
+  const float drive_step_s = cfg->dither ? 1.0f / cfg->pwm_freq : DRIVE_STEP_S;
+  int steps_per_drive = (int)lroundf(drive_step_s / SIM_DT);
+  if (steps_per_drive < 1) {
+    steps_per_drive = 1;
+  }
+  const float cap = (float)cfg->cap;
+
+  float t10 = -1.0f;
+  float t90 = -1.0f;
+  float peak = t0;
+  float last_out_of_band = 0.0f;
+  float rip_min = 1e9f;
+  float rip_max = -1e9f;
+  bool was_heating = false;
+  float plant_duty = 0.0f; // 当前PWM周期的实际占空比 (0-1)
+  double err_sum = 0.0;
+  double int_sum = 0.0;
+  int err_n = 0;
+  int int_n = 0;
+  double cup_err_sum = 0.0;
+  float cup_peak = pl.cup;
+  int32_t setpoint_centi = target * 100; // PID设定值, 级联时为加热板设定值
+  double edges = 0.0;
+
+  m->state_flips = 0;
+  m->fault = THERMAL_FAULT_NONE;
+  m->fault_s = -1.0f;
+  m->ready_s = -1.0f;
+  m->boost_s = -1.0f;
+  m->boost_hold = -1.0f;
+  m->cup_ready_s = -1.0f;
+  m->plate_peak = pl.plate;
+
+  for (int step = 0; step < total_steps; step++) {
+    float t = (float)step * SIM_DT;
+    int64_t now_us = (int64_t)step * (int64_t)lroundf(SIM_DT * 1e6f);
+
+    if (cfg->detach_s >= 0.0f && t >= cfg->detach_s) {
+      pl.sensor_detached = true;
+    }
+
+    if (cfg->cascade && step % steps_per_ctrl != 0 &&
+        step % steps_per_inner == 0 && m->fault == THERMAL_FAULT_NONE) {
+      // 级联内环 (对应 temp_control.c 的 inner_loop)
+      int32_t centi = ntc_mv_to_centi_celsius(plant_read_mv(&pl));
+      cascade_observe(&casc, (float)centi * 0.01f, heater.duty * 100.0f,
+                      ambient, c.cfg.step_s);
+      bool is_heating;
+      uint32_t raw =
+          pid_loop_run(&c, centi, setpoint_centi, c.cfg.step_s, &is_heating);
+      heater_apply(&heater, raw, now_us, cfg->dither, &plant_duty);
+    }
+
+    if (step % steps_per_ctrl == 0 && m->fault == THERMAL_FAULT_NONE) {
+      int32_t centi = ntc_mv_to_centi_celsius(plant_read_mv(&pl));
+      float reading = (float)centi * 0.01f;
+      const float duty = heater.duty;
+
+      if (amb != NULL) {
+        // 与 temp_control.c 一致: 冷启动时以NTC读数标定芯片温度偏差
+        ambient_update(amb, chip, step > 0 ? cfg->period_s : 0.0f);
+        if (step == 0) {
+          ambient_calibrate(amb, reading);
+        }
+        fopdt_set_ambient(&model, amb->ambient);
+      }
+      // 辨识使用上一周期实际施加的占空比
+      fopdt_update(&model, reading, duty * 100.0f,
+                   step > 0 ? cfg->period_s : 0.0f);
+      if (step == 0) {
+        ambient = reading;
+      }
+      if (amb != NULL) {
+        ambient = amb->ambient;
+      }
+      cascade_observe(&casc, reading, duty * 100.0f, ambient,
+                      step > 0 ? c.cfg.step_s : 0.0f);
+
+      // 级联时到温指杯温 (估计值) 到温
+      float ready_temp = (float)target - READY_BAND;
+      float controlled = cfg->cascade ? casc.cup : reading;
+      if (m->ready_s < 0.0f && controlled >= ready_temp) {
+        m->ready_s = t;
+      }
+      if (step == 0) {
+        preheat_pred = preheat_time(curve, PREHEAT_APPROACH_C, controlled,
+                                    (float)target);
+        preheat_start(&preheat, PREHEAT_APPROACH_C, controlled, (float)target,
+                      t);
+      } else {
+        preheat_update(&preheat, curve, controlled, t, m->ready_s >= 0.0f,
+                       PREHEAT_MAX_GAP_S);
+      }
+      if (predicted_ready < 0.0f && m->ready_s < 0.0f &&
+          controlled >= t0 + 0.5f * span) {
+        float eta =
+            cfg->cascade
+                ? cascade_time_to_target(&casc, ready_temp, ambient, cap)
+                : fopdt_time_to_target(&model, reading, ready_temp, cap);
+        if (eta >= 0.0f) {
+          predicted_ready = t + eta;
+        }
+      }
+
+      if (step == 0 && cfg->boost && !cfg->cascade) {
+        boost_start(&boost, reading, (float)target);
+      }
+      bool is_heating = true;
+      uint32_t raw = DRIVE_FULL;
+      bool boosting = boost.active;
+      if (boosting &&
+          boost_update(&boost, reading, step > 0 ? cfg->period_s : 0.0f)) {
+        m->boost_s = t;
+        m->boost_hold = boost_preload_duty(&boost, cap);
+        if (m->boost_hold >= 0.0f) {
+          feedforward_update(&c, amb, target * 100);
+          pid_loop_preload(&c, centi, target * 100, m->boost_hold);
+        }
+        boosting = false;
+      }
+      setpoint_centi = target * 100;
+      if (cfg->cascade) {
+        float sp = cascade_update(&casc, (float)target, ambient,
+                                  step > 0 ? cfg->period_s : 0.0f);
+        setpoint_centi = (int32_t)lroundf(sp * 100.0f);
+      } else if (cfg->eco_band > 0.0f && !boosting) {
+        // 与 temp_control.c 一致: 冷启动时的读数作为环境温度
+        float sp = eco_update(&eco, reading, (float)target, duty * 100.0f,
+                              ambient, step > 0 ? cfg->period_s : 0.0f);
+        setpoint_centi = (int32_t)lroundf(sp * 100.0f);
+      }
+      if (amb != NULL) {
+        // 散热系数更新后预置积分保持当前输出
+        int learned = amb->loss_count;
+        ambient_learn(amb, reading, duty * 100.0f,
+                      step > 0 ? cfg->period_s : 0.0f);
+        if (amb->loss_count != learned && !boosting) {
+          feedforward_update(&c, amb, setpoint_centi);
+          pid_loop_preload(&c, centi, setpoint_centi, duty * 100.0f);
+        }
+      }
+      feedforward_update(&c, amb, setpoint_centi);
+      ff = c.ff;
+      if (!boosting) {
+        raw = pid_loop_run(&c, centi, setpoint_centi, c.cfg.step_s,
+                           &is_heating);
+        if (t >= ripple_from) {
+          int_sum += duty_percent(raw) - ff;
+          int_n++;
+        }
+      }
+      heater_apply(&heater, raw, now_us, cfg->dither, &plant_duty);
+      if (step > 0 && is_heating != was_heating) {
+        m->state_flips++;
+      }
+      was_heating = is_heating;
+
+      // 与 temp_control.c 相同: 检出故障后锁定并关闭加热
+      thermal_fault_t fault =
+          runaway_update(&rw, (float)centi * 0.01f,
+                         (float)setpoint_centi * 0.01f, heater.duty * 100.0f,
+                         ambient,
+                         step > 0 ? cfg->period_s : 0.0f);
+      if (fault != THERMAL_FAULT_NONE) {
+        m->fault = fault;
+        m->fault_s = t;
+        heater_apply(&heater, 0, now_us, cfg->dither, &plant_duty);
+        plant_duty = 0.0f;
+      }
+    }
+
+    // 爬升中或抖动含小数时由定时器继续推进 (对应 temp_control.c 的
+    // drive_timer_cb)
+    if (step % steps_per_drive == 0 && m->fault == THERMAL_FAULT_NONE &&
+        (!drive_settled(&heater.drive) ||
+         (cfg->dither && drive_fractional(&heater.drive)))) {
+      heater_apply(&heater, heater.drive.request, now_us, cfg->dither,
+                   &plant_duty);
+    }
+    if (plant_duty > 0.0f && plant_duty < 1.0f) {
+      edges += 2.0 * cfg->pwm_freq * SIM_DT;
+    }
+    plant_step(&pl, plant_duty, SIM_DT);
+
+    if (pl.plate > m->plate_peak) {
+      m->plate_peak = pl.plate;
+    }
+    if (pl.cup > cup_peak) {
+      cup_peak = pl.cup;
+    }
+    if (m->cup_ready_s < 0.0f && pl.cup >= (float)target - READY_BAND) {
+      m->cup_ready_s = t;
+    }
+
+    float temp = pl.plate;
+    if (t10 < 0.0f && temp >= t0 + 0.1f * span) {
+      t10 = t;
+    }
+    if (t90 < 0.0f && temp >= t0 + 0.9f * span) {
+      t90 = t;
+    }
+    if (temp > peak) {
+      peak = temp;
+    }
+    if (fabsf(temp - (float)target) > cfg->band) {
+      last_out_of_band = t;
+    }
+    if (t >= ripple_from) {
+      if (temp < rip_min) {
+        rip_min = temp;
+      }
+      if (temp > rip_max) {
+        rip_max = temp;
+      }
+      err_sum += fabsf(temp - (float)target);
+      cup_err_sum += fabsf(pl.cup - (float)target);
+      err_n++;
+    }
+  }
+
+  m->rise_s = (t10 >= 0.0f && t90 >= 0.0f) ? t90 - t10 : -1.0f;
+  m->overshoot = peak > (float)target ? peak - (float)target : 0.0f;
+  m->settle_s = last_out_of_band < cfg->duration_s - cfg->period_s
+                    ? last_out_of_band
+                    : -1.0f;
+  m->ripple = rip_max - rip_min;
+  m->energy_wh = (float)(pl.energy_j / 3600.0);
+  m->cup_final = pl.cup;
+  m->eta_err_s = (predicted_ready >= 0.0f && m->ready_s >= 0.0f)
+                     ? predicted_ready - m->ready_s
+                     : 0.0f;
+  fopdt_get_params(&model, &m->model);
+  m->eco_saved_wh =
+      eco_saved_duty_s(&eco) / 100.0f * cfg->plant.heater_power_w / 3600.0f;
+  m->eco_loss = eco.loss;
+  m->hold_err = err_n > 0 ? (float)(err_sum / err_n) : 0.0f;
+  m->sw_per_s = (float)(edges / cfg->duration_s);
+  m->ff_pct = ff;
+  m->int_pct = int_n > 0 ? (float)(int_sum / int_n) : 0.0f;
+  m->cup_overshoot = cup_peak > (float)target ? cup_peak - (float)target : 0.0f;
+  m->cup_err = err_n > 0 ? (float)(cup_err_sum / err_n) : 0.0f;
+  m->preheat_err_s = (preheat_pred >= 0.0f && m->ready_s >= 0.0f)
+                         ? preheat_pred - m->ready_s
+                         : 0.0f;
+}
+
+// ============================================================================
+// 命令行
+// ============================================================================
+static const char *engine_name(pid_loop_engine_t e) {
+  switch (e) {
+  case PID_LOOP_TIME_AWARE:
+    return "dt";
+  case PID_LOOP_FIXED:
+    return "fixed";
+  default:
+    return "float";
+  }
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --engine float|dt|fixed  PID engine (default float)\n"
+          "  --period MS              control period (default 500)\n"
+          "  --d-filter MS            derivative filter, dt engine (2000)\n"
+          "  --gains KP,KI,KD         per-step gains, repeatable "
+          "(default 2,0.1,0.5)\n"
+          "  --targets T1,T2,...      targets in C (default 30..90 step 10)\n"
+          "  --duration MIN           simulated time per run (default 60)\n"
+          "  --band C                 settling band (default 0.5)\n"
+          "  --ambient C              ambient temperature (default 25)\n"
+          "  --power W                heater power (default 15)\n"
+          "  --cap PCT                power cap, percent of full duty (100)\n"
+          "  --slew PCT_S             duty rise limit, 0 = none (default 50)\n"
+          "  --no-cup                 empty pad\n"
+          "  --noise LSB              ADC noise per sample (default 3)\n"
+          "  --seed N                 noise seed (default 1)\n"
+          "  --detach-at MIN          NTC falls off the plate at MIN\n"
+          "  --boost                  full duty, then PID (boost mode)\n"
+          "  --eco BAND               eco keep-warm, band in C below target\n"
+          "  --drive pwm|dither       1 kHz rounded PWM, or low-frequency\n"
+          "                           PWM with sigma-delta dithering\n"
+          "  --pwm-freq HZ            PWM frequency (default 1000, dither 50)\n"
+          "  --cascade                cascade: cup observer sets the plate\n"
+          "                           setpoint, target is the cup\n"
+          "  --inner MS               cascade inner loop period (default 100)\n"
+          "  --cup-c J_K              cup heat capacity (default 1200)\n"
+          "  --ambient-ff             ambient feedforward, heat loss learned\n"
+          "                           at 25 C first\n"
+          "  --csv                    CSV output\n",
+          prog);
+}
+
+static int parse_floats(const char *s, float *out, int max) {
+  int n = 0;
+  while (*s && n < max) {
+    char *end;
+    out[n++] = strtof(s, &end);
+    if (end == s) {
+      return -1;
+    }
+    s = (*end == ',') ? end + 1 : end;
+  }
+  return n;
+}
+
+int main(int argc, char **argv) {
+  sim_config_t cfg = {
+      .engine = PID_LOOP_FLOAT,
+      .period_s = 0.5f,
+      .d_filter_s = 2.0f,
+      .duration_s = 3600.0f,
+      .band = 0.5f,
+      .detach_s = -1.0f,
+      .inner_s = 0.1f,
+      .cap = 100,
+      .slew = 50,
+      .seed = 1,
+  };
+  plant_default_params(&cfg.plant);
+  float pwm_freq = 0.0f;
+
+  gains_t gains[MAX_GAIN_SETS];
+  int n_gains = 0;
+  int targets[MAX_TARGETS];
+  int n_targets = 0;
+  bool csv = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+    float f[MAX_TARGETS];
+
+    if (strcmp(arg, "--csv") == 0) {
+      csv = true;
+      continue;
+    }
+    if (strcmp(arg, "--boost") == 0) {
+      cfg.boost = true;
+      continue;
+    }
+    if (strcmp(arg, "--cascade") == 0) {
+      cfg.cascade = true;
+      continue;
+    }
+    if (strcmp(arg, "--ambient-ff") == 0) {
+      cfg.ambient_ff = true;
+      continue;
+    }
+    if (strcmp(arg, "--no-cup") == 0) {
+      cfg.plant.cup_c = 0.0f;
+      continue;
+    }
+    if (val == NULL) {
+      usage(argv[0]);
+      return 1;
+    }
+    i++;
+
+    if (strcmp(arg, "--engine") == 0) {
+      if (strcmp(val, "float") == 0) {
+        cfg.engine = PID_LOOP_FLOAT;
+      } else if (strcmp(val, "dt") == 0) {
+        cfg.engine = PID_LOOP_TIME_AWARE;
+      } else if (strcmp(val, "fixed") == 0) {
+        cfg.engine = PID_LOOP_FIXED;
+      } else {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if (strcmp(arg, "--period") == 0) {
+      cfg.period_s = strtof(val, NULL) / 1000.0f;
+    } else if (strcmp(arg, "--d-filter") == 0) {
+      cfg.d_filter_s = strtof(val, NULL) / 1000.0f;
+    } else if (strcmp(arg, "--gains") == 0) {
+      if (n_gains >= MAX_GAIN_SETS || parse_floats(val, f, 3) != 3) {
+        usage(argv[0]);
+        return 1;
+      }
+      gains[n_gains++] = (gains_t){f[0], f[1], f[2]};
+    } else if (strcmp(arg, "--targets") == 0) {
+      n_targets = parse_floats(val, f, MAX_TARGETS);
+      if (n_targets <= 0) {
+        usage(argv[0]);
+        return 1;
+      }
+      for (int k = 0; k < n_targets; k++) {
+        targets[k] = (int)f[k];
+      }
+    } else if (strcmp(arg, "--duration") == 0) {
+      cfg.duration_s = strtof(val, NULL) * 60.0f;
+    } else if (strcmp(arg, "--band") == 0) {
+      cfg.band = strtof(val, NULL);
+    } else if (strcmp(arg, "--ambient") == 0) {
+      cfg.plant.ambient = strtof(val, NULL);
+    } else if (strcmp(arg, "--inner") == 0) {
+      cfg.inner_s = strtof(val, NULL) / 1000.0f;
+    } else if (strcmp(arg, "--cup-c") == 0) {
+      cfg.plant.cup_c = strtof(val, NULL);
+    } else if (strcmp(arg, "--cap") == 0) {
+      cfg.cap = atoi(val);
+    } else if (strcmp(arg, "--slew") == 0) {
+      cfg.slew = atoi(val);
+    } else if (strcmp(arg, "--power") == 0) {
+      cfg.plant.heater_power_w = strtof(val, NULL);
+    } else if (strcmp(arg, "--noise") == 0) {
+      cfg.plant.adc_noise_lsb = strtof(val, NULL);
+    } else if (strcmp(arg, "--detach-at") == 0) {
+      cfg.detach_s = strtof(val, NULL) * 60.0f;
+    } else if (strcmp(arg, "--eco") == 0) {
+      cfg.eco_band = strtof(val, NULL);
+    } else if (strcmp(arg, "--drive") == 0) {
+      if (strcmp(val, "pwm") == 0) {
+        cfg.dither = false;
+      } else if (strcmp(val, "dither") == 0) {
+        cfg.dither = true;
+      } else {
+        usage(argv[0]);
+        return 1;
+      }
+    } else if (strcmp(arg, "--pwm-freq") == 0) {
+      pwm_freq = strtof(val, NULL);
+    } else if (strcmp(arg, "--seed") == 0) {
+      cfg.seed = (uint32_t)strtoul(val, NULL, 10);
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (cfg.period_s < SIM_DT) {
+    cfg.period_s = SIM_DT;
+  }
+  if (cfg.cap < 1 || cfg.cap > 100) {
+    cfg.cap = 100;
+  }
+  if (cfg.inner_s < SIM_DT || cfg.inner_s > cfg.period_s) {
+    cfg.inner_s = cfg.period_s;
+  }
+  // 与 Kconfig 默认值一致
+  cfg.pwm_freq = pwm_freq > 0.0f ? pwm_freq : (cfg.dither ? 50.0f : 1000.0f);
+  if (n_gains == 0) {
+    // Kconfig 默认值 (PID_KP/KI/KD / 100)
+    gains[n_gains++] = (gains_t){2.0f, 0.1f, 0.5f};
+  }
+  if (n_targets == 0) {
+    for (int t = 30; t <= 90; t += 10) {
+      targets[n_targets++] = t;
+    }
+  }
+
+  if (csv) {
+    printf("engine,period_ms,kp,ki,kd,target,rise_s,overshoot_c,settle_s,"
+           "ripple_c,energy_wh,cup_c,state_flips,fault,fault_s,ready_s,eta_err_s,"
+           "model_k,model_tau_s,model_dead_s,boost_s,boost_hold,eco_loss,"
+           "eco_saved_wh,hold_err_c,sw_per_s,ff_pct,int_pct,cup_ready_s,"
+           "cup_overshoot_c,cup_err_c,plate_peak_c,preheat_err_s\n");
+  } else {
+    printf("%-6s %6s %6s %7s %6s | %3s %8s %7s %8s %7s %7s %6s %5s | %7s "
+           "%7s %5s %6s %5s | %7s %4s | %5s %6s | %6s %6s | %5s %5s | %7s "
+           "%5s %5s %5s | %7s | %s\n",
+           "engine", "period", "kp", "ki", "kd", "T", "rise_s", "ovs_C",
+           "settle_s", "rip_C", "Wh", "cup_C", "flips", "ready_s", "eta_err",
+           "K", "tau", "dead", "boost_s", "hold", "loss", "saved", "err_C",
+           "sw/s", "ff", "int", "cup_rdy", "c_ovs", "c_err", "pl_pk",
+           "pre_err", "fault");
+  }
+
+  ambient_config_t amb_cfg;
+  ambient_default_config(&amb_cfg);
+  for (int gi = 0; gi < n_gains; gi++) {
+    // 散热系数与环境温度无关: 先在标准室温下学习，相当于NVS中保存的值
+    ambient_t learned;
+    ambient_init(&learned, &amb_cfg);
+    preheat_curve_t curve;
+    preheat_curve_init(&curve);
+    if (cfg.ambient_ff) {
+      sim_config_t learn_cfg = cfg;
+      learn_cfg.plant.ambient = LEARN_AMBIENT;
+      metrics_t m;
+      preheat_curve_t learn_curve;
+      preheat_curve_init(&learn_curve);
+      run_closed_loop(&learn_cfg, &gains[gi], targets[0], &learned,
+                      &learn_curve, &m);
+    }
+    for (int ti = 0; ti < n_targets; ti++) {
+      // 每次运行相当于重新上电: 从NVS恢复后冷启动标定
+      ambient_t amb;
+      ambient_init(&amb, &amb_cfg);
+      ambient_restore(&amb, learned.calibrated, learned.offset, learned.loss);
+      metrics_t m;
+      run_closed_loop(&cfg, &gains[gi], targets[ti],
+                      cfg.ambient_ff ? &amb : NULL, &curve, &m);
+      if (csv) {
+        printf("%s,%d,%.4g,%.4g,%.4g,%d,%.1f,%.2f,%.1f,%.3f,%.3f,%.1f,%d,%s,"
+               "%.1f,%.1f,%.1f,%.2f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.4f,"
+               "%.0f,%.1f,%.1f,%.1f,%.2f,%.3f,%.1f,%.1f\n",
+               engine_name(cfg.engine), (int)lroundf(cfg.period_s * 1000.0f),
+               gains[gi].kp, gains[gi].ki, gains[gi].kd, targets[ti],
+               m.rise_s, m.overshoot, m.settle_s, m.ripple, m.energy_wh,
+               m.cup_final, m.state_flips, thermal_fault_to_string(m.fault),
+               m.fault_s, m.ready_s, m.eta_err_s, m.model.gain, m.model.tau,
+               m.model.dead_time, m.boost_s, m.boost_hold, m.eco_loss,
+               m.eco_saved_wh, m.hold_err, m.sw_per_s, m.ff_pct, m.int_pct,
+               m.cup_ready_s, m.cup_overshoot, m.cup_err, m.plate_peak,
+               m.preheat_err_s);
+      } else {
+        printf("%-6s %6d %6.3g %7.4g %6.3g | %3d %8.1f %7.2f %8.1f %7.3f "
+               "%7.3f %6.1f %5d | %7.0f %7.0f %5.1f %6.0f %5.0f | %7.0f %4.0f "
+               "| %5.3f %6.3f | %6.4f %6.0f | %5.1f %5.1f | %7.0f %5.2f "
+               "%5.2f %5.1f | %7.0f | %s",
+               engine_name(cfg.engine), (int)lroundf(cfg.period_s * 1000.0f),
+               gains[gi].kp, gains[gi].ki, gains[gi].kd, targets[ti],
+               m.rise_s, m.overshoot, m.settle_s, m.ripple, m.energy_wh,
+               m.cup_final, m.state_flips, m.ready_s, m.eta_err_s,
+               m.model.gain, m.model.tau, m.model.dead_time, m.boost_s,
+               m.boost_hold, m.eco_loss, m.eco_saved_wh, m.hold_err,
+               m.sw_per_s, m.ff_pct, m.int_pct, m.cup_ready_s,
+               m.cup_overshoot, m.cup_err, m.plate_peak, m.preheat_err_s,
+               thermal_fault_to_string(m.fault));
+        if (m.fault_s >= 0.0f) {
+          printf(" @%.0fs", m.fault_s);
+        }
+        printf("\n");
+      }
+    }
+  }
+
+  return 0;
+}